@@ -43,6 +43,7 @@ public:
     auto asVector() const -> std::vector<uint8_t>;
 
     void clear();
+    void resize(size_t size);
     void append(uint8_t value);
     void append(char value);
 
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <kaizo/binary/Binary.h>
+#include <kaizo/binary/BinaryView.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace kaizo {
+
+enum class CompressionLevel
+{
+    /// Greedy parsing with one step of lookahead.
+    Fast,
+    /// The parse with the smallest output for the codec's token sizes.
+    Optimal,
+};
+
+class Codec
+{
+public:
+    virtual ~Codec() = default;
+
+    /// Decompresses the stream at the beginning of the input; returns the decompressed data and
+    /// the number of input bytes the stream occupies.
+    virtual auto decompress(const BinaryView& input) const -> std::pair<Binary, size_t> = 0;
+    virtual auto compress(const BinaryView& input) const -> Binary = 0;
+    /// Compresses every input on its own, distributing the inputs over the given number of threads
+    /// (0: one per core).
+    auto compressAll(const std::vector<BinaryView>& inputs, size_t threadCount = 0) const
+        -> std::vector<Binary>;
+
+    void setLevel(CompressionLevel level);
+    auto level() const -> CompressionLevel;
+    /// Compresses a single input in independent blocks on the given number of threads (0: one per
+    /// core); the default of 1 compresses serially.
+    void setThreadCount(size_t threads);
+    auto threadCount() const -> size_t;
+
+    virtual auto copy() const -> std::unique_ptr<Codec> = 0;
+
+protected:
+    Codec() = default;
+    Codec(const Codec& other) = default;
+
+private:
+    CompressionLevel m_level{CompressionLevel::Optimal};
+    size_t m_threadCount{1};
+};
+
+/// Creates the codec with the given name ("lz10", "lzss" or "yaz0").
+auto makeCodec(const std::string& name) -> std::unique_ptr<Codec>;
+
+} // namespace kaizo
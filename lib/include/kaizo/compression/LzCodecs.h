@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Codec.h"
+#include <cstdint>
+
+namespace kaizo {
+
+/// A literal (length 0) or a copy of length bytes starting distance bytes back.
+struct LzToken
+{
+    uint16_t length{0};
+    uint16_t distance{0};
+};
+
+struct LzParameters
+{
+    size_t window{0};
+    size_t minLength{3};
+    size_t maxLength{0};
+    /// Sizes of the encoded tokens in bits, including their flag bit; matches of at least
+    /// longMatchLength bytes take longMatchCost bits.
+    size_t literalCost{9};
+    size_t matchCost{17};
+    size_t longMatchLength{SIZE_MAX};
+    size_t longMatchCost{0};
+};
+
+/// A codec for the flag-byte LZ77 variants, which only differ in their parameters and in how
+/// they write the parsed tokens.
+class LzCodec : public Codec
+{
+public:
+    auto compress(const BinaryView& input) const -> Binary override;
+
+    /// Splits the input into tokens; matches may reference any earlier byte within the window.
+    auto parse(const BinaryView& input) const -> std::vector<LzToken>;
+
+protected:
+    LzCodec() = default;
+    LzCodec(const LzCodec& other) = default;
+
+    virtual auto parameters() const -> const LzParameters& = 0;
+    virtual auto write(const BinaryView& input, const std::vector<LzToken>& tokens) const
+        -> Binary = 0;
+};
+
+/// The LZ77 variant of the GBA/NDS BIOS: type byte 0x10, 24-bit decompressed size, flag bits set
+/// for matches of 3 to 18 bytes within 4 KiB.
+class Lz10Codec final : public LzCodec
+{
+public:
+    auto decompress(const BinaryView& input) const -> std::pair<Binary, size_t> override;
+    auto copy() const -> std::unique_ptr<Codec> override;
+
+protected:
+    auto parameters() const -> const LzParameters& override;
+    auto write(const BinaryView& input, const std::vector<LzToken>& tokens) const
+        -> Binary override;
+};
+
+/// Okumura's LZSS: no header, flag bits set for literals, matches of 3 to 18 bytes addressed by
+/// their position in a 4 KiB ring buffer filled with fillByte. Decompression consumes the whole
+/// input.
+class LzssCodec final : public LzCodec
+{
+public:
+    explicit LzssCodec(uint8_t fillByte = 0x20);
+
+    auto decompress(const BinaryView& input) const -> std::pair<Binary, size_t> override;
+    auto copy() const -> std::unique_ptr<Codec> override;
+
+protected:
+    auto parameters() const -> const LzParameters& override;
+    auto write(const BinaryView& input, const std::vector<LzToken>& tokens) const
+        -> Binary override;
+
+private:
+    uint8_t m_fillByte;
+};
+
+/// Nintendo's Yaz0: 16-byte header with a big-endian decompressed size, flag bits set for
+/// literals, matches of 3 to 273 bytes within 4 KiB.
+class Yaz0Codec final : public LzCodec
+{
+public:
+    auto decompress(const BinaryView& input) const -> std::pair<Binary, size_t> override;
+    auto copy() const -> std::unique_ptr<Codec> override;
+
+protected:
+    auto parameters() const -> const LzParameters& override;
+    auto write(const BinaryView& input, const std::vector<LzToken>& tokens) const
+        -> Binary override;
+};
+
+} // namespace kaizo
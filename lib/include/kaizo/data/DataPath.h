@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -24,6 +27,9 @@ public:
     static auto makeName(const std::string& name) -> DataPathElement;
     static auto makeIndex(size_t index) -> DataPathElement;
     static auto makeIndexWildcard() -> DataPathElement;
+    static auto makeNameWildcard() -> DataPathElement;
+    /// Matches any number of levels, including none.
+    static auto makeDoubleWildcard() -> DataPathElement;
     static auto makePointer() -> DataPathElement;
 
     auto kind() const -> Kind;
@@ -37,20 +43,34 @@ public:
     auto name() const -> const std::string&;
     auto index() const -> size_t;
     auto toString() const -> std::string;
+    auto hash() const -> size_t;
 
     bool matches(const DataPathElement& element) const;
     bool operator<(const DataPathElement& element) const;
     bool operator==(const DataPathElement& element) const;
 
 private:
-    Kind m_kind;
+    Kind m_kind{Kind::Name};
     std::variant<std::string, size_t> m_value;
 };
 
+/// Paths are interned: every distinct path is stored once in a process-wide table and a DataPath
+/// is only an id into it, so copying, hashing and comparing paths for equality is O(1). Table
+/// entries are reference counted and reused once no path refers to them any more.
 class DataPath
 {
 public:
+    DataPath() = default;
+    DataPath(const DataPath& other);
+    DataPath(DataPath&& other) noexcept;
+    ~DataPath();
+    auto operator=(const DataPath& other) -> DataPath&;
+    auto operator=(DataPath&& other) noexcept -> DataPath&;
+
     static auto fromString(const std::string) -> std::optional<DataPath>;
+    /// Parses a path without interning it, e.g. to process many distinct paths only once.
+    static auto elementsFromString(std::string_view string)
+        -> std::optional<std::vector<DataPathElement>>;
 
     void goUp();
     auto parent() const -> DataPath;
@@ -61,12 +81,23 @@ public:
     bool isEmpty() const;
 
     auto toString() const -> std::string;
+    auto hash() const -> size_t;
 
     bool operator<(const DataPath& rhs) const;
     bool operator==(const DataPath& rhs) const;
 
 private:
-    std::vector<DataPathElement> m_elements;
+    auto elements() const -> std::vector<const DataPathElement*>;
+
+    uint32_t m_id{0};
 };
 
-} // namespace kaizo::data
\ No newline at end of file
+} // namespace kaizo::data
+
+template <> struct std::hash<kaizo::data::DataPath>
+{
+    auto operator()(const kaizo::data::DataPath& path) const -> size_t
+    {
+        return path.hash();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "DataPath.h"
+#include <vector>
+
+namespace kaizo::data {
+
+class Data;
+
+/// Evaluates any number of DataPath patterns, which may contain wildcards ([*], * and **), against
+/// a Data tree in a single traversal.
+class DataQuery
+{
+public:
+    struct Match
+    {
+        DataPath path;
+        const Data* data;
+    };
+
+    /// Adds a pattern and returns its index into the results of run().
+    auto add(const DataPath& pattern) -> size_t;
+    auto queryCount() const -> size_t;
+
+    /// Returns the matches of each pattern in traversal order (records by element name, arrays by
+    /// index); the matched Data is owned by the root.
+    auto run(const Data& root) const -> std::vector<std::vector<Match>>;
+
+private:
+    struct State
+    {
+        size_t query;
+        size_t position;
+
+        auto operator<=>(const State&) const = default;
+    };
+
+    void close(std::vector<State>& states) const;
+    void visit(const Data& data, std::vector<State>& states, std::vector<DataPathElement>& path,
+               std::vector<std::vector<Match>>& results) const;
+    void advance(const std::vector<State>& states, const DataPathElement& child,
+                 std::vector<State>& next) const;
+
+    std::vector<std::vector<DataPathElement>> m_patterns;
+};
+
+} // namespace kaizo::data
@@ -3,11 +3,14 @@
 #include "DataAnnotation.h"
 #include "DataRangeTracker.h"
 #include <cstddef>
+#include <deque>
+#include <functional>
 #include <kaizo/addresses/AddressMap.h>
 #include <kaizo/binary/Binary.h>
 #include <kaizo/binary/BinaryView.h>
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace kaizo::data {
 
@@ -17,6 +20,7 @@ class DataReader
 {
 public:
     DataReader(const BinaryView& binary);
+    explicit DataReader(Binary&& binary);
     DataReader(const std::filesystem::path& filename);
     ~DataReader();
 
@@ -28,25 +32,42 @@ public:
     void setAddressMap(std::unique_ptr<AddressMap>&& addressMap);
     auto addressMap() const -> const AddressMap&;
 
+    /// Creates a reader over the same binary and address map with its own offset and data
+    /// structure, e.g. for decoding on another thread. Forks do not track ranges.
+    auto fork() const -> std::unique_ptr<DataReader>;
+    /// Moves the data structure a fork has decoded below the current node.
+    void join(DataReader& fork);
+    /// Visits the decoded nodes depth first with their path, parents before their children.
+    void visitStructure(const std::function<void(const DataPath&, const Data*)>& visitor) const;
+
     void enter(const DataPathElement& element);
     void setTracker(DataRangeTracker* tracker);
+    bool isTracking() const;
     void trackRange(const std::string& tag, size_t offset, size_t size);
     void leave(const Data* data);
 
 private:
+    DataReader(const std::shared_ptr<const Binary>& source,
+               const std::shared_ptr<const AddressMap>& addressMap);
+
     size_t m_offset{0};
-    std::unique_ptr<AddressMap> m_addressMap;
-    Binary m_source;
-    DataPath m_path;
+    std::shared_ptr<const AddressMap> m_addressMap;
+    std::shared_ptr<const Binary> m_source;
 
     struct DataStructure
     {
         DataPathElement pathElement;
         const Data* data;
         DataStructure* parent;
-        std::vector<std::unique_ptr<DataStructure>> children;
+        std::vector<DataStructure*> children;
     };
 
+    // nodes are only freed together with the reader, so they are allocated in bulk
+    std::deque<DataStructure> m_structure;
+    // owned through pointers, since a reallocating vector would copy the deques instead
+    std::vector<std::unique_ptr<std::deque<DataStructure>>> m_joinedStructures;
+    auto currentPath() const -> DataPath;
+
     DataStructure m_root;
     DataStructure* m_currentNode{&m_root};
     DataRangeTracker* m_dataRangeConsumer{nullptr};
@@ -30,6 +30,7 @@ public:
     auto entered() const -> DataPathElement;
     void enterLevel();
     void skip(size_t size);
+    void align(size_t alignment);
     void leaveLevel();
     void leave();
 
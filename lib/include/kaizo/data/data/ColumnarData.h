@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Data.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace kaizo::data {
+
+class RecordData;
+class ArrayData;
+
+/// An array of records with identical scalar fields stored as one contiguous column per field.
+class ColumnarData final : public Data
+{
+public:
+    enum class ColumnType
+    {
+        Int32,
+        UInt32,
+        Int64,
+        UInt64,
+        String,
+    };
+
+    class Column
+    {
+    public:
+        Column(const std::string& name, ColumnType type);
+
+        auto name() const -> const std::string&;
+        auto type() const -> ColumnType;
+        bool isString() const;
+        bool isSigned() const;
+        auto size() const -> size_t;
+        void reserve(size_t size);
+
+        void appendSigned(int64_t value);
+        void appendUnsigned(uint64_t value);
+        void appendString(std::string_view value);
+        /// Appends the value of an IntegerData or StringData, depending on the column's type.
+        void append(const Data& data);
+
+        auto signedValue(size_t row) const -> int64_t;
+        auto unsignedValue(size_t row) const -> uint64_t;
+        auto string(size_t row) const -> std::string_view;
+        auto element(size_t row) const -> std::unique_ptr<Data>;
+
+        /// The contiguous values of an integer column; the string offsets of a string column.
+        auto data() const -> const void*;
+        /// The size of one value returned by data().
+        auto elementSize() const -> size_t;
+        /// The characters of all strings of a string column; row i spans offsets [i, i+1).
+        auto arena() const -> const std::string&;
+
+        bool operator==(const Column& rhs) const = default;
+
+    private:
+        using Values = std::variant<std::vector<int32_t>, std::vector<uint32_t>,
+                                    std::vector<int64_t>, std::vector<uint64_t>>;
+
+        std::string m_name;
+        ColumnType m_type;
+        Values m_values;
+        std::vector<uint32_t> m_offsets{0};
+        std::string m_arena;
+    };
+
+    ColumnarData();
+
+    auto addColumn(const std::string& name, ColumnType type) -> Column&;
+    auto columnCount() const -> size_t;
+    bool hasColumn(const std::string& name) const;
+    auto column(size_t index) const -> const Column&;
+    auto column(size_t index) -> Column&;
+    auto column(const std::string& name) const -> const Column&;
+    auto rowCount() const -> size_t;
+    void reserve(size_t rows);
+
+    /// Appends a RecordData that has an element for every column.
+    void appendRow(const Data& record);
+    auto row(size_t index) const -> std::unique_ptr<RecordData>;
+    auto toArray() const -> std::unique_ptr<ArrayData>;
+
+    bool isEqual(const Data& rhs) const override;
+    auto copy() const -> std::unique_ptr<Data> override;
+
+private:
+    ColumnarData(const ColumnarData& other) = default;
+
+    std::vector<Column> m_columns;
+};
+
+} // namespace kaizo::data
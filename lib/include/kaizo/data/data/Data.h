@@ -16,6 +16,7 @@ enum class DataType
     Binary,
     Reference,
     Image,
+    Columnar,
     Custom
 };
 
@@ -28,6 +29,10 @@ public:
     virtual ~Data() = default;
     auto type() const -> DataType;
 
+    /// Data is allocated from the thread's active DataArena, if any.
+    static auto operator new(size_t size) -> void*;
+    static void operator delete(void* pointer);
+
     template <class T> auto copyAs() const -> std::unique_ptr<T>;
 
     virtual bool isEqual(const Data& rhs) const = 0;
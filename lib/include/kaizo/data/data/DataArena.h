@@ -0,0 +1,47 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+namespace kaizo::data {
+
+class Data;
+
+/// Monotonic memory for the Data objects created on one thread while a Scope is active, e.g.
+/// during a decode. The memory is released in bulk once the scope has ended and every object
+/// allocated from it has been destroyed. Objects created outside of a scope use the heap.
+///
+/// A single surviving object therefore keeps the memory of its whole decode alive. Objects that
+/// are kept while the rest is dropped should be detached.
+class DataArena
+{
+public:
+    /// Activates an arena on the current thread unless one is already active.
+    class Scope
+    {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope&) = delete;
+        auto operator=(const Scope&) -> Scope& = delete;
+
+    private:
+        DataArena* m_arena{nullptr};
+    };
+
+    static auto allocate(size_t size) -> void*;
+    static void deallocate(void* pointer);
+    /// Copies data to the heap, so that it does not keep the arena it was allocated from alive.
+    static auto detach(const Data& data) -> std::unique_ptr<Data>;
+
+private:
+    DataArena() = default;
+    void release();
+
+    std::pmr::monotonic_buffer_resource m_resource{1024};
+    std::atomic<size_t> m_references{1};
+};
+
+} // namespace kaizo::data
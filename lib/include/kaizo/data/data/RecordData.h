@@ -18,6 +18,8 @@ public:
     bool has(const std::string& name) const;
     auto element(const std::string& name) const -> const Data&;
     auto element(const std::string& name) -> Data&;
+    /// Returns nullptr if there is no element of the given name.
+    auto find(const std::string& name) const -> const Data*;
     auto elementNames() const -> std::vector<std::string>;
 
     bool isEqual(const Data& rhs) const override;
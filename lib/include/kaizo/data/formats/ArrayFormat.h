@@ -1,6 +1,8 @@
 #pragma once
 
+#include "CompiledFormat.h"
 #include "DataFormat.h"
+#include "LazyArray.h"
 #include <memory>
 
 namespace kaizo::data {
@@ -10,6 +12,10 @@ class ArraySizeProvider
 public:
     virtual ~ArraySizeProvider() = default;
     virtual auto provideSize(const DataReader& reader) const -> size_t = 0;
+    virtual auto fixedSize() const -> std::optional<size_t>
+    {
+        return {};
+    }
     virtual auto copy() const -> std::unique_ptr<ArraySizeProvider> = 0;
 };
 
@@ -26,6 +32,11 @@ public:
         return m_fixedSize;
     }
 
+    auto fixedSize() const -> std::optional<size_t> override
+    {
+        return m_fixedSize;
+    }
+
     auto copy() const -> std::unique_ptr<ArraySizeProvider>
     {
         return std::make_unique<FixedSizeProvider>(m_fixedSize);
@@ -42,6 +53,15 @@ public:
 
     void setSizeProvider(std::unique_ptr<ArraySizeProvider>&& sizeProvider);
     void setElementFormat(std::unique_ptr<DataFormat>&& format);
+    /// Decodes the pointees of an array of pointers on the given number of threads (0: one per
+    /// core); the default of 1 decodes serially. Arrays are decoded serially while tracking.
+    void setThreadCount(size_t threads);
+    /// Decodes an array of records into one column per record element; returns nullptr if the
+    /// elements are not records of scalars.
+    auto decodeColumnar(DataReader& reader) -> std::unique_ptr<ColumnarData>;
+    /// Decodes only the array's size; elements are decoded on access. The reader is advanced past
+    /// the array only if the elements have a fixed size. The reader must outlive the LazyArray.
+    auto decodeLazy(DataReader& reader) -> std::unique_ptr<LazyArray>;
     auto copy() const -> std::unique_ptr<DataFormat> override;
 
 protected:
@@ -49,10 +69,18 @@ protected:
 
     auto doDecode(DataReader& reader) -> std::unique_ptr<Data> override;
     void doEncode(DataWriter& writer, const Data& data) override;
+    bool doCompile(CompiledFormat& program) const override;
+    auto doFixedSize() const -> std::optional<size_t> override;
 
 private:
+    auto decodePointees(DataReader& reader, size_t size) -> std::unique_ptr<Data>;
+    bool encodeDense(DataWriter& writer, const ArrayData& data) const;
+    bool encodeDense(DataWriter& writer, const ColumnarData& data) const;
+
     std::unique_ptr<ArraySizeProvider> m_sizeProvider;
     std::unique_ptr<DataFormat> m_elementFormat;
+    std::optional<CompiledFormat> m_denseElements;
+    size_t m_threadCount{1};
 };
 
 } // namespace kaizo::data
\ No newline at end of file
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstdint>
+#include <kaizo/binary/BinaryView.h>
+#include <kaizo/binary/Integers.h>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace kaizo::data {
+
+class ArrayData;
+class ColumnarData;
+class Data;
+class DataFormat;
+class DataReader;
+
+/// A DataFormat tree of records, fixed-length arrays and integers flattened into a sequence of
+/// operations. Integer fields are read at precomputed displacements from a cursor that is only
+/// advanced once per contiguous run of fields.
+class CompiledFormat
+{
+public:
+    enum class Code : uint8_t
+    {
+        Integer,
+        Advance,
+        Align,
+        BeginRecord,
+        Field,
+        EndRecord,
+        BeginArray,
+        EndArray,
+    };
+
+    struct Operation
+    {
+        Code code;
+        uint8_t size{0};
+        bool isSigned{false};
+        bool isBigEndian{false};
+        uint32_t jump{0};
+        size_t argument{0};
+    };
+
+    /// Returns nothing if the format (or any of its children) cannot be compiled, e.g. because it
+    /// uses pointers, strings, fixed offsets, tags or dynamically sized arrays.
+    static auto compile(const DataFormat& format) -> std::optional<CompiledFormat>;
+
+    void appendInteger(const IntegerLayout& layout);
+    void appendSkip(size_t size);
+    void appendAlign(size_t alignment);
+    void beginRecord();
+    void appendField(const std::string& name);
+    void endRecord();
+    void beginArray(size_t count);
+    void endArray();
+
+    auto operations() const -> const std::vector<Operation>&;
+    /// The number of bytes one instance occupies if it does not depend on alignment.
+    auto fixedSize() const -> std::optional<size_t>;
+    /// The number of bytes one instance occupies if every one of them belongs to an integer, i.e.
+    /// the instance can be encoded without skipping or aligning.
+    auto denseSize() const -> std::optional<size_t>;
+
+    auto decode(const BinaryView& binary, size_t offset) const
+        -> std::pair<std::unique_ptr<Data>, size_t>;
+    auto decode(DataReader& reader) const -> std::unique_ptr<Data>;
+    /// Writes denseSize() bytes per element of the array to the output; returns false if an
+    /// element does not have the structure of the program, e.g. because of a missing field.
+    bool encode(const ArrayData& array, uint8_t* output) const;
+    /// Writes denseSize() bytes per row; returns false unless the program encodes a record of
+    /// integers, each of which has an integer column.
+    bool encode(const ColumnarData& columns, uint8_t* output) const;
+
+    /// Runs the program on the binary, reporting the decoded structure to the sink; returns the
+    /// offset after the decoded data.
+    template <class Sink> auto run(const BinaryView& binary, size_t offset, Sink& sink) const
+        -> size_t;
+
+private:
+    struct EncodeFrame
+    {
+        const Data* data;
+        size_t index{0};
+        const std::string* field{nullptr};
+    };
+
+    void flush();
+    bool encode(const Data& data, uint8_t* output, std::vector<EncodeFrame>& stack) const;
+    auto measure(size_t& index) const -> std::optional<size_t>;
+    auto measureIntegers(size_t& index) const -> size_t;
+    static void writeInteger(uint8_t* data, const Operation& operation, uint64_t value);
+    static auto readInteger(const uint8_t* data, const Operation& operation) -> uint64_t;
+
+    std::vector<Operation> m_operations;
+    std::vector<std::string> m_names;
+    std::vector<size_t> m_openArrays;
+    size_t m_pending{0};
+};
+
+//##[ implementation ]#############################################################################
+
+inline auto CompiledFormat::readInteger(const uint8_t* data, const Operation& operation) -> uint64_t
+{
+    uint64_t value{0};
+    if (operation.isBigEndian)
+    {
+        for (auto i = 0U; i < operation.size; ++i)
+        {
+            value = (value << 8) | data[i];
+        }
+    }
+    else
+    {
+        for (auto i = 0U; i < operation.size; ++i)
+        {
+            value |= static_cast<uint64_t>(data[i]) << (i * 8);
+        }
+    }
+    return value;
+}
+
+inline void CompiledFormat::writeInteger(uint8_t* data, const Operation& operation, uint64_t value)
+{
+    if (operation.isBigEndian)
+    {
+        for (auto i = 0U; i < operation.size; ++i)
+        {
+            data[operation.size - 1 - i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+    else
+    {
+        for (auto i = 0U; i < operation.size; ++i)
+        {
+            data[i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+}
+
+template <class Sink>
+auto CompiledFormat::run(const BinaryView& binary, size_t offset, Sink& sink) const -> size_t
+{
+    std::vector<size_t> loops;
+    auto const* data = binary.data();
+    auto const size = binary.size();
+    for (size_t pc = 0; pc < m_operations.size(); ++pc)
+    {
+        auto const& operation = m_operations[pc];
+        switch (operation.code)
+        {
+        case Code::Integer:
+        {
+            auto const at = offset + operation.argument;
+            if (at + operation.size > size)
+            {
+                throw std::runtime_error{"CompiledFormat: data exceeds binary"};
+            }
+            auto const value = readInteger(data + at, operation);
+            if (operation.isSigned)
+            {
+                auto const shift = 64 - operation.size * 8;
+                sink.signedInteger(static_cast<int64_t>(value << shift) >> shift);
+            }
+            else
+            {
+                sink.unsignedInteger(value);
+            }
+            break;
+        }
+        case Code::Advance: offset += operation.argument; break;
+        case Code::Align:
+            if (offset % operation.argument != 0)
+            {
+                offset += operation.argument - offset % operation.argument;
+            }
+            break;
+        case Code::BeginRecord: sink.beginRecord(); break;
+        case Code::Field: sink.field(m_names[operation.argument]); break;
+        case Code::EndRecord: sink.endRecord(); break;
+        case Code::BeginArray:
+            sink.beginArray(operation.argument);
+            if (operation.argument == 0)
+            {
+                sink.endArray();
+                pc = operation.jump;
+            }
+            else
+            {
+                loops.push_back(operation.argument);
+            }
+            break;
+        case Code::EndArray:
+            if (--loops.back() > 0)
+            {
+                pc = operation.jump;
+            }
+            else
+            {
+                loops.pop_back();
+                sink.endArray();
+            }
+            break;
+        }
+    }
+
+    if (offset > size)
+    {
+        throw std::runtime_error{"CompiledFormat: data exceeds binary"};
+    }
+    return offset;
+}
+
+} // namespace kaizo::data
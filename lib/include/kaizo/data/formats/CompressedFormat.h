@@ -0,0 +1,31 @@
+#pragma once
+
+#include "DataFormat.h"
+#include <kaizo/compression/Codec.h>
+#include <memory>
+
+namespace kaizo::data {
+
+/// Data of an inner format stored compressed by a codec. The inner format is decoded from and
+/// encoded into its own binary, so it cannot contain pointers.
+class CompressedFormat final : public DataFormat
+{
+public:
+    CompressedFormat() = default;
+
+    void setCodec(std::unique_ptr<Codec>&& codec);
+    void setInnerFormat(std::unique_ptr<DataFormat>&& format);
+    auto copy() const -> std::unique_ptr<DataFormat> override;
+
+protected:
+    CompressedFormat(const CompressedFormat& other);
+
+    auto doDecode(DataReader& reader) -> std::unique_ptr<Data> override;
+    void doEncode(DataWriter& writer, const Data& data) override;
+
+private:
+    std::unique_ptr<Codec> m_codec;
+    std::unique_ptr<DataFormat> m_innerFormat;
+};
+
+} // namespace kaizo::data
@@ -6,6 +6,9 @@
 
 namespace kaizo::data {
 
+class ArrayData;
+class ColumnarData;
+class CompiledFormat;
 class Data;
 class DataReader;
 class DataWriter;
@@ -24,7 +27,21 @@ public:
     void setTag(const std::string& tag);
     auto decode(DataReader& reader) -> std::unique_ptr<Data>;
     void encode(DataWriter& writer, const Data& data);
+    /// Appends the operations for decoding this format to the program; returns false if the format
+    /// cannot be compiled.
+    bool compile(CompiledFormat& program) const;
+    /// The number of bytes every instance of this format occupies, if it does not depend on the
+    /// data or its position.
+    auto fixedSize() const -> std::optional<size_t>;
     virtual bool isPointer() const { return false; }
+    /// Adds a column able to hold this format's values; returns false if the format is not a scalar.
+    virtual bool addColumn(ColumnarData&, const std::string&) const
+    {
+        return false;
+    }
+    /// Creates empty columns for storing arrays of this format column-wise; returns nullptr if the
+    /// format is not a record of scalars.
+    virtual auto makeColumns() const -> std::unique_ptr<ColumnarData>;
 
     template <class T> auto copyAs() -> std::unique_ptr<T>;
     virtual auto copy() const -> std::unique_ptr<DataFormat> = 0;
@@ -35,7 +52,17 @@ protected:
 
     virtual auto doDecode(DataReader& reader) -> std::unique_ptr<Data> = 0;
     virtual void doEncode(DataWriter& writer, const Data& data) = 0;
+    virtual bool doCompile(CompiledFormat&) const
+    {
+        return false;
+    }
+    virtual auto doFixedSize() const -> std::optional<size_t>
+    {
+        return {};
+    }
     void track(DataReader& reader, size_t offset, size_t size);
+    void beginDecode(DataReader& reader) const;
+    void endDecode(DataReader& reader) const;
 
 private:
     std::optional<size_t> m_offset;
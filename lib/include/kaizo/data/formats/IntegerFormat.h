@@ -21,6 +21,7 @@ public:
     auto sizeInBytes() const -> size_t;
 
     auto layout() const -> const IntegerLayout&;
+    bool addColumn(ColumnarData& columns, const std::string& name) const override;
 
     auto copy() const -> std::unique_ptr<DataFormat> override;
 
@@ -29,6 +30,8 @@ protected:
 
     auto doDecode(DataReader& reader) -> std::unique_ptr<Data> override;
     void doEncode(DataWriter& writer, const Data& data) override;
+    bool doCompile(CompiledFormat& program) const override;
+    auto doFixedSize() const -> std::optional<size_t> override;
 
 private:
     IntegerLayout m_layout;
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace kaizo::data {
+
+class ArrayData;
+class Data;
+class DataFormat;
+class DataReader;
+
+/// An array whose elements are only decoded when accessed; decoded elements are kept. Elements of
+/// a fixed size are located directly, all others require decoding their predecessors first.
+class LazyArray
+{
+public:
+    LazyArray(DataReader& reader, std::unique_ptr<DataFormat>&& elementFormat, size_t offset,
+              size_t size);
+    ~LazyArray();
+
+    auto elementCount() const -> size_t;
+    auto offset() const -> size_t;
+    /// The number of bytes between two elements, if the element format has a fixed size.
+    auto stride() const -> std::optional<size_t>;
+    bool isDecoded(size_t index) const;
+    auto element(size_t index) -> const Data&;
+    auto materialize() -> std::unique_ptr<ArrayData>;
+
+private:
+    auto elementOffset(size_t index) -> size_t;
+    void decode(size_t index, size_t offset);
+
+    DataReader* m_reader;
+    std::unique_ptr<DataFormat> m_elementFormat;
+    size_t m_offset;
+    std::optional<size_t> m_stride;
+    std::vector<size_t> m_offsets;
+    std::vector<std::unique_ptr<Data>> m_elements;
+};
+
+} // namespace kaizo::data
@@ -12,6 +12,12 @@ namespace kaizo::data {
 class PointerFormat : public DataFormat
 {
 public:
+    /// Where a pointer points to; null pointers have no offset.
+    struct Target
+    {
+        std::optional<size_t> offset;
+    };
+
     PointerFormat() = default;
 
     void useAddressMap(bool on);
@@ -21,6 +27,15 @@ public:
     void setLayout(std::unique_ptr<AddressLayout>&& layout);
 
     auto copy() const -> std::unique_ptr<DataFormat> override;
+    bool isPointer() const override
+    {
+        return true;
+    }
+
+    /// Reads the pointer without following it, leaving the reader after the pointer.
+    auto decodeAddress(DataReader& reader) -> std::optional<Target>;
+    /// Decodes the pointee at the target, leaving the reader's offset unchanged.
+    auto decodeTarget(DataReader& reader, const Target& target) -> std::unique_ptr<Data>;
 
     auto addressFormat() const -> const AddressFormat&;
     bool hasNullPointer() const;
@@ -31,8 +46,10 @@ protected:
 
     auto doDecode(DataReader& reader) -> std::unique_ptr<Data> override;
     void doEncode(DataWriter& writer, const Data& data) override;
+    auto doFixedSize() const -> std::optional<size_t> override;
 
     virtual auto readAddress(DataReader& reader) -> std::optional<Address>;
+    auto readTarget(DataReader& reader) -> std::optional<Target>;
     virtual void writeAddressPlaceHolder(DataWriter& writer);
     virtual void writeNullAddress(DataWriter& writer);
     virtual auto makeStorageFormat() -> std::shared_ptr<AddressLayout>;
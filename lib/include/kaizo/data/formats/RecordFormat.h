@@ -23,6 +23,7 @@ public:
     auto has(const std::string& name);
     auto element(size_t index) const -> const Element&;
     auto element(const std::string& name) -> const Element&;
+    auto makeColumns() const -> std::unique_ptr<ColumnarData> override;
 
     auto copy() const -> std::unique_ptr<DataFormat> override;
 
@@ -31,6 +32,8 @@ protected:
 
     auto doDecode(DataReader& reader) -> std::unique_ptr<Data> override;
     void doEncode(DataWriter& writer, const Data& data) override;
+    bool doCompile(CompiledFormat& program) const override;
+    auto doFixedSize() const -> std::optional<size_t> override;
 
 private:
     std::vector<Element> m_elements;
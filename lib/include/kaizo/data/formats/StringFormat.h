@@ -15,6 +15,7 @@ public:
 
     void setEncoding(const std::shared_ptr<TextEncoding>& encoding);
     void setFixedLength(size_t length);
+    bool addColumn(ColumnarData& columns, const std::string& name) const override;
     auto copy() const -> std::unique_ptr<DataFormat> override;
 
 protected:
@@ -22,6 +23,7 @@ protected:
 
     auto doDecode(DataReader& reader) -> std::unique_ptr<Data> override;
     void doEncode(DataWriter& writer, const Data& data) override;
+    auto doFixedSize() const -> std::optional<size_t> override;
 
 private:
     std::optional<size_t> m_fixedLength;
@@ -1,12 +1,16 @@
 #pragma once
 
 #include "kaizo/data/linking/Constraint.h"
+#include "kaizo/data/linking/FeasibilityTracker.h"
 #include "kaizo/data/linking/FreeSpace.h"
 #include "kaizo/data/linking/LinkObject.h"
+#include "kaizo/data/linking/Packer.h"
+#include "kaizo/data/linking/PackingStatistics.h"
+#include "kaizo/data/linking/PackingTrace.h"
 #include <filesystem>
-#include <fstream>
 #include <functional>
 #include <memory>
+#include <stack>
 #include <vector>
 
 namespace kaizo::data {
@@ -21,10 +25,14 @@ public:
     PriorityObjectList();
     void setScoringStrategy(ScoreObjectStrategy strategy);
     void addObject(LinkObject* object);
+    void clear();
     auto mapNext();
     auto unmapLast();
     auto nextUnmapped() const -> LinkObject*;
-    bool canBeSatisfied() const;
+    /// Checks whether every unmapped object can still be allocated. This only takes constant
+    /// time if the FreeSpace is observed by feasibility().
+    bool canBeSatisfied();
+    auto feasibility() -> FeasibilityTracker&;
     bool hasUnmapped() const;
 
     auto unmappedObjectCount() const -> size_t;
@@ -44,43 +52,67 @@ private:
     std::vector<ScoredObject> m_unmapped;
     std::vector<ScoredObject> m_mapped;
     ScoreObjectStrategy m_scoreObject;
+    FeasibilityTracker m_feasibility;
 };
 
-class BacktrackingPacker
+class BacktrackingPacker : public Packer
 {
 public:
     using ScoringStrategy = PriorityObjectList::ScoreObjectStrategy;
 
     BacktrackingPacker();
 
-    void setLogFile(const std::filesystem::path& log);
+    /// Records the search to the given file while packing, see PackingTrace.
+    void setTraceFile(const std::filesystem::path& trace, TraceLevel level = TraceLevel::Search);
 
+    /// Objects with higher scores are allocated first.
     void setScoringStrategy(ScoringStrategy strategy);
-    void setFreeBlocks(std::vector<FreeBlock>&& blocks);
-    void addFreeBlock(const FreeBlock& block);
-    void addObject(std::unique_ptr<LinkObject>&& object);
-    auto object(const size_t index) const -> LinkObject*;
-    auto objectCount() const -> size_t;
-
-    bool pack();
+    /// Gives up after trying the given number of allocations, e.g. to restart with another
+    /// scoring strategy.
+    void setStepLimit(size_t steps);
+    /// Checks whether packing failed only because of the step limit.
+    bool reachedStepLimit() const;
+    /// Allocates objects greedily before backtracking, which then only needs to allocate the
+    /// objects that did not fit (enabled by default).
+    void setGreedyFirst(bool greedyFirst);
+    /// Also measures the time spent finding and checking allocations, which reads the clock
+    /// several times per step (disabled by default).
+    void setProfiling(bool profiling);
+    /// Returns what the last pack() did.
+    auto statistics() const -> const PackingStatistics&;
+
+protected:
+    bool doPack() override;
 
 private:
-    FreeSpace m_freeSpace;
     PriorityObjectList m_objects;
-    std::vector<std::unique_ptr<LinkObject>> m_linkObjects;
-    size_t m_objectSize{0};
+    std::optional<size_t> m_stepLimit;
+    bool m_reachedStepLimit{false};
+    bool m_isGreedyFirst{true};
+    bool m_isProfiling{false};
+    PackingStatistics m_statistics;
+
+    bool backtrack(const std::vector<LinkObject*>& objects);
+    auto findAllocations(const LinkObject& object) -> std::vector<Allocation>;
+    bool canBeSatisfied();
+    /// Returns the given total for a ScopedTimer if profiling is enabled.
+    auto profiled(std::chrono::nanoseconds& total) -> std::chrono::nanoseconds*;
 
     struct BacktrackingState
     {
     public:
-        BacktrackingState(std::vector<Allocation>&& allocations);
+        BacktrackingState(std::vector<Allocation>&& allocations, size_t objectSize);
 
         bool hasMore() const;
         bool next();
         auto allocation() const -> Allocation;
 
     private:
+        /// The number of addresses in the allocation at which the object fits.
+        auto span(size_t index) const -> size_t;
+
         std::vector<Allocation> m_allocations;
+        size_t m_objectSize;
         size_t m_allocationIndex{0};
         size_t m_allocationOffset{0};
         size_t m_shift{0};
@@ -89,16 +121,9 @@ private:
 
     std::stack<BacktrackingState> m_state;
 
-    void initializeLogging();
-    void log_StartPacking();
-    void log_InstantFail();
-    void log_Allocated(const LinkObject&);
-    void log_Deallocated(const LinkObject&);
-    void log_Success();
-    void log_Fail();
-
-    std::optional<std::filesystem::path> m_logFile;
-    std::ofstream m_log;
+    std::optional<std::filesystem::path> m_traceFile;
+    TraceLevel m_traceLevel{TraceLevel::Off};
+    PackingTrace m_trace;
 };
 
 } // namespace kaizo::data
\ No newline at end of file
@@ -1,12 +1,17 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <kaizo/addresses/Address.h>
 #include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace kaizo::data {
 
+class FreeBlock;
 class FreeSpace;
 
 /// Describes a range where a LinkObject can be allocated while
@@ -18,8 +23,34 @@ struct Allocation
     size_t offset;
     Address address;
     size_t size;
+    /// Candidate addresses within the allocation are multiples of this apart.
+    size_t alignment{1};
+    size_t target{0};
 };
 
+/// Where a LinkObject may be allocated: its address is a multiple of the alignment and it lies
+/// within [lower, upper) of one of the targets whose bits are set. A missing bound does not
+/// restrict it.
+struct Placement
+{
+    static constexpr uint64_t AllTargets = ~uint64_t{0};
+
+    std::optional<Address> lower;
+    std::optional<Address> upper;
+    size_t alignment{1};
+    uint64_t targets{AllTargets};
+
+    bool isBounded() const;
+    bool allowsTarget(size_t target) const;
+    /// Returns the part of the block within [lower, upper), if any. Blocks of targets that are
+    /// not allowed or whose addresses are not compatible with the bounds have no such part.
+    auto clip(const FreeBlock& block) const -> std::optional<FreeBlock>;
+    /// Checks whether an object of the given size fits into the block within this placement.
+    bool fits(const FreeBlock& block, size_t size) const;
+};
+
+class LinkObject;
+
 class Constraint
 {
 public:
@@ -27,11 +58,19 @@ public:
 
     /// Finds all viable allocations for this constraint with the given size.
     /// Also used for computing the slack?
-    virtual auto findAllocations(const FreeSpace& space, size_t) const
-        -> std::vector<Allocation> = 0;
+    virtual auto findAllocations(const FreeSpace& space, size_t size) const
+        -> std::vector<Allocation>;
 
     /// Checks whether the FreeSpace can still satisfy this constraint.
-    virtual bool hasAllocations(const FreeSpace& space, size_t) const = 0;
+    virtual bool hasAllocations(const FreeSpace& space, size_t size) const;
+
+    /// Returns where an object of the given size may be placed, or nothing if it cannot be
+    /// placed anywhere. Constraints relative to other objects depend on their allocations.
+    virtual auto placement(size_t size) const -> std::optional<Placement> = 0;
+
+    /// Checks whether an object of the given size may be allocated at the given address of the
+    /// target.
+    bool isSatisfiedBy(size_t target, const Address& address, size_t size) const;
 
     /// Checks if the constraint can only result in a single, fixed Address.
     virtual auto yieldsFixedAddress() const -> std::optional<Address> = 0;
@@ -42,6 +81,11 @@ public:
 
     virtual auto copy() const -> std::unique_ptr<Constraint> = 0;
     virtual auto toString() const -> std::string = 0;
+
+    /// Returns the objects whose allocations this constraint's placement depends on.
+    virtual auto references() const -> std::vector<const LinkObject*>;
+    /// Replaces the objects this constraint refers to by their copies.
+    virtual void rebind(const std::unordered_map<const LinkObject*, const LinkObject*>& copies);
 };
 
 class FixedAddressConstraint : public Constraint
@@ -49,9 +93,7 @@ class FixedAddressConstraint : public Constraint
 public:
     explicit FixedAddressConstraint(Address address);
 
-    auto findAllocations(const FreeSpace& space, size_t) const
-        -> std::vector<Allocation> override;
-    bool hasAllocations(const FreeSpace& space, size_t) const override;
+    auto placement(size_t size) const -> std::optional<Placement> override;
     auto yieldsFixedAddress() const -> std::optional<Address> override;
     auto strength() const -> unsigned override;
     auto copy() const -> std::unique_ptr<Constraint> override;
@@ -61,18 +103,132 @@ private:
     Address m_address;
 };
 
+/// The object lies within [lower, upper).
+class AddressRangeConstraint : public Constraint
+{
+public:
+    explicit AddressRangeConstraint(Address lower, Address upper);
+
+    auto placement(size_t size) const -> std::optional<Placement> override;
+    auto yieldsFixedAddress() const -> std::optional<Address> override;
+    auto strength() const -> unsigned override;
+    auto copy() const -> std::unique_ptr<Constraint> override;
+    auto toString() const -> std::string override;
+
+private:
+    Address m_lower;
+    Address m_upper;
+};
+
+/// The object lies within the segment containing the given address. Segments are aligned
+/// ranges of the given size, e.g. the 256 MiB regions reachable by a MIPS jump.
+class SegmentConstraint : public Constraint
+{
+public:
+    explicit SegmentConstraint(Address address, size_t segmentSize);
+
+    auto placement(size_t size) const -> std::optional<Placement> override;
+    auto yieldsFixedAddress() const -> std::optional<Address> override;
+    auto strength() const -> unsigned override;
+    auto copy() const -> std::unique_ptr<Constraint> override;
+    auto toString() const -> std::string override;
+
+private:
+    Address m_address;
+    size_t m_segmentSize;
+};
+
+class AlignmentConstraint : public Constraint
+{
+public:
+    explicit AlignmentConstraint(size_t alignment);
+
+    auto placement(size_t size) const -> std::optional<Placement> override;
+    auto yieldsFixedAddress() const -> std::optional<Address> override;
+    auto strength() const -> unsigned override;
+    auto copy() const -> std::unique_ptr<Constraint> override;
+    auto toString() const -> std::string override;
+
+private:
+    size_t m_alignment;
+};
+
+/// The object is allocated in one of the targets whose bits are set, e.g. the overlays a
+/// function may be linked into.
+class TargetConstraint : public Constraint
+{
+public:
+    explicit TargetConstraint(uint64_t targets);
+
+    auto placement(size_t size) const -> std::optional<Placement> override;
+    auto yieldsFixedAddress() const -> std::optional<Address> override;
+    auto strength() const -> unsigned override;
+    auto copy() const -> std::unique_ptr<Constraint> override;
+    auto toString() const -> std::string override;
+
+private:
+    uint64_t m_targets;
+};
+
+/// The object lies within the same segment as another object. This does not restrict it until
+/// the other object is allocated; packers also reject allocations of the other object that violate
+/// it. LinkObject::constrainSameSegment constrains both objects instead.
+class SameSegmentConstraint : public Constraint
+{
+public:
+    explicit SameSegmentConstraint(const LinkObject* other, size_t segmentSize);
+
+    auto placement(size_t size) const -> std::optional<Placement> override;
+    auto yieldsFixedAddress() const -> std::optional<Address> override;
+    auto strength() const -> unsigned override;
+    auto copy() const -> std::unique_ptr<Constraint> override;
+    auto toString() const -> std::string override;
+    auto references() const -> std::vector<const LinkObject*> override;
+    void rebind(const std::unordered_map<const LinkObject*, const LinkObject*>& copies) override;
+
+private:
+    const LinkObject* m_other;
+    size_t m_segmentSize;
+};
+
+/// The object's address minus another object's address lies within [minimum, maximum]. This
+/// does not restrict it until the other object is allocated; packers also reject allocations of the
+/// other object that violate it. LinkObject::constrainRelative constrains both objects instead.
+class RelativeRangeConstraint : public Constraint
+{
+public:
+    explicit RelativeRangeConstraint(const LinkObject* other, int64_t minimum, int64_t maximum);
+
+    auto placement(size_t size) const -> std::optional<Placement> override;
+    auto yieldsFixedAddress() const -> std::optional<Address> override;
+    auto strength() const -> unsigned override;
+    auto copy() const -> std::unique_ptr<Constraint> override;
+    auto toString() const -> std::string override;
+    auto references() const -> std::vector<const LinkObject*> override;
+    void rebind(const std::unordered_map<const LinkObject*, const LinkObject*>& copies) override;
+
+private:
+    const LinkObject* m_other;
+    int64_t m_minimum;
+    int64_t m_maximum;
+};
+
+/// All of the given constraints hold; their placements, including their targets, are
+/// intersected.
 class AndConstraint : public Constraint
 {
 public:
     explicit AndConstraint(std::vector<std::unique_ptr<Constraint>>&& constraints);
 
-    auto findAllocations(const FreeSpace& space, size_t) const
-        -> std::vector<Allocation> override;
-    bool hasAllocations(const FreeSpace& space, size_t) const override;
+    void append(std::unique_ptr<Constraint>&& constraint);
+
+    auto placement(size_t size) const -> std::optional<Placement> override;
     auto yieldsFixedAddress() const -> std::optional<Address> override;
     auto strength() const -> unsigned override;
     auto copy() const -> std::unique_ptr<Constraint> override;
     auto toString() const -> std::string override;
+    auto references() const -> std::vector<const LinkObject*> override;
+    void rebind(const std::unordered_map<const LinkObject*, const LinkObject*>& copies) override;
 
 private:
     std::vector<std::unique_ptr<Constraint>> m_constraints;
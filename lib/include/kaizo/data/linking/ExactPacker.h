@@ -0,0 +1,89 @@
+#pragma once
+
+#include "kaizo/data/linking/FeasibilityTracker.h"
+#include "kaizo/data/linking/Packer.h"
+#include <optional>
+#include <vector>
+
+namespace kaizo::data {
+
+/// Finds an allocation by branch and bound, or proves that there is none.
+///
+/// Every packing can be moved into a normal form in which each object lies at the lowest address
+/// its constraints allow after the preceding object in its block. The search builds this form
+/// from the lowest address upwards: the lowest free block either starts with one of the
+/// remaining objects or is left empty. Objects without constraints are interchangeable within a
+/// block, so consecutive ones are only tried by decreasing size, and objects of the same size are
+/// tried once.
+///
+/// A node is pruned if some remaining object fits nowhere, if the objects of at least a given
+/// size exceed the blocks they fit in, either in bytes (which is the LP relaxation of assigning
+/// objects to blocks by size) or in number, or if no subset of the remaining objects fills the
+/// lowest block closely enough to leave room for the others. Objects whose allowed range ends
+/// soonest are tried first, then larger objects before smaller ones.
+///
+/// Moving objects to lower addresses can break constraints relative to other objects, so with
+/// such constraints solutions that need gaps between related objects may be missed.
+class ExactPacker : public Packer
+{
+public:
+    ExactPacker();
+
+    /// Checks whether the last pack() searched every normal form without finding a packing,
+    /// as opposed to being stopped. The search may miss solutions if objects reference each
+    /// other, so in that case only fixed-address objects that cannot be placed prove anything.
+    bool provedInfeasible() const;
+    /// Returns the number of nodes the last pack() visited.
+    auto nodeCount() const -> size_t;
+
+protected:
+    bool doPack() override;
+
+private:
+    /// Objects that are interchangeable, i.e. have the same size and no constraints.
+    struct Class
+    {
+        size_t size;
+        bool isPlain;
+        std::vector<LinkObject*> objects;
+        size_t allocated{0};
+
+        auto remaining() const -> size_t;
+    };
+
+    struct Frame
+    {
+        /// Plain classes before this one are not tried, see above; only set while the block that
+        /// the previous plain object went to is continued.
+        size_t firstPlainClass{0};
+        /// The classes to try, in order; determined when the frame is first visited.
+        std::optional<std::vector<size_t>> classes;
+        size_t nextClass{0};
+        bool hasLeftBlockEmpty{false};
+    };
+
+    bool placeFixedObjects();
+    void buildClasses();
+    bool search();
+    auto orderClasses(size_t firstPlainClass) const -> std::vector<size_t>;
+    /// Places an object of the given class at the lowest possible address of the lowest block.
+    bool place(size_t index);
+    bool continuesBlock(size_t index) const;
+    void leaveBlockEmpty();
+    void undo();
+    bool isWithinBounds();
+    auto largestFill(size_t size) const -> size_t;
+
+    std::vector<Class> m_classes;
+    /// The classes whose objects were placed, or nothing if a block was left empty.
+    std::vector<std::optional<size_t>> m_decisions;
+    FeasibilityTracker m_feasibility;
+    size_t m_remainingSize{0};
+    size_t m_remainingCount{0};
+    size_t m_nodeCount{0};
+    /// Whether some object is referenced by another one's constraints.
+    bool m_hasReferences{false};
+    bool m_provedInfeasible{false};
+};
+
+} // namespace kaizo::data
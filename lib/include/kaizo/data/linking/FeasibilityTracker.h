@@ -0,0 +1,100 @@
+#pragma once
+
+#include "kaizo/data/linking/Constraint.h"
+#include "kaizo/data/linking/FreeSpace.h"
+#include "kaizo/data/linking/LinkObject.h"
+#include <map>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace kaizo::data {
+
+/// Keeps track of whether every waiting object can still be allocated, so that checking this
+/// does not visit every object after each allocation.
+///
+/// Objects bounded to an address range count the blocks they fit in; a block that is added to or
+/// removed from the FreeSpace only visits the objects whose ranges overlap it. Unbounded objects
+/// only need the largest block they fit in, so they are grouped by alignment and targets and
+/// compared with the largest usable block of their group. Objects whose constraints refer to
+/// another object are checked again once that object is allocated or deallocated.
+class FeasibilityTracker : public FreeSpaceObserver
+{
+public:
+    /// The tracker must observe the given FreeSpace to stay up to date.
+    explicit FeasibilityTracker(const FreeSpace* space);
+
+    void clear();
+    /// Tracks the object, which waits to be allocated.
+    void addObject(const LinkObject* object);
+    /// Tells the tracker that the object was allocated (no longer waiting) or deallocated.
+    void setWaiting(const LinkObject* object, bool isWaiting);
+    /// Checks whether every waiting object can still be allocated.
+    bool isFeasible();
+
+    void blockAdded(const FreeBlock& block) override;
+    void blockRemoved(const FreeBlock& block) override;
+
+private:
+    enum class Kind
+    {
+        /// The object cannot be allocated anywhere.
+        Impossible,
+        Unbounded,
+        /// Bounded on both sides, i.e. indexed by its upper bound.
+        Bounded,
+        HalfBounded,
+    };
+
+    struct Entry
+    {
+        const LinkObject* object{nullptr};
+        Kind kind{Kind::Impossible};
+        std::optional<Placement> placement;
+        /// The number of blocks a (half-)bounded object fits in.
+        size_t blockCount{0};
+        bool isWaiting{true};
+        bool isTracked{false};
+        bool isDirty{false};
+        std::multimap<uint64_t, size_t>::iterator bound;
+        std::multiset<size_t>::iterator size;
+    };
+
+    /// The unbounded objects with the same alignment and targets.
+    struct Group
+    {
+        std::multiset<size_t> waiting;
+        /// The number of bytes at the first aligned address of every block.
+        std::multiset<size_t> usable;
+    };
+
+    void markDirty(size_t index);
+    void track(size_t index);
+    void untrack(size_t index);
+    void update(const FreeBlock& block, bool isAdded);
+    void count(size_t index, const FreeBlock& block, bool isAdded);
+    auto countBlocks(const Entry& entry) const -> size_t;
+    void checkConsistency(bool isFeasible) const;
+
+    const FreeSpace* m_space;
+    std::vector<Entry> m_entries;
+    std::unordered_map<const LinkObject*, size_t> m_indices;
+    /// Maps objects to the objects whose constraints refer to them.
+    std::unordered_map<const LinkObject*, std::vector<size_t>> m_dependents;
+    std::vector<size_t> m_dirty;
+
+    /// The bounded objects by their upper bound; bounds of different targets may have different
+    /// address formats, so they are indexed as integers.
+    std::multimap<uint64_t, size_t> m_bounded;
+    /// The largest range of any bounded object; bounds the upper bounds of the objects a block
+    /// overlaps.
+    size_t m_maximumRange{0};
+    std::vector<size_t> m_halfBounded;
+    /// The groups by alignment and targets.
+    std::map<std::pair<size_t, uint64_t>, Group> m_groups;
+    size_t m_infeasibleCount{0};
+};
+
+} // namespace kaizo::data
@@ -2,25 +2,37 @@
 
 #include <cstddef>
 #include <kaizo/addresses/Address.h>
+#include <optional>
 #include <string>
 
 namespace kaizo::data {
 
 class SplitFreeBlocks;
 
+/// Targets are numbered, so that a set of them fits into a bit mask.
+constexpr size_t MaximumTargetCount = 64;
+
+/// A free range of a target, i.e. a file that objects are linked into. The offset is relative to
+/// the target, the address is where the range is loaded. The blocks of different targets may
+/// overlap, e.g. those of overlays that are loaded to the same addresses.
 class FreeBlock
 {
 public:
     FreeBlock() = default;
-    explicit FreeBlock(const size_t offset, const Address address, size_t size);
+    explicit FreeBlock(const size_t offset, const Address address, size_t size,
+                       size_t target = 0);
 
     bool isValid() const;
+    auto target() const -> size_t;
     auto offset() const -> size_t;
     auto address() const -> Address;
     auto size() const -> size_t;
     bool contains(const Address address) const;
     bool fits(size_t size) const;
     bool fits(const Address address, size_t length) const;
+    /// Returns the aligned address in this block that an object of the given size fits at with
+    /// the fewest bytes left over before or after it, i.e. at the block's start or end.
+    auto alignedFit(size_t size, size_t alignment) const -> std::optional<Address>;
     auto allocate(const Address address, size_t length) const -> SplitFreeBlocks;
     auto toString() const -> std::string;
     auto endAddress() const -> Address;
@@ -29,6 +41,7 @@ private:
     size_t m_offset{0};
     Address m_address;
     size_t m_size{0};
+    size_t m_target{0};
 };
 
 class SplitFreeBlocks
@@ -1,26 +1,61 @@
 #pragma once
 
 #include "FreeBlock.h"
+#include <cstdint>
+#include <limits>
 #include <optional>
-#include <stack>
+#include <random>
+#include <set>
+#include <utility>
 #include <vector>
 
 namespace kaizo::data {
 
+/// Is told about every block that is added to or removed from a FreeSpace. A block that changes
+/// is removed and then added again.
+class FreeSpaceObserver
+{
+public:
+    virtual ~FreeSpaceObserver() = default;
+
+    virtual void blockAdded(const FreeBlock& block) = 0;
+    virtual void blockRemoved(const FreeBlock& block) = 0;
+};
+
+/// The free blocks of the targets, ordered by target, then address. Blocks are addressed by their
+/// index in that order and kept in a balanced tree, so that looking up, adding, splitting and
+/// erasing a block is O(log n) and the first fitting block is found in O(log n) as well. A second
+/// index orders them by size: hasBlockThatFits is O(1), the best and worst fit are O(log n).
 class FreeSpace
 {
 public:
     FreeSpace() = default;
     explicit FreeSpace(std::vector<FreeBlock>&& blocks);
 
-    auto findBlockThatContains(const Address address) -> std::optional<size_t>;
+    auto findBlockThatContains(size_t target, const Address address) const
+        -> std::optional<size_t>;
     auto findFirstBlockThatFits(size_t size) const -> std::optional<size_t>;
+    /// Returns the smallest block the given size fits in.
+    auto findBestFit(size_t size) const -> std::optional<size_t>;
+    /// Returns the largest block, if the given size fits in it.
+    auto findWorstFit(size_t size) const -> std::optional<size_t>;
     auto findBlocksThatFit(size_t size) const -> std::vector<size_t>;
-    auto findBlockWithinRange(const Address& address, size_t length, size_t size)
-        -> std::optional<size_t>;
+    auto findBlocksThatFit(size_t size, size_t alignment) const -> std::vector<size_t>;
+    /// Returns the index range [first, last) of the blocks of the target that overlap
+    /// [lower, upper). A missing bound does not restrict the range; bounds whose addresses are not
+    /// compatible with the target's yield an empty range.
+    auto findBlocksWithinRange(size_t target, const std::optional<Address>& lower,
+                               const std::optional<Address>& upper) const
+        -> std::pair<size_t, size_t>;
     // auto findBlockWithAttribute();
 
     auto capacity() const -> size_t;
+    /// Returns one more than the largest target of any block that was added.
+    auto targetCount() const -> size_t;
+    /// Returns 0 if there are no blocks.
+    auto largestBlockSize() const -> size_t;
+    /// Returns the sizes of all blocks, largest first.
+    auto blockSizes() const -> std::vector<size_t>;
 
     bool hasBlockThatFits(size_t size) const;
 
@@ -28,29 +63,130 @@ public:
     auto blockCount() const -> size_t;
     auto block(size_t index) const -> const FreeBlock&;
 
-    /// Allocates all Addresses within the given range.
+    /// Allocates all Addresses of the target within the given range.
     /// Addresses not within the free space are ignored.
-    void allocateRange(const Address address, size_t length);
+    void allocateRange(size_t target, const Address address, size_t length);
 
     void allocate(size_t hint, const Address address, size_t length);
     void allocate(size_t hint, size_t length);
+    /// Reverts the last allocation that has not been reverted yet, in O(log n): the undo log
+    /// finds the blocks the allocation left over by target and address in the tree.
     void deallocateLast();
+    auto allocationCount() const -> size_t;
+
+    /// Notifies the given observer of all changes until another one is set; nullptr removes it.
+    void setObserver(FreeSpaceObserver* observer);
+
+    /// Sets an observer for the lifetime of the guard.
+    class ScopedObserver
+    {
+    public:
+        ScopedObserver(FreeSpace& space, FreeSpaceObserver& observer);
+        ~ScopedObserver();
+
+        ScopedObserver(const ScopedObserver&) = delete;
+        auto operator=(const ScopedObserver&) -> ScopedObserver& = delete;
+
+    private:
+        FreeSpace& m_space;
+    };
 
 private:
-    std::vector<FreeBlock> m_blocks;
+    struct SizeKey
+    {
+        size_t size{0};
+        size_t target{0};
+        Address address;
+    };
 
-    struct Split
+    /// Orders keys by size, then target and address; lookups by size alone find the smallest
+    /// fitting block.
+    struct SizeOrder
     {
-        bool isDeletion() const
+        using is_transparent = void;
+
+        bool operator()(const SizeKey& lhs, const SizeKey& rhs) const
         {
-            return begin == end;
+            if (lhs.size != rhs.size)
+            {
+                return lhs.size < rhs.size;
+            }
+            if (lhs.target != rhs.target)
+            {
+                return lhs.target < rhs.target;
+            }
+            return lhs.address < rhs.address;
         }
 
-        size_t begin{0}, end{0};
+        bool operator()(const SizeKey& lhs, size_t rhs) const
+        {
+            return lhs.size < rhs;
+        }
+
+        bool operator()(size_t lhs, const SizeKey& rhs) const
+        {
+            return lhs < rhs.size;
+        }
+    };
+
+    static constexpr uint32_t NoNode = std::numeric_limits<uint32_t>::max();
+
+    /// A node of the treap that holds the blocks in order. Every node knows the number of blocks
+    /// and the largest block in its subtree, which locates blocks by index and the first fitting
+    /// block in a single descent.
+    struct Node
+    {
+        FreeBlock block;
+        uint32_t left{NoNode};
+        uint32_t right{NoNode};
+        uint32_t priority{0};
+        uint32_t count{1};
+        size_t largest{0};
+    };
+
+    auto count(uint32_t node) const -> size_t;
+    auto largest(uint32_t node) const -> size_t;
+    void update(uint32_t node);
+    auto nodeAt(size_t index) const -> uint32_t;
+    /// Returns the length of the prefix of blocks for which the predicate holds.
+    template <typename Predicate>
+    auto partitionPoint(Predicate isBefore) const -> size_t;
+    /// Calls the visitor with the index and block of every block of at least the given size, in
+    /// order.
+    template <typename Visitor>
+    void visitBlocksThatFit(size_t size, Visitor visit) const;
+    /// Splits a subtree into its first index blocks and the rest.
+    auto split(uint32_t node, size_t index) -> std::pair<uint32_t, uint32_t>;
+    auto merge(uint32_t left, uint32_t right) -> uint32_t;
+    /// Replaces the block at the index of a subtree without changing the subtree's shape.
+    void assign(uint32_t node, size_t index, const FreeBlock& block);
+
+    auto indexOf(size_t target, const Address& address) const -> size_t;
+    /// Returns the index range [first, last) of the blocks of the target.
+    auto targetRange(size_t target) const -> std::pair<size_t, size_t>;
+    /// Replaces the given number of blocks from the index on by the given blocks, which take their
+    /// place in the order. Allocating and reverting a split is a single such replacement.
+    void replaceBlocks(size_t index, size_t replaced, const SplitFreeBlocks& blocks);
+    void checkInvariants() const;
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_freeNodes;
+    uint32_t m_root{NoNode};
+    std::minstd_rand m_priorities;
+    std::set<SizeKey, SizeOrder> m_sizes;
+    size_t m_capacity{0};
+    size_t m_targetCount{0};
+    FreeSpaceObserver* m_observer{nullptr};
+
+    /// An entry of the undo log: the block an allocation split and the blocks it left over.
+    /// Entries refer to blocks by target and address, so blocks added later do not invalidate them.
+    struct Split
+    {
         FreeBlock original;
+        SplitFreeBlocks blocks;
     };
 
-    std::stack<Split> m_splits;
+    std::vector<Split> m_splits;
 };
 
 } // namespace kaizo::data
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "kaizo/data/linking/Packer.h"
+#include <vector>
+
+namespace kaizo::data {
+
+/// Allocates objects one after another without ever revisiting a decision: objects with a fixed
+/// address first, then constrained objects and finally all others, each by decreasing size.
+/// Packing only succeeds if the allocations satisfy every constraint.
+class GreedyPacker : public Packer
+{
+public:
+    enum class Fit
+    {
+        /// Use the allocation at the lowest address.
+        First,
+        /// Use the smallest allocation, leaving larger blocks for larger objects.
+        Best,
+    };
+
+    explicit GreedyPacker(Fit fit = Fit::Best);
+
+protected:
+    bool doPack() override;
+
+private:
+    Fit m_fit;
+};
+
+/// Allocates the given objects in the order GreedyPacker uses and returns those that did not fit.
+/// Once the packer is stopped, or with stopAtFailure after the first object that did not fit, the
+/// remaining objects are returned without trying them.
+auto allocateGreedily(const Packer& packer, FreeSpace& space, std::vector<LinkObject*> objects,
+                      GreedyPacker::Fit fit, bool stopAtFailure) -> std::vector<LinkObject*>;
+
+} // namespace kaizo::data
@@ -4,6 +4,7 @@
 #include <kaizo/addresses/Address.h>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 namespace kaizo::data {
@@ -23,13 +24,31 @@ public:
     void unsetAllocation();
     bool hasAllocation() const;
     auto allocation() const -> const Allocation&;
+    /// Checks whether the object is allocated where its constraints allow.
+    bool isSatisfied() const;
 
     void setFixedAddress(const Address address);
     bool hasFixedAddress() const;
+    /// Adds a constraint; an object with several constraints must satisfy all of them.
     void constrain(std::unique_ptr<Constraint>&& constraint);
+    /// Keeps the object within the same segment as another object. Both objects are constrained,
+    /// so whichever is allocated first restricts the other.
+    void constrainSameSegment(LinkObject& other, size_t segmentSize);
+    /// Keeps the object's address minus the other object's address within [minimum, maximum].
+    /// Both objects are constrained, so whichever is allocated first restricts the other.
+    void constrainRelative(LinkObject& other, int64_t minimum, int64_t maximum);
     bool isConstrained() const;
     bool isUnconstrained() const;
 
+    /// Copies the object and its constraints, but not its allocation.
+    auto copy() const -> std::unique_ptr<LinkObject>;
+    void rebind(const std::unordered_map<const LinkObject*, const LinkObject*>& copies);
+
+    /// Returns where the object may be allocated given its constraints, see Constraint.
+    auto placement() const -> std::optional<Placement>;
+    /// Returns the objects whose allocations the object's placement depends on.
+    auto references() const -> std::vector<const LinkObject*>;
+
     auto findAllocations(const FreeSpace& space) const -> std::vector<Allocation>;
     bool hasAllocations(const FreeSpace& space) const;
     auto measureSlack(const FreeSpace& space) const -> size_t;
@@ -37,7 +56,6 @@ public:
 private:
     std::string m_id;
     const size_t m_size;
-    bool m_hasFixedAddress{false};
     std::optional<Allocation> m_allocation;
     std::unique_ptr<Constraint> m_constraint;
 };
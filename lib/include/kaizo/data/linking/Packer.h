@@ -1,19 +1,70 @@
 #pragma once
 
-#include "Target.h"
-#include <filesystem>
+#include "kaizo/data/linking/FreeSpace.h"
+#include "kaizo/data/linking/LinkObject.h"
+#include "kaizo/data/linking/Target.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace kaizo::data {
 
-class FreeBlock;
-class LinkObject;
-
+/// Allocates LinkObjects in the free blocks of one or more targets.
 class Packer
 {
 public:
-    virtual void addFreeBlock(const FreeBlock& block) = 0;
-    virtual void addObject(LinkObject* object) = 0;
-    virtual bool pack() = 0;
+    virtual ~Packer() = default;
+
+    void setFreeBlocks(std::vector<FreeBlock>&& blocks);
+    void addFreeBlock(const FreeBlock& block);
+    /// Adds the free blocks of the target, returning the number allocations refer to it by.
+    auto addTarget(const Target& target) -> size_t;
+    void addObject(std::unique_ptr<LinkObject>&& object);
+    auto object(const size_t index) const -> LinkObject*;
+    auto objectCount() const -> size_t;
+    auto freeSpace() const -> const FreeSpace&;
+
+    /// Copies the free blocks and the (unallocated) objects of another packer, including
+    /// constraints between objects.
+    void copyProblem(const Packer& other);
+    /// Takes over the allocations of a packer that packed a copy of this problem.
+    void adoptAllocations(const Packer& other);
+
+    /// Makes packing fail once the given time has passed since pack() was called.
+    void setTimeLimit(std::chrono::milliseconds limit);
+    /// Makes packing fail as soon as possible; may be called from another thread.
+    void cancel();
+    /// Also stops packing when the given packer is stopped.
+    void setParent(const Packer* parent);
+    bool isStopped() const;
+
+    /// Allocates every object, returning whether this succeeded.
+    bool pack();
+    /// Checks that every object is allocated where its constraints allow.
+    bool isSolved() const;
+    /// Checks that the allocated objects constrained relative to the given one still satisfy their
+    /// constraints, which the object's own placement does not take into account.
+    bool satisfiesDependents(const LinkObject& object) const;
+
+protected:
+    virtual bool doPack() = 0;
+
+    FreeSpace m_freeSpace;
+    std::vector<std::unique_ptr<LinkObject>> m_linkObjects;
+    size_t m_objectSize{0};
+
+private:
+    /// Targets without free blocks still take up a number.
+    size_t m_targetCount{0};
+    std::optional<std::chrono::milliseconds> m_timeLimit;
+    std::optional<std::chrono::steady_clock::time_point> m_deadline;
+    std::atomic<bool> m_isCancelled{false};
+    const Packer* m_parent{nullptr};
+    /// The objects constrained relative to each object, collected when packing starts.
+    std::unordered_map<const LinkObject*, std::vector<const LinkObject*>> m_dependents;
 };
 
-} // namespace kaizo::data
\ No newline at end of file
+} // namespace kaizo::data
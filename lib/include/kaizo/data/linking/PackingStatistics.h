@@ -0,0 +1,97 @@
+#pragma once
+
+#include "kaizo/data/linking/FreeSpace.h"
+#include "kaizo/data/linking/LinkObject.h"
+#include <chrono>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace kaizo::data {
+
+/// Counts values by powers of two: bucket 0 counts zeros, bucket i the values in [2^(i-1), 2^i).
+class Histogram
+{
+public:
+    void add(size_t value);
+    void clear();
+
+    auto buckets() const -> const std::vector<size_t>&;
+    auto count() const -> size_t;
+    auto maximum() const -> size_t;
+
+private:
+    std::vector<size_t> m_buckets;
+    size_t m_count{0};
+    size_t m_maximum{0};
+};
+
+/// Adds the time spent in its scope to the given duration; does not read the clock if that is
+/// null.
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(std::chrono::nanoseconds* total);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    auto operator=(const ScopedTimer&) -> ScopedTimer& = delete;
+
+private:
+    std::chrono::nanoseconds* m_total;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/// The state of the free space after some number of steps.
+struct FragmentationSample
+{
+    size_t step;
+    size_t blockCount;
+    size_t capacity;
+    size_t largestBlock;
+};
+
+/// What a packer did during the last pack(), to find out why packing is slow.
+struct PackingStatistics
+{
+    /// Candidate allocations that were tried.
+    size_t steps{0};
+    /// Allocations that were undone because forward checking failed.
+    size_t rejections{0};
+    size_t backtracks{0};
+    size_t maximumDepth{0};
+    size_t greedyAllocations{0};
+    /// Searches that were started over after the greedy allocations left no room.
+    size_t restarts{0};
+
+    /// The number of candidate allocations findAllocations() returned.
+    Histogram candidateCounts;
+    /// The depths that backtracking returned to.
+    Histogram backtrackDepths;
+
+    std::chrono::nanoseconds totalTime{0};
+    /// Only measured if profiling is enabled.
+    std::chrono::nanoseconds findAllocationsTime{0};
+    std::chrono::nanoseconds canBeSatisfiedTime{0};
+    std::chrono::nanoseconds greedyTime{0};
+
+    /// How often each object ran out of candidate allocations, making the search backtrack.
+    std::unordered_map<const LinkObject*, size_t> exhaustedObjects;
+    /// Samples at regular steps; the interval doubles whenever there are too many samples.
+    std::vector<FragmentationSample> fragmentation;
+
+    void clear();
+    /// Counts a step, sampling the fragmentation of the given free space if one is due.
+    void addStep(const FreeSpace& space);
+    void sampleFragmentation(const FreeSpace& space);
+    /// Returns the objects that ran out of allocations most often, most often first.
+    auto mostExhaustedObjects(size_t count) const
+        -> std::vector<std::pair<const LinkObject*, size_t>>;
+
+private:
+    static constexpr size_t MaximumSampleCount = 256;
+
+    size_t m_sampleInterval{1};
+};
+
+} // namespace kaizo::data
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "kaizo/data/linking/FreeSpace.h"
+#include "kaizo/data/linking/LinkObject.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace kaizo::data {
+
+enum class TraceLevel : uint8_t
+{
+    /// Nothing is recorded.
+    Off,
+    /// The start and the outcome of every search.
+    Outcome,
+    /// Every allocation, deallocation and backtracking step as well.
+    Search,
+};
+
+/// Records packing events to a file in a compact binary format, without making the packer wait
+/// for the file: events are put into a lock-free ring buffer that a background thread writes out.
+/// Events that do not fit into the buffer because the writer falls behind are dropped and only
+/// counted. Recording an event whose level is not enabled only compares the levels.
+///
+/// The file starts with the magic "KZPTRACE", the format version and the level as 32-bit integers,
+/// the free blocks (their number, then offset and size of each as 64-bit integers) and the objects
+/// (their number, then size as 64-bit integer, and length and bytes of the id of each). Every event
+/// after that takes 24 bytes: the nanoseconds since the trace was opened and the value as 64-bit
+/// integers, the index of the object (or all bits set) as 32-bit integer, the kind and three zero
+/// bytes. All integers are little endian.
+class PackingTrace
+{
+public:
+    enum class EventKind : uint8_t
+    {
+        /// A search starts; the value is the number of objects to allocate.
+        Start,
+        /// The value is the offset the object was allocated at.
+        Allocated,
+        /// Forward checking undid the allocation at the offset given by the value.
+        Rejected,
+        Deallocated,
+        /// The search returned to the depth given by the value.
+        Backtracked,
+        Solved,
+        /// Every allocation was tried.
+        Exhausted,
+        /// The time limit or the step limit was reached, or packing was cancelled.
+        Stopped,
+        /// The objects are larger than the free space.
+        NoSpace,
+        /// The value is the number of events that were dropped.
+        Dropped,
+    };
+
+    static constexpr uint32_t Version = 1;
+    static constexpr uint32_t NoObject = ~uint32_t{0};
+
+    PackingTrace() = default;
+    ~PackingTrace();
+    PackingTrace(const PackingTrace&) = delete;
+    auto operator=(const PackingTrace&) -> PackingTrace& = delete;
+
+    /// Starts recording the events up to the given level, writing the free blocks and the objects
+    /// first. Closes a trace that is still open.
+    void open(const std::filesystem::path& path, TraceLevel level, const FreeSpace& space,
+              const std::vector<std::unique_ptr<LinkObject>>& objects);
+    /// Writes the remaining events and stops recording.
+    void close();
+
+    bool isEnabled(TraceLevel level) const
+    {
+        return level <= m_level;
+    }
+
+    void record(TraceLevel level, EventKind kind, const LinkObject* object = nullptr,
+                uint64_t value = 0)
+    {
+        if (isEnabled(level))
+        {
+            push(kind, object, value);
+        }
+    }
+
+private:
+    struct Event
+    {
+        uint64_t time;
+        uint64_t value;
+        uint32_t object;
+        EventKind kind;
+    };
+
+    static constexpr size_t Capacity = 1 << 16;
+
+    void push(EventKind kind, const LinkObject* object, uint64_t value);
+    void writeEvents();
+
+    TraceLevel m_level{TraceLevel::Off};
+    std::ofstream m_file;
+    std::unordered_map<const LinkObject*, uint32_t> m_indices;
+    std::chrono::steady_clock::time_point m_start;
+
+    // written by the packer only
+    std::vector<Event> m_events;
+    std::atomic<size_t> m_head{0};
+    size_t m_dropped{0};
+    // written by the writer only
+    std::atomic<size_t> m_tail{0};
+
+    std::atomic<bool> m_isClosing{false};
+    std::thread m_writer;
+};
+
+} // namespace kaizo::data
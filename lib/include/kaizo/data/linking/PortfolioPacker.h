@@ -0,0 +1,50 @@
+#pragma once
+
+#include "kaizo/data/linking/Packer.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace kaizo::data {
+
+/// Races several packers on copies of the problem, e.g. greedy packers and backtracking packers
+/// with different scoring strategies. The first one to succeed stops all others; of those that
+/// succeeded by then, the solution with the highest score is used. Only solutions that satisfy all
+/// constraints count as a success.
+class PortfolioPacker : public Packer
+{
+public:
+    using Strategy = std::function<std::unique_ptr<Packer>()>;
+    using SolutionScore = std::function<long long(const FreeSpace&)>;
+
+    /// Starts out with greedy, backtracking and randomly restarting strategies.
+    PortfolioPacker();
+
+    void addStrategy(const std::string& name, Strategy strategy);
+    void clearStrategies();
+    auto strategyCount() const -> size_t;
+    /// Scores the free space a solution leaves; defaults to the size of the largest free block.
+    void setSolutionScore(SolutionScore score);
+    /// Sets the number of strategies to run at the same time; 0 uses all hardware threads.
+    void setThreadCount(size_t threadCount);
+    /// Returns the name of the strategy whose solution was used.
+    auto winner() const -> const std::string&;
+
+protected:
+    bool doPack() override;
+
+private:
+    struct NamedStrategy
+    {
+        std::string name;
+        Strategy strategy;
+    };
+
+    std::vector<NamedStrategy> m_strategies;
+    SolutionScore m_solutionScore;
+    size_t m_threadCount{0};
+    std::string m_winner;
+};
+
+} // namespace kaizo::data
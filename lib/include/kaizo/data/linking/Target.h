@@ -1,22 +1,24 @@
 #pragma once
 
-#include "FreeBlock.h"
-#include <filesystem>
-#include <fuse/addresses/AddressMap.h>
+#include "kaizo/data/linking/FreeBlock.h"
+#include <kaizo/addresses/AddressMap.h>
+#include <memory>
+#include <string>
+#include <vector>
 
-namespace fuse {
+namespace kaizo::data {
 
+/// A file that objects are linked into, e.g. a ROM or one of its overlays. The address map maps
+/// offsets within the file to the addresses they are loaded to.
 class Target
 {
 public:
-    explicit Target(const std::string& id, std::shared_ptr<AddressMap> addressMap = nullptr);
+    explicit Target(const std::string& id, std::shared_ptr<const AddressMap> addressMap);
 
     auto id() const -> const std::string&;
-    void setPath(const std::filesystem::path& path);
-    auto path() const -> const std::filesystem::path&;
-    void setOutputPath(const std::filesystem::path& path);
-    auto outputPath() const -> const std::filesystem::path&;
-    void mapFreeBlock(const FreeBlock& block);
+    auto addressMap() const -> const AddressMap&;
+    /// Adds the free range at the given offset, which must be mapped to an address.
+    void addFreeBlock(size_t offset, size_t size);
     auto freeBlockCount() const -> size_t;
     auto freeBlock(size_t index) const -> const FreeBlock&;
     bool coversAddress(const Address address) const;
@@ -24,10 +26,8 @@ public:
 
 private:
     std::string m_id;
-    std::filesystem::path m_fileName;
-    std::filesystem::path m_outputPath;
-    std::shared_ptr<AddressMap> m_addressMap;
+    std::shared_ptr<const AddressMap> m_addressMap;
     std::vector<FreeBlock> m_freeBlocks;
 };
 
-} // namespace fuse
\ No newline at end of file
+} // namespace kaizo::data
@@ -12,6 +12,7 @@ namespace kaizo::data {
 class AnnotatedBinary
 {
     friend class AnnotatedBinaryDeserializer;
+    friend class AnnotatedBinaryFile;
 
 public:
     // in-flight object construction
@@ -21,6 +22,9 @@ public:
     auto binary() -> Binary&;
     auto binary() const -> const Binary&;
     void skip(size_t size);
+    /// Aligns the current object to (a multiple of) the given alignment and skips to the next
+    /// offset within it that is aligned if the object is.
+    void align(size_t alignment);
     void addUnresolvedReference(const std::shared_ptr<AddressLayout>& format,
                                 const DataPath& destination);
     void setFixedOffset(const size_t offset);
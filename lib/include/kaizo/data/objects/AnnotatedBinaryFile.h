@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <kaizo/binary/BinaryView.h>
+#include <kaizo/utilities/MappedFile.h>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace kaizo {
+class AddressLayout;
+}
+
+namespace kaizo::data {
+
+class AnnotatedBinary;
+
+/// A compact container for an AnnotatedBinary: fixed-size tables of objects, sections, unresolved
+/// references and address layouts, followed by paths and the raw bytes of all objects. The tables
+/// are accessed in place in a read-only mapping of the file. The file uses the byte order of the
+/// machine that saved it, so it is meant for caching, not for distribution.
+class AnnotatedBinaryFile
+{
+public:
+    struct ObjectEntry
+    {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t realSize;
+        uint64_t alignment;
+        uint64_t fixedOffset;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+        uint32_t firstSection;
+        uint32_t sectionCount;
+        uint32_t firstReference;
+        uint32_t referenceCount;
+        uint32_t hasFixedOffset;
+        uint32_t reserved;
+    };
+
+    struct SectionEntry
+    {
+        uint64_t offset;
+        uint64_t realOffset;
+        uint64_t size;
+    };
+
+    struct ReferenceEntry
+    {
+        uint64_t offset;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+        uint32_t layout;
+        uint32_t reserved;
+    };
+
+    struct LayoutEntry
+    {
+        enum Kind : uint32_t
+        {
+            Relative,
+            Mips,
+        };
+
+        Kind kind;
+        uint32_t hasBase;
+        uint64_t base;
+        uint32_t sizeInBytes;
+        uint8_t isSigned;
+        uint8_t isBigEndian;
+        uint8_t hasNullPointer;
+        uint8_t reserved;
+        int64_t nullOffset;
+        uint64_t nullAddress;
+        int32_t offsetHi16;
+        int32_t offsetLo16;
+    };
+
+    static void save(const AnnotatedBinary& binary, const std::filesystem::path& filename);
+
+    explicit AnnotatedBinaryFile(const std::filesystem::path& filename);
+
+    auto objectCount() const -> size_t;
+    auto object(size_t index) const -> const ObjectEntry&;
+    auto path(const ObjectEntry& object) const -> std::string_view;
+    /// The packed bytes of the object.
+    auto binary(const ObjectEntry& object) const -> BinaryView;
+    auto sections(const ObjectEntry& object) const -> std::span<const SectionEntry>;
+    auto references(const ObjectEntry& object) const -> std::span<const ReferenceEntry>;
+    auto path(const ReferenceEntry& reference) const -> std::string_view;
+    auto layoutCount() const -> size_t;
+    auto makeLayout(size_t index) const -> std::unique_ptr<AddressLayout>;
+
+    /// Copies the objects into an AnnotatedBinary, e.g. to link them.
+    auto load() const -> std::unique_ptr<AnnotatedBinary>;
+
+private:
+    struct Header;
+
+    void validate() const;
+    template <class T> auto table(uint64_t offset, size_t count) const -> std::span<const T>;
+    auto string(uint32_t offset, uint32_t length) const -> std::string_view;
+
+    MappedFile m_file;
+    const Header* m_header{nullptr};
+    std::span<const ObjectEntry> m_objects;
+    std::span<const SectionEntry> m_sections;
+    std::span<const ReferenceEntry> m_references;
+    std::span<const LayoutEntry> m_layouts;
+};
+
+} // namespace kaizo::data
@@ -1,8 +1,14 @@
+#pragma once
+
+#include <kaizo/data/DataPath.h>
 #include <kaizo/data/data/Data.h>
 #include <kaizo/data/serialization/Serialization.h>
+#include <string_view>
 
 namespace kaizo::data {
 
+class CsvWriter;
+
 class CsvSerialization : public DataSerialization
 {
 public:
@@ -11,18 +17,20 @@ public:
         -> std::unique_ptr<Data> override;
 
 private:
-    void decodePath(const std::string& path);
-    void decodeType(const std::string& type);
-    void decodeValue(std::string&& value);
+    void decodePath(std::string_view path);
+    void decodeType(std::string_view type);
+    void decodeValue(std::string_view value);
 
     void serializeData(const Data& data);
     void serializeRecord(const Data& data);
     void serializeArray(const Data& data);
     void serializeInteger(const Data& integer);
     void serializeString(const Data& string);
-    void outputRow(DataType type, const std::string& value);
+    void outputRow(DataType type, std::string_view value);
 
-    std::ofstream* m_output;
+    CsvWriter* m_output;
+    /// The path of the data being serialized, formatted like DataPath::toString().
+    std::string m_outputPath;
 
     void process(Data* data, size_t pathIndex);
     void processRoot();
@@ -36,9 +44,9 @@ private:
     auto makeNext(size_t pathIndex) -> std::unique_ptr<Data>;
 
     std::unique_ptr<Data> m_root;
-    DataPath m_currentPath;
+    std::vector<DataPathElement> m_currentPath;
     DataType m_currentType;
-    std::string m_currentValue;
+    std::string_view m_currentValue;
 };
 
 } // namespace kaizo::data
\ No newline at end of file
@@ -18,6 +18,8 @@ public:
     Tile() = default;
     Tile(const Tile& other) = default;
     Tile(Tile&& other) = default;
+    auto operator=(const Tile& other) -> Tile& = default;
+    auto operator=(Tile&& other) -> Tile& = default;
     explicit Tile(const size_t width, const size_t height, const PixelFormat format);
 
     auto width() const -> size_t;
@@ -39,13 +41,15 @@ public:
     auto pixel(const size_t index) const -> pixel_t;
     auto data() const -> const pixel_t*;
     auto dataSize() const -> size_t;
+    auto row(const size_t y) const -> const pixel_t*;
+    auto row(const size_t y) -> pixel_t*;
 
 private:
     auto offset(const size_t x, const size_t y) const -> size_t;
 
-    const size_t m_width{0};
-    const size_t m_height{0};
-    const PixelFormat m_format{PixelFormat::rgba()};
+    size_t m_width{0};
+    size_t m_height{0};
+    PixelFormat m_format{PixelFormat::rgba()};
     std::vector<pixel_t> m_data;
 };
 
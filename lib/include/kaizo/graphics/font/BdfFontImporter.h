@@ -0,0 +1,36 @@
+#pragma once
+
+#include <filesystem>
+#include <kaizo/graphics/Tile.h>
+#include <string>
+#include <vector>
+
+namespace kaizo {
+
+class Font;
+
+/// Imports fonts in the Glyph Bitmap Distribution Format (BDF) into indexed glyphs.
+class BdfFontImporter
+{
+public:
+    /// Quantizes the font's pixels to indices of the given bit depth. Unless a ramp is given,
+    /// intensities map linearly onto [0, 2^bitsPerPixel - 1] with 0 being the background.
+    /// Otherwise, they are mapped linearly onto the ramp's entries, with the first entry being
+    /// the background.
+    void setBitsPerPixel(unsigned bitsPerPixel);
+    void setRamp(const std::vector<Tile::pixel_t>& ramp);
+    void setThreadCount(size_t threads);
+
+    auto load(const std::filesystem::path& filename) const -> Font;
+    auto parse(const std::string& source) const -> Font;
+
+private:
+    auto quantize(unsigned intensity, unsigned sourceBitsPerPixel) const -> Tile::pixel_t;
+    auto background() const -> Tile::pixel_t;
+
+    unsigned m_bitsPerPixel{4};
+    std::vector<Tile::pixel_t> m_ramp;
+    size_t m_threadCount{0};
+};
+
+} // namespace kaizo
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "Glyph.h"
+#include <kaizo/graphics/PixelFormat.h>
 #include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace kaizo {
@@ -20,6 +23,8 @@ public:
     auto baseLine() const -> size_t;
     auto backgroundColor() const -> Glyph::pixel_t;
     void setBackgroundColor(Glyph::pixel_t color);
+    auto pixelFormat() const -> PixelFormat;
+    void setPixelFormat(const PixelFormat format);
 
     void addGlyph(const Glyph& glyph);
     auto glyphCount() const -> size_t;
@@ -29,12 +34,16 @@ public:
     auto findStartingWith(const std::string& characters) const -> std::vector<size_t>;
     auto findLongestMatch(const std::string& string, size_t index) const -> std::optional<size_t>;
     auto toGlyphs(const std::string& string) const -> std::vector<std::optional<size_t>>;
+    /// Returns a font consisting of the glyphs for the given characters, in the given order.
+    auto subset(const std::vector<std::string>& characters) const -> Font;
 
 private:
     std::vector<Glyph> m_characters;
-    Metrics m_metrics;
-    unsigned int m_bitsPerPixel{1};
+    std::unordered_map<std::string, size_t> m_characterIndex;
+    size_t m_longestCharacters{0};
+    Metrics m_metrics{0, 0};
+    PixelFormat m_pixelFormat{PixelFormat::rgba()};
     Glyph::pixel_t m_backgroundColor{0};
 };
 
-} // namespace kaizo
\ No newline at end of file
+} // namespace kaizo
@@ -1,12 +1,12 @@
 #pragma once
 
-#include <fuse/Rectangle.h>
+#include <kaizo/graphics/Tile.h>
+#include <kaizo/utilities/Rectangle.h>
 #include <string>
 #include <vector>
 
-namespace fuse::graphics {
+namespace kaizo {
 
-class Image;
 class Font;
 
 class FontWriter
@@ -37,21 +37,41 @@ public:
 
     void setFont(const Font* font);
     void setAlignment(Alignment alignment);
+    void setThreadCount(size_t threads);
 
     void setCharacterSpacing(CharacterSpacing spacing);
     void setMonospace(size_t characterWidth);
     void setProportional();
 
-    void write(const std::string& text, Image& image, size_t x, size_t y,
+    /// Draws all non-background pixels of the text's glyphs into the tile; pixels outside of the
+    /// tile are clipped.
+    void write(const std::string& text, Tile& tile, long long x, long long y,
                Anchor anchor = Anchor::BaselineLeft) const;
-    auto width(const std::string& text) -> size_t;
-    auto height(const std::string& text) -> size_t;
-    auto boundingBox(const std::string& text) -> BitmapRegion;
+    /// Renders the text into a new tile just large enough to hold it.
+    auto render(const std::string& text) const -> Tile;
+    /// Renders the text into a new tile of the given size, horizontally aligned according to the
+    /// current alignment.
+    auto render(const std::string& text, size_t width, size_t height) const -> Tile;
+    auto renderAll(const std::vector<std::string>& texts) const -> std::vector<Tile>;
+    auto renderAll(const std::vector<std::string>& texts, size_t width, size_t height) const
+        -> std::vector<Tile>;
+
+    auto width(const std::string& text) const -> size_t;
+    auto height(const std::string& text) const -> size_t;
+    auto boundingBox(const std::string& text) const -> BitmapRegion;
 
 private:
+    auto toGlyphs(const std::string& text) const -> std::vector<size_t>;
+    auto advance(size_t glyph) const -> size_t;
+    auto width(const std::vector<size_t>& glyphs) const -> size_t;
+    void draw(const std::vector<size_t>& glyphs, Tile& tile, long long x, long long baseline) const;
+    auto makeCanvas(size_t width, size_t height) const -> Tile;
+
     Alignment m_alignment{Alignment::Left};
     CharacterSpacing m_characterSpacing{CharacterSpacing::Proportional};
+    size_t m_monospaceWidth{0};
+    size_t m_threadCount{0};
     const Font* m_font{nullptr};
 };
 
-} // namespace fuse::graphics
\ No newline at end of file
+} // namespace kaizo
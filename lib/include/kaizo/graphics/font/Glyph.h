@@ -1,8 +1,10 @@
 #pragma once
 
-#include <fuse/Rectangle.h>
-#include <kaizo/graphics/tiles/Tile.h>
+#include <kaizo/graphics/Tile.h>
+#include <kaizo/utilities/Rectangle.h>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace kaizo {
 
@@ -13,12 +15,21 @@ class Glyph
 public:
     using pixel_t = Tile::pixel_t;
 
+    /// A horizontal run of non-background pixels within one row of the glyph.
+    struct Span
+    {
+        uint32_t x;
+        uint32_t y;
+        uint32_t length;
+    };
+
     auto width() const -> size_t;
     auto height() const -> size_t;
     auto baseline() const -> size_t;
     auto ascent() const -> size_t;
     auto descent() const -> size_t;
     auto advanceWidth() const -> size_t;
+    auto xOffset() const -> long long;
 
     auto characters() const -> const std::string&;
     auto backgroundColor() const -> pixel_t;
@@ -26,12 +37,17 @@ public:
     auto boundingBox() const -> TileRegion;
     auto pixel(size_t x, size_t y) const -> pixel_t;
     auto operator()(size_t x, size_t y) const -> pixel_t;
+    auto tile() const -> const Tile&;
+    auto spans() const -> const std::vector<Span>&;
 
 private:
     std::string m_characters;
     Tile m_tile;
-    pixel_t m_background;
-    size_t m_baseline;
+    pixel_t m_background{0};
+    size_t m_baseline{0};
+    size_t m_advanceWidth{0};
+    long long m_xOffset{0};
+    std::vector<Span> m_spans;
 };
 
 class GlyphBuilder
@@ -42,17 +58,23 @@ public:
     auto characters(const std::string& characters) -> GlyphBuilder&;
     auto data(const Tile& tile) -> GlyphBuilder&;
     auto shrinkToFit(bool shrink = true) -> GlyphBuilder&;
+    auto advanceWidth(size_t width) -> GlyphBuilder&;
+    auto xOffset(long long offset) -> GlyphBuilder&;
     auto build() -> Glyph;
 
 private:
     void validate();
     void shrink();
+    auto computeSpans() const -> std::vector<Glyph::Span>;
 
     bool m_shrinkToFit{false};
-    size_t m_baseline;
+    size_t m_baseline{0};
     Tile m_data;
     std::string m_characters;
     Glyph::pixel_t m_backgroundColor{0};
+    std::optional<size_t> m_advanceWidth;
+    long long m_xOffset{0};
+    size_t m_shrunkLeft{0};
 };
 
-} // namespace kaizo
\ No newline at end of file
+} // namespace kaizo
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <kaizo/binary/Binary.h>
+
+namespace kaizo {
+
+class Font;
+class TileFormat;
+
+/// Places every glyph of the font into a cell of the given size (aligned to the font's baseline)
+/// and encodes the cells consecutively using the given tile format.
+auto packGlyphs(const Font& font, TileFormat& format, size_t cellWidth, size_t cellHeight)
+    -> Binary;
+
+} // namespace kaizo
@@ -47,6 +47,8 @@ public:
     bool hasControl(const std::string& label) const;
     auto control(const std::string& label) const -> std::optional<EntryReference>;
     auto entry(size_t index) const -> EntryReference;
+    auto find(const BinarySequence& binary) const -> std::optional<EntryReference>;
+    auto entries() const -> std::vector<EntryReference>;
 
     void insert(const BinarySequence& binary, const TableEntry& text);
 
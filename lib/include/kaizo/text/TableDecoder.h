@@ -38,14 +38,8 @@ public:
     void setFixedLength(size_t length);
     void unsetFixedLength();
 
-    auto decode(const BinaryView& binary, size_t offset) -> std::pair<size_t, std::string>;
-
-    auto decodeControl(const TableEntry& control) -> std::string;
-    auto decodeText(const TableEntry& text) -> std::string;
-    auto decodeEnd(const TableEntry& end) -> std::string;
-    auto decodeTableSwitch(const TableEntry& tableSwitch) -> std::string;
-    auto decodeArgument(const TableEntry::ParameterFormat& format) -> std::string;
-    auto decodeHook(const TableEntry& hook) -> std::string;
+    /// Decoding keeps its state on the stack, so a decoder can be shared between threads.
+    auto decode(const BinaryView& binary, size_t offset) const -> std::pair<size_t, std::string>;
 
 private:
     size_t m_activeTable{0};
@@ -54,12 +48,23 @@ private:
 
     std::map<std::string, HookHandler*> m_hooks;
 
-    auto data() const -> const uint8_t*;
-    void advance(size_t size);
-    auto remaining() const -> size_t;
+    struct Cursor
+    {
+        const BinaryView& binary;
+        size_t offset;
+        size_t activeTable;
+
+        auto data() const -> const uint8_t*;
+        void advance(size_t size);
+    };
 
-    const BinaryView* m_binary{nullptr};
-    size_t m_offset{0};
+    auto decodeControl(Cursor& cursor, const TableEntry& control) const -> std::string;
+    auto decodeText(const TableEntry& text) const -> std::string;
+    auto decodeEnd(const TableEntry& end) const -> std::string;
+    auto decodeTableSwitch(Cursor& cursor, const TableEntry& tableSwitch) const -> std::string;
+    auto decodeArgument(Cursor& cursor, const TableEntry::ParameterFormat& format) const
+        -> std::string;
+    auto decodeHook(Cursor& cursor, const TableEntry& hook) const -> std::string;
 };
 
 } // namespace kaizo
\ No newline at end of file
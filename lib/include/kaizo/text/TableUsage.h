@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Table.h"
+#include <kaizo/binary/Binary.h>
+#include <kaizo/binary/BinaryView.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace kaizo {
+
+/// Counts how often the entries of a table are used to encode a corpus and derives a subset of the
+/// table that only contains the used entries.
+class TableUsage
+{
+public:
+    explicit TableUsage(const Table& table);
+
+    void setThreadCount(size_t threads);
+
+    /// Maps all texts in one parallel pass and adds the used entries to the histogram.
+    void analyze(const std::vector<std::string>& corpus);
+
+    auto count(const Table::EntryReference& entry) const -> size_t;
+    /// Returns all used entries, most frequently used first.
+    auto histogram() const -> std::vector<std::pair<Table::EntryReference, size_t>>;
+
+    /// Reassigns the binary sequences of the original text entries to the used text entries, the
+    /// most frequently used entry receiving the shortest and smallest one. Other entries keep their
+    /// binary sequences.
+    auto remapping() const -> std::map<BinarySequence, BinarySequence>;
+    auto makeSubsetTable() const -> Table;
+    /// Returns the texts of the used text entries in the order of their new binary sequences.
+    auto usedTexts() const -> std::vector<std::string>;
+    /// Re-encodes text that was encoded with the original table to use the subset table. Throws if
+    /// the text contains a text entry that was not used by the analyzed corpus.
+    auto remap(const BinaryView& binary, size_t offset, size_t size) const -> Binary;
+
+private:
+    auto usedTextEntries() const -> std::vector<Table::EntryReference>;
+
+    Table m_table;
+    std::map<BinarySequence, size_t> m_counts;
+    size_t m_threadCount{0};
+};
+
+} // namespace kaizo
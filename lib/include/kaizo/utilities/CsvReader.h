@@ -1,8 +1,12 @@
 #pragma once
 
+#include <deque>
 #include <filesystem>
+#include <kaizo/utilities/MappedFile.h>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace kaizo::data {
@@ -12,27 +16,37 @@ class CsvReader
 public:
     CsvReader() = default;
     explicit CsvReader(const std::filesystem::path& filename);
+    /// Reads CSV from memory; the text must outlive the reader.
+    explicit CsvReader(std::string_view text);
 
     void setColumnName(size_t index, const std::string& name);
     bool hasColumnName(size_t index) const;
     auto columnName(size_t index) const -> const std::string&;
 
-    auto nextRow() -> std::optional<std::vector<std::string>>;
+    /// Returns the columns of the next row; they point into the file's mapping (or into the reader
+    /// for columns with escaped quotes) and are only valid until the next call.
+    auto nextRow() -> std::optional<std::span<const std::string_view>>;
 
 private:
-    auto nextColumn() -> std::string;
-    auto parseQuoted() -> std::string;
-    auto parseNotQuoted() -> std::string;
+    void setText(std::string_view text);
+    auto nextColumn() -> std::string_view;
+    auto parseQuoted() -> std::string_view;
+    auto parseNotQuoted() -> std::string_view;
+    auto unescape(std::string_view quoted) -> std::string_view;
 
     bool hasNext() const;
     auto fetch() const -> char;
     void consume();
 
-    std::unique_ptr<unsigned char[]> m_buffer;
+    MappedFile m_file;
+    std::string_view m_text;
     size_t m_position{0};
-    size_t m_size{0};
+
+    std::vector<std::string_view> m_row;
+    std::deque<std::string> m_unescaped;
+    size_t m_unescapedCount{0};
 
     std::vector<std::optional<std::string>> m_columnNames;
 };
 
-} // namespace kaizo::data
\ No newline at end of file
+} // namespace kaizo::data
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace kaizo::data {
+
+/// Writes CSV rows through a large buffer; columns are quoted when necessary.
+class CsvWriter
+{
+public:
+    explicit CsvWriter(const std::filesystem::path& filename);
+    CsvWriter(const CsvWriter&) = delete;
+    ~CsvWriter();
+
+    auto operator=(const CsvWriter&) -> CsvWriter& = delete;
+
+    /// Writes the column, enclosed in quotes if it contains a separator, a quote or a line break
+    /// (or if forced to); quotes within the column are doubled.
+    void column(std::string_view value, bool quoted = false);
+    void endRow();
+    void flush();
+
+private:
+    void write(std::string_view string);
+    void write(char c);
+
+    std::FILE* m_file{nullptr};
+    std::string m_buffer;
+    bool m_isFirstColumn{true};
+};
+
+} // namespace kaizo::data
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace kaizo {
+
+/// A read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& filename);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    auto operator=(const MappedFile&) -> MappedFile& = delete;
+    auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+
+    auto data() const -> const uint8_t*;
+    auto size() const -> size_t;
+
+private:
+    void unmap();
+
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+};
+
+} // namespace kaizo
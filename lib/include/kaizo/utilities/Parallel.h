@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kaizo {
+
+/// Returns the number of worker threads to use if none is given explicitly.
+inline auto defaultThreadCount() -> size_t
+{
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/// Calls function(i) for every i in [0, count) on up to threadCount threads.
+/// Indices are handed out in chunks; the first exception thrown by any call is rethrown on the
+/// calling thread after all workers have stopped.
+template <class Function>
+void parallelFor(size_t count, Function&& function, size_t threadCount = 0)
+{
+    if (threadCount == 0)
+    {
+        threadCount = defaultThreadCount();
+    }
+    threadCount = std::min(threadCount, count);
+    if (threadCount <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            function(i);
+        }
+        return;
+    }
+
+    auto const chunkSize = std::max<size_t>(1, count / (threadCount * 8));
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+
+    auto worker = [&]() {
+        while (!failed.load(std::memory_order_relaxed))
+        {
+            auto const begin = next.fetch_add(chunkSize, std::memory_order_relaxed);
+            if (begin >= count)
+            {
+                return;
+            }
+            auto const end = std::min(begin + chunkSize, count);
+            try
+            {
+                for (auto i = begin; i < end; ++i)
+                {
+                    function(i);
+                }
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock{exceptionMutex};
+                if (!exception)
+                {
+                    exception = std::current_exception();
+                }
+                failed = true;
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+} // namespace kaizo
@@ -116,6 +116,11 @@ void Binary::clear()
     m_data.clear();
 }
 
+void Binary::resize(size_t size)
+{
+    m_data.resize(size);
+}
+
 void Binary::append(uint8_t value)
 {
     m_data.push_back(value);
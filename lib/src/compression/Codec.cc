@@ -0,0 +1,58 @@
+#include <kaizo/compression/Codec.h>
+#include <kaizo/compression/LzCodecs.h>
+#include <kaizo/utilities/Parallel.h>
+#include <stdexcept>
+
+namespace kaizo {
+
+auto Codec::compressAll(const std::vector<BinaryView>& inputs, size_t threadCount) const
+    -> std::vector<Binary>
+{
+    // the inputs already keep every thread busy, so each one is compressed serially
+    auto codec = copy();
+    codec->setThreadCount(1);
+
+    std::vector<Binary> outputs(inputs.size());
+    parallelFor(
+        inputs.size(), [&](size_t i) { outputs[i] = codec->compress(inputs[i]); }, threadCount);
+    return outputs;
+}
+
+void Codec::setLevel(CompressionLevel level)
+{
+    m_level = level;
+}
+
+auto Codec::level() const -> CompressionLevel
+{
+    return m_level;
+}
+
+void Codec::setThreadCount(size_t threads)
+{
+    m_threadCount = threads;
+}
+
+auto Codec::threadCount() const -> size_t
+{
+    return m_threadCount;
+}
+
+auto makeCodec(const std::string& name) -> std::unique_ptr<Codec>
+{
+    if (name == "lz10")
+    {
+        return std::make_unique<Lz10Codec>();
+    }
+    else if (name == "lzss")
+    {
+        return std::make_unique<LzssCodec>();
+    }
+    else if (name == "yaz0")
+    {
+        return std::make_unique<Yaz0Codec>();
+    }
+    throw std::runtime_error{"Codec: unknown codec '" + name + "'"};
+}
+
+} // namespace kaizo
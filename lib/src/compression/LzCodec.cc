@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <contracts/Contracts.h>
+#include <kaizo/compression/LzCodecs.h>
+#include <kaizo/utilities/Parallel.h>
+#include <limits>
+
+namespace kaizo {
+
+namespace {
+
+constexpr size_t HashBits = 15;
+constexpr size_t BlockSize = 256 * 1024;
+constexpr size_t FastDepth = 16;
+constexpr size_t OptimalDepth = 256;
+/// Matches at least this long are taken as they are by the optimal parse.
+constexpr size_t NiceLength = 128;
+
+/// Finds the longest earlier occurrence within the window using hash chains over the first three
+/// bytes. Positions must be passed to find() or insert() exactly once, in increasing order.
+class MatchFinder
+{
+public:
+    MatchFinder(const BinaryView& input, size_t begin, size_t end, const LzParameters& parameters,
+                size_t depth)
+        : m_input{input}
+        , m_end{end}
+        , m_parameters{parameters}
+        , m_depth{depth}
+        , m_base{begin > parameters.window ? begin - parameters.window : 0}
+        , m_head(size_t{1} << HashBits, None)
+        , m_previous(end - m_base, None)
+    {
+        Expects(parameters.minLength >= 3);
+        for (auto position = m_base; position < begin; ++position)
+        {
+            insert(position);
+        }
+    }
+
+    auto find(size_t position) -> LzToken
+    {
+        LzToken best;
+        auto const limit = std::min(m_parameters.maxLength, m_end - position);
+        if (limit >= m_parameters.minLength)
+        {
+            auto const* data = m_input.data();
+            auto candidate = m_head[hash(position)];
+            for (auto depth = m_depth; candidate != None && depth > 0; --depth)
+            {
+                if (position - candidate > m_parameters.window)
+                {
+                    break;
+                }
+                if (data[candidate + best.length] == data[position + best.length])
+                {
+                    size_t length{0};
+                    while (length < limit && data[candidate + length] == data[position + length])
+                    {
+                        ++length;
+                    }
+                    if (length > best.length)
+                    {
+                        best.length = static_cast<uint16_t>(length);
+                        best.distance = static_cast<uint16_t>(position - candidate);
+                        if (length == limit)
+                        {
+                            break;
+                        }
+                    }
+                }
+                candidate = m_previous[candidate - m_base];
+            }
+            if (best.length < m_parameters.minLength)
+            {
+                best = {};
+            }
+        }
+        insert(position);
+        return best;
+    }
+
+    void insert(size_t position)
+    {
+        if (position + 3 <= m_input.size())
+        {
+            auto& head = m_head[hash(position)];
+            m_previous[position - m_base] = head;
+            head = position;
+        }
+    }
+
+private:
+    static constexpr size_t None = std::numeric_limits<size_t>::max();
+
+    auto hash(size_t position) const -> size_t
+    {
+        auto const* data = m_input.data() + position;
+        uint32_t const value = (data[0] << 16) | (data[1] << 8) | data[2];
+        return (value * 2654435761U) >> (32 - HashBits);
+    }
+
+    BinaryView m_input;
+    size_t m_end;
+    const LzParameters& m_parameters;
+    size_t m_depth;
+    size_t m_base;
+    std::vector<size_t> m_head;
+    std::vector<size_t> m_previous;
+};
+
+auto matchCost(const LzParameters& parameters, size_t length) -> size_t
+{
+    return length >= parameters.longMatchLength ? parameters.longMatchCost : parameters.matchCost;
+}
+
+/// Greedy parsing that defers a match by one literal if the next position has a longer one.
+auto parseFast(const BinaryView& input, size_t begin, size_t end, const LzParameters& parameters)
+    -> std::vector<LzToken>
+{
+    std::vector<LzToken> tokens;
+    MatchFinder finder{input, begin, end, parameters, FastDepth};
+    auto position = begin;
+    auto match = finder.find(position);
+    while (position < end)
+    {
+        if (match.length == 0)
+        {
+            tokens.push_back({});
+            if (++position < end)
+            {
+                match = finder.find(position);
+            }
+            continue;
+        }
+
+        auto const next = position + 1 < end ? finder.find(position + 1) : LzToken{};
+        if (next.length > match.length)
+        {
+            tokens.push_back({});
+            ++position;
+            match = next;
+            continue;
+        }
+
+        tokens.push_back(match);
+        for (auto skipped = position + 2; skipped < position + match.length; ++skipped)
+        {
+            finder.insert(skipped);
+        }
+        position += match.length;
+        if (position < end)
+        {
+            match = finder.find(position);
+        }
+    }
+    return tokens;
+}
+
+/// Finds the cheapest sequence of tokens by relaxing every literal and every match length
+/// (shorter matches reuse the distance of the longest) in order of position.
+auto parseOptimal(const BinaryView& input, size_t begin, size_t end,
+                  const LzParameters& parameters) -> std::vector<LzToken>
+{
+    auto const size = end - begin;
+    std::vector<size_t> cost(size + 1, std::numeric_limits<size_t>::max());
+    std::vector<LzToken> steps(size + 1);
+    cost[0] = 0;
+
+    MatchFinder finder{input, begin, end, parameters, OptimalDepth};
+    size_t skipUntil{0};
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (cost[i] + parameters.literalCost < cost[i + 1])
+        {
+            cost[i + 1] = cost[i] + parameters.literalCost;
+            steps[i + 1] = {};
+        }
+        if (i < skipUntil)
+        {
+            finder.insert(begin + i);
+            continue;
+        }
+
+        auto const match = finder.find(begin + i);
+        for (auto length = parameters.minLength; length <= match.length; ++length)
+        {
+            auto const matchedCost = cost[i] + matchCost(parameters, length);
+            if (matchedCost < cost[i + length])
+            {
+                cost[i + length] = matchedCost;
+                steps[i + length] = {static_cast<uint16_t>(length), match.distance};
+            }
+        }
+        if (match.length >= NiceLength)
+        {
+            skipUntil = i + match.length;
+        }
+    }
+
+    std::vector<LzToken> tokens;
+    for (auto i = size; i > 0; i -= std::max<size_t>(1, steps[i].length))
+    {
+        tokens.push_back(steps[i]);
+    }
+    std::reverse(tokens.begin(), tokens.end());
+    return tokens;
+}
+
+} // namespace
+
+auto LzCodec::compress(const BinaryView& input) const -> Binary
+{
+    return write(input, parse(input));
+}
+
+auto LzCodec::parse(const BinaryView& input) const -> std::vector<LzToken>
+{
+    auto const parseBlock = [&](size_t begin, size_t end) {
+        return level() == CompressionLevel::Fast ? parseFast(input, begin, end, parameters())
+                                                 : parseOptimal(input, begin, end, parameters());
+    };
+
+    if (threadCount() == 1 || input.size() <= BlockSize)
+    {
+        return parseBlock(0, input.size());
+    }
+
+    // matches only depend on the input, so blocks can be parsed independently while still
+    // referencing the preceding block; only matches crossing a block's end are lost
+    auto const blockCount = (input.size() + BlockSize - 1) / BlockSize;
+    std::vector<std::vector<LzToken>> blocks(blockCount);
+    parallelFor(
+        blockCount,
+        [&](size_t block) {
+            blocks[block] = parseBlock(block * BlockSize,
+                                       std::min(input.size(), (block + 1) * BlockSize));
+        },
+        threadCount());
+
+    std::vector<LzToken> tokens;
+    for (auto const& block : blocks)
+    {
+        tokens.insert(tokens.end(), block.begin(), block.end());
+    }
+    return tokens;
+}
+
+} // namespace kaizo
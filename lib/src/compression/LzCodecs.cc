@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <array>
+#include <kaizo/compression/LzCodecs.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace kaizo {
+
+namespace {
+
+class StreamReader
+{
+public:
+    StreamReader(const BinaryView& input, size_t offset, const char* codec)
+        : m_input{input}
+        , m_offset{offset}
+        , m_codec{codec}
+    {
+    }
+
+    bool atEnd() const
+    {
+        return m_offset >= m_input.size();
+    }
+
+    auto next() -> uint8_t
+    {
+        if (atEnd())
+        {
+            throw std::runtime_error{std::string{m_codec} + ": unexpected end of data"};
+        }
+        return m_input[m_offset++];
+    }
+
+    auto offset() const -> size_t
+    {
+        return m_offset;
+    }
+
+private:
+    BinaryView m_input;
+    size_t m_offset;
+    const char* m_codec;
+};
+
+/// Decodes the common structure of LZ10 and Yaz0 into an output of known size: groups of eight
+/// tokens preceded by a flag byte whose most significant bit belongs to the first token.
+template <class ReadMatch>
+auto decodeSized(StreamReader& reader, size_t size, bool isMatchFlag, const char* codec,
+                 ReadMatch&& readMatch) -> Binary
+{
+    Binary output{size};
+    auto* data = output.data();
+    size_t written{0};
+    while (written < size)
+    {
+        auto const flags = reader.next();
+        for (auto bit = 0x80; bit != 0 && written < size; bit >>= 1)
+        {
+            if (((flags & bit) != 0) != isMatchFlag)
+            {
+                data[written++] = reader.next();
+                continue;
+            }
+
+            auto const [length, distance] = readMatch(reader);
+            if (distance > written)
+            {
+                throw std::runtime_error{std::string{codec} + ": match precedes the data"};
+            }
+            auto const end = std::min(size, written + length);
+            for (; written < end; ++written)
+            {
+                data[written] = data[written - distance];
+            }
+        }
+    }
+    return output;
+}
+
+/// Writes tokens in groups of eight, each preceded by a flag byte whose most (or least)
+/// significant bit belongs to the first token.
+template <class WriteMatch>
+void encodeTokens(Binary& output, const BinaryView& input, const std::vector<LzToken>& tokens,
+                  bool isMatchFlag, bool isMsbFirst, WriteMatch&& writeMatch)
+{
+    size_t flagOffset{0};
+    size_t position{0};
+    for (size_t i = 0; i < tokens.size(); ++i)
+    {
+        auto const bit = i % 8;
+        if (bit == 0)
+        {
+            flagOffset = output.size();
+            output.append(uint8_t{0});
+        }
+
+        auto const& token = tokens[i];
+        if ((token.length > 0) == isMatchFlag)
+        {
+            output[flagOffset] |= static_cast<uint8_t>(isMsbFirst ? 0x80 >> bit : 1 << bit);
+        }
+        if (token.length == 0)
+        {
+            output.append(input[position++]);
+        }
+        else
+        {
+            writeMatch(output, token, position);
+            position += token.length;
+        }
+    }
+}
+
+constexpr size_t RingSize = 4096;
+constexpr size_t RingStart = RingSize - 18;
+
+} // namespace
+
+//##[ Lz10Codec ]##################################################################################
+
+auto Lz10Codec::decompress(const BinaryView& input) const -> std::pair<Binary, size_t>
+{
+    if (input.size() < 4 || input[0] != 0x10)
+    {
+        throw std::runtime_error{"Lz10Codec: not LZ10 data"};
+    }
+    auto const size = readLittle<3, size_t>(input, 1);
+
+    StreamReader reader{input, 4, "Lz10Codec"};
+    auto output = decodeSized(reader, size, true, "Lz10Codec", [](StreamReader& reader) {
+        auto const high = reader.next();
+        auto const low = reader.next();
+        return std::pair<size_t, size_t>{(high >> 4) + 3, (((high & 0x0F) << 8) | low) + 1};
+    });
+    return std::make_pair(std::move(output), reader.offset());
+}
+
+auto Lz10Codec::parameters() const -> const LzParameters&
+{
+    static const LzParameters parameters{.window = 4096, .maxLength = 18};
+    return parameters;
+}
+
+auto Lz10Codec::write(const BinaryView& input, const std::vector<LzToken>& tokens) const -> Binary
+{
+    if (input.size() > 0xFFFFFF)
+    {
+        throw std::runtime_error{"Lz10Codec: data exceeds 16 MiB"};
+    }
+
+    Binary output;
+    output.append(uint8_t{0x10});
+    output.appendLittle<3>(input.size());
+    encodeTokens(output, input, tokens, true, true,
+                 [](Binary& output, const LzToken& token, size_t) {
+                     auto const displacement = token.distance - 1;
+                     output.append(
+                         static_cast<uint8_t>(((token.length - 3) << 4) | (displacement >> 8)));
+                     output.append(static_cast<uint8_t>(displacement & 0xFF));
+                 });
+    return output;
+}
+
+auto Lz10Codec::copy() const -> std::unique_ptr<Codec>
+{
+    return std::make_unique<Lz10Codec>(*this);
+}
+
+//##[ LzssCodec ]##################################################################################
+
+LzssCodec::LzssCodec(uint8_t fillByte)
+    : m_fillByte{fillByte}
+{
+}
+
+auto LzssCodec::decompress(const BinaryView& input) const -> std::pair<Binary, size_t>
+{
+    std::array<uint8_t, RingSize> ring;
+    ring.fill(m_fillByte);
+    auto ringPosition = RingStart;
+
+    Binary output;
+    StreamReader reader{input, 0, "LzssCodec"};
+    unsigned flags{0};
+    while (true)
+    {
+        // the high byte counts the remaining flag bits
+        if (((flags >>= 1) & 0x100) == 0)
+        {
+            if (reader.atEnd())
+            {
+                break;
+            }
+            flags = reader.next() | 0xFF00;
+        }
+
+        if (reader.atEnd())
+        {
+            break;
+        }
+        if ((flags & 1) != 0)
+        {
+            auto const value = reader.next();
+            output.append(value);
+            ring[ringPosition] = value;
+            ringPosition = (ringPosition + 1) % RingSize;
+        }
+        else
+        {
+            auto const low = reader.next();
+            if (reader.atEnd())
+            {
+                break;
+            }
+            auto const high = reader.next();
+            size_t const position = low | ((high & 0xF0) << 4);
+            size_t const length = (high & 0x0F) + 3;
+            for (size_t i = 0; i < length; ++i)
+            {
+                auto const value = ring[(position + i) % RingSize];
+                output.append(value);
+                ring[ringPosition] = value;
+                ringPosition = (ringPosition + 1) % RingSize;
+            }
+        }
+    }
+    return std::make_pair(std::move(output), reader.offset());
+}
+
+auto LzssCodec::parameters() const -> const LzParameters&
+{
+    static const LzParameters parameters{.window = RingSize, .maxLength = 18};
+    return parameters;
+}
+
+auto LzssCodec::write(const BinaryView& input, const std::vector<LzToken>& tokens) const -> Binary
+{
+    Binary output;
+    encodeTokens(output, input, tokens, false, false,
+                 [](Binary& output, const LzToken& token, size_t position) {
+                     auto const ringPosition = (RingStart + position - token.distance) % RingSize;
+                     output.append(static_cast<uint8_t>(ringPosition & 0xFF));
+                     output.append(
+                         static_cast<uint8_t>(((ringPosition >> 4) & 0xF0) | (token.length - 3)));
+                 });
+    return output;
+}
+
+auto LzssCodec::copy() const -> std::unique_ptr<Codec>
+{
+    return std::make_unique<LzssCodec>(*this);
+}
+
+//##[ Yaz0Codec ]##################################################################################
+
+auto Yaz0Codec::decompress(const BinaryView& input) const -> std::pair<Binary, size_t>
+{
+    if (input.size() < 16 || input[0] != 'Y' || input[1] != 'a' || input[2] != 'z' ||
+        input[3] != '0')
+    {
+        throw std::runtime_error{"Yaz0Codec: not Yaz0 data"};
+    }
+    size_t size{0};
+    for (auto i = 4U; i < 8; ++i)
+    {
+        size = (size << 8) | input[i];
+    }
+
+    StreamReader reader{input, 16, "Yaz0Codec"};
+    auto output = decodeSized(reader, size, false, "Yaz0Codec", [](StreamReader& reader) {
+        auto const high = reader.next();
+        auto const low = reader.next();
+        size_t const distance = (((high & 0x0F) << 8) | low) + 1;
+        size_t const length = (high >> 4) == 0 ? reader.next() + 0x12 : (high >> 4) + 2;
+        return std::make_pair(length, distance);
+    });
+    return std::make_pair(std::move(output), reader.offset());
+}
+
+auto Yaz0Codec::parameters() const -> const LzParameters&
+{
+    static const LzParameters parameters{.window = 4096,
+                                         .maxLength = 0x111,
+                                         .longMatchLength = 0x12,
+                                         .longMatchCost = 25};
+    return parameters;
+}
+
+auto Yaz0Codec::write(const BinaryView& input, const std::vector<LzToken>& tokens) const -> Binary
+{
+    if (input.size() > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::runtime_error{"Yaz0Codec: data exceeds 4 GiB"};
+    }
+
+    Binary output;
+    output.append(std::string_view{"Yaz0"});
+    output.appendBig<4>(input.size());
+    output.appendBig<8>(uint64_t{0});
+    encodeTokens(output, input, tokens, false, true,
+                 [](Binary& output, const LzToken& token, size_t) {
+                     auto const displacement = token.distance - 1;
+                     if (token.length < 0x12)
+                     {
+                         output.append(static_cast<uint8_t>(((token.length - 2) << 4) |
+                                                            (displacement >> 8)));
+                         output.append(static_cast<uint8_t>(displacement & 0xFF));
+                     }
+                     else
+                     {
+                         output.append(static_cast<uint8_t>(displacement >> 8));
+                         output.append(static_cast<uint8_t>(displacement & 0xFF));
+                         output.append(static_cast<uint8_t>(token.length - 0x12));
+                     }
+                 });
+    return output;
+}
+
+auto Yaz0Codec::copy() const -> std::unique_ptr<Codec>
+{
+    return std::make_unique<Yaz0Codec>(*this);
+}
+
+} // namespace kaizo
@@ -1,6 +1,15 @@
 #include "DataPathParser.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <contracts/Contracts.h>
 #include <kaizo/data/DataPath.h>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
 
 namespace kaizo::data {
 
@@ -28,6 +37,20 @@ auto DataPathElement::makeIndexWildcard() -> DataPathElement
     return element;
 }
 
+auto DataPathElement::makeNameWildcard() -> DataPathElement
+{
+    DataPathElement element;
+    element.m_kind = Kind::NameWildcard;
+    return element;
+}
+
+auto DataPathElement::makeDoubleWildcard() -> DataPathElement
+{
+    DataPathElement element;
+    element.m_kind = Kind::DoubleWildcard;
+    return element;
+}
+
 auto DataPathElement::makePointer() -> DataPathElement
 {
     DataPathElement element;
@@ -52,7 +75,7 @@ bool DataPathElement::isIndex() const
 
 bool DataPathElement::isNameExpression() const
 {
-    return isName();
+    return isName() || kind() == Kind::NameWildcard;
 }
 
 bool DataPathElement::isIndexExpression() const
@@ -67,7 +90,8 @@ bool DataPathElement::isStatic() const
 
 bool DataPathElement::isWildcard() const
 {
-    return kind() == Kind::IndexWildcard;
+    return kind() == Kind::IndexWildcard || kind() == Kind::NameWildcard ||
+           kind() == Kind::DoubleWildcard;
 }
 
 auto DataPathElement::name() const -> const std::string&
@@ -89,6 +113,8 @@ auto DataPathElement::toString() const -> std::string
     case Kind::Name: return name();
     case Kind::Index: return "[" + std::to_string(index()) + "]";
     case Kind::IndexWildcard: return "[*]";
+    case Kind::NameWildcard: return "*";
+    case Kind::DoubleWildcard: return "**";
     case Kind::Pointer: return "*";
     default: InvalidCase(kind());
     }
@@ -120,51 +146,311 @@ bool DataPathElement::operator==(const DataPathElement& element) const
     switch (kind())
     {
     case Kind::Name: return name() == element.name();
-    case Kind::Index: return name() == element.name();
+    case Kind::Index: return index() == element.index();
     default: return true;
     }
 }
 
-auto DataPath::operator/=(const DataPathElement& element) -> DataPath&
+auto DataPathElement::hash() const -> size_t
 {
-    /*
-    if (element.isIndexExpression() && m_elements.size() == 0)
+    auto const kindHash = static_cast<size_t>(kind()) * 0x9E3779B97F4A7C15ULL;
+    switch (kind())
     {
-        throw std::invalid_argument{"index expression cannot be the first element of a DataPath"};
+    case Kind::Name: return kindHash ^ std::hash<std::string>{}(name());
+    case Kind::Index: return kindHash ^ std::hash<size_t>{}(index());
+    default: return kindHash;
+    }
+}
+
+namespace {
+
+class DataPathTable
+{
+public:
+    struct Node
+    {
+        DataPathElement element;
+        uint32_t parent{0};
+        uint32_t length{0};
+        size_t hash{0};
+        // paths and child nodes referring to this node; unreferenced nodes are recycled
+        std::atomic<uint32_t> references{0};
+        bool isLive{false};
+    };
+
+    static auto instance() -> DataPathTable&
+    {
+        // never destroyed, since static paths may be released after it otherwise
+        static auto* const table = new DataPathTable;
+        return *table;
+    }
+
+    auto node(uint32_t id) const -> const Node&
+    {
+        return m_chunks[id >> ChunkBits].load(std::memory_order_acquire)[id & (ChunkSize - 1)];
+    }
+
+    /// Returns the referenced id of the given child, interning it if necessary.
+    auto child(uint32_t parent, const DataPathElement& element) -> uint32_t
+    {
+        auto const hash = combine(node(parent).hash, element.hash());
+        Key const key{parent, &element, hash};
+        {
+            // referencing the child under the lock keeps it from being recycled
+            std::shared_lock lock{m_mutex};
+            if (auto const result = m_children.find(key); result != m_children.end())
+            {
+                acquire(result->second);
+                return result->second;
+            }
+        }
+
+        std::unique_lock lock{m_mutex};
+        if (auto const result = m_children.find(key); result != m_children.end())
+        {
+            acquire(result->second);
+            return result->second;
+        }
+        auto const id = allocate();
+        auto& child = mutableNode(id);
+        child.element = element;
+        child.parent = parent;
+        child.length = node(parent).length + 1;
+        child.hash = hash;
+        child.references.store(1, std::memory_order_relaxed);
+        child.isLive = true;
+        acquire(parent);
+        m_children.emplace(Key{parent, &child.element, hash}, id);
+        return id;
     }
-    */
-    m_elements.push_back(element);
+
+    void acquire(uint32_t id)
+    {
+        if (id != 0)
+        {
+            mutableNode(id).references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void release(uint32_t id)
+    {
+        if (id != 0 && mutableNode(id).references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            collect(id);
+        }
+    }
+
+private:
+    static constexpr uint32_t ChunkBits = 12;
+    static constexpr uint32_t ChunkSize = 1U << ChunkBits;
+    static constexpr uint32_t MaxChunks = 1U << 16;
+
+    struct Key
+    {
+        uint32_t parent;
+        const DataPathElement* element;
+        size_t hash;
+
+        bool operator==(const Key& rhs) const
+        {
+            return parent == rhs.parent && *element == *rhs.element;
+        }
+    };
+
+    struct KeyHash
+    {
+        auto operator()(const Key& key) const -> size_t
+        {
+            return key.hash;
+        }
+    };
+
+    DataPathTable()
+    {
+        allocate();
+        mutableNode(0).isLive = true;
+    }
+
+    static auto combine(size_t seed, size_t hash) -> size_t
+    {
+        return seed ^ (hash + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2));
+    }
+
+    auto mutableNode(uint32_t id) -> Node&
+    {
+        return const_cast<Node&>(node(id));
+    }
+
+    // must be called with the mutex held exclusively (or during construction)
+    auto allocate() -> uint32_t
+    {
+        if (!m_free.empty())
+        {
+            auto const id = m_free.back();
+            m_free.pop_back();
+            return id;
+        }
+        auto const id = m_size;
+        auto const chunk = id >> ChunkBits;
+        if (chunk >= MaxChunks)
+        {
+            throw std::runtime_error{"DataPath: too many distinct paths"};
+        }
+        if ((id & (ChunkSize - 1)) == 0)
+        {
+            m_storage.push_back(std::make_unique<Node[]>(ChunkSize));
+            m_chunks[chunk].store(m_storage.back().get(), std::memory_order_release);
+        }
+        ++m_size;
+        return id;
+    }
+
+    void collect(uint32_t id)
+    {
+        std::unique_lock lock{m_mutex};
+        // the node may have been referenced again, or collected by another thread, meanwhile
+        while (id != 0 && node(id).isLive &&
+               node(id).references.load(std::memory_order_acquire) == 0)
+        {
+            auto& unreferenced = mutableNode(id);
+            m_children.erase(Key{unreferenced.parent, &unreferenced.element, unreferenced.hash});
+            unreferenced.isLive = false;
+            m_free.push_back(id);
+
+            id = unreferenced.parent;
+            if (id == 0 || mutableNode(id).references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            {
+                break;
+            }
+        }
+    }
+
+    // node chunks are never moved, so readers only need the (atomic) chunk table
+    std::array<std::atomic<Node*>, MaxChunks> m_chunks{};
+    std::vector<std::unique_ptr<Node[]>> m_storage;
+    uint32_t m_size{0};
+    std::vector<uint32_t> m_free;
+    std::unordered_map<Key, uint32_t, KeyHash> m_children;
+    std::shared_mutex m_mutex;
+};
+
+} // namespace
+
+DataPath::DataPath(const DataPath& other)
+    : m_id{other.m_id}
+{
+    DataPathTable::instance().acquire(m_id);
+}
+
+DataPath::DataPath(DataPath&& other) noexcept
+    : m_id{std::exchange(other.m_id, 0)}
+{
+}
+
+DataPath::~DataPath()
+{
+    DataPathTable::instance().release(m_id);
+}
+
+auto DataPath::operator=(const DataPath& other) -> DataPath&
+{
+    auto& table = DataPathTable::instance();
+    table.acquire(other.m_id);
+    table.release(m_id);
+    m_id = other.m_id;
+    return *this;
+}
+
+auto DataPath::operator=(DataPath&& other) noexcept -> DataPath&
+{
+    if (this != &other)
+    {
+        DataPathTable::instance().release(m_id);
+        m_id = std::exchange(other.m_id, 0);
+    }
+    return *this;
+}
+
+auto DataPath::operator/=(const DataPathElement& element) -> DataPath&
+{
+    auto& table = DataPathTable::instance();
+    auto const id = table.child(m_id, element);
+    table.release(m_id);
+    m_id = id;
     return *this;
 }
 
 void DataPath::goUp()
 {
-    Expects(m_elements.size() > 0);
-    m_elements.pop_back();
+    Expects(!isEmpty());
+    auto& table = DataPathTable::instance();
+    auto const id = table.node(m_id).parent;
+    table.acquire(id);
+    table.release(m_id);
+    m_id = id;
+}
+
+auto DataPath::elements() const -> std::vector<const DataPathElement*>
+{
+    auto const& table = DataPathTable::instance();
+    std::vector<const DataPathElement*> elements(length());
+    for (auto id = m_id; id != 0; id = table.node(id).parent)
+    {
+        elements[table.node(id).length - 1] = &table.node(id).element;
+    }
+    return elements;
 }
 
 auto DataPath::toString() const -> std::string
 {
+    auto const elements = this->elements();
     std::string string;
-    for (auto i = 0U; i < m_elements.size(); ++i)
+    for (auto i = 0U; i < elements.size(); ++i)
     {
-        if (i > 0 && m_elements[i].isName())
+        if (i > 0 && (elements[i]->isNameExpression() ||
+                      elements[i]->kind() == DataPathElement::Kind::DoubleWildcard))
         {
             string += ".";
         }
-        string += m_elements[i].toString();
+        string += elements[i]->toString();
     }
     return string;
 }
 
+auto DataPath::hash() const -> size_t
+{
+    return DataPathTable::instance().node(m_id).hash;
+}
+
 bool DataPath::operator<(const DataPath& rhs) const
 {
-    return m_elements < rhs.m_elements;
+    // compares the elements below the common ancestor; a path sorts after its ancestors
+    auto const& table = DataPathTable::instance();
+    auto lhsId = m_id;
+    auto rhsId = rhs.m_id;
+    while (table.node(lhsId).length > table.node(rhsId).length)
+    {
+        lhsId = table.node(lhsId).parent;
+    }
+    while (table.node(rhsId).length > table.node(lhsId).length)
+    {
+        rhsId = table.node(rhsId).parent;
+    }
+    if (lhsId == rhsId)
+    {
+        return length() < rhs.length();
+    }
+    while (table.node(lhsId).parent != table.node(rhsId).parent)
+    {
+        lhsId = table.node(lhsId).parent;
+        rhsId = table.node(rhsId).parent;
+    }
+    return table.node(lhsId).element < table.node(rhsId).element;
 }
 
 bool DataPath::operator==(const DataPath& rhs) const
 {
-    return m_elements == rhs.m_elements;
+    return m_id == rhs.m_id;
 }
 
 auto DataPath::parent() const -> DataPath
@@ -176,18 +462,25 @@ auto DataPath::parent() const -> DataPath
 
 auto DataPath::length() const -> size_t
 {
-    return m_elements.size();
+    return DataPathTable::instance().node(m_id).length;
 }
 
 auto DataPath::element(size_t index) const -> const DataPathElement&
 {
     Expects(index < length());
-    return m_elements[index];
+    auto const& table = DataPathTable::instance();
+    auto id = m_id;
+    for (auto i = index + 1; i < length(); ++i)
+    {
+        id = table.node(id).parent;
+    }
+    return table.node(id).element;
 }
 
 void DataPath::clear()
 {
-    m_elements.clear();
+    DataPathTable::instance().release(m_id);
+    m_id = 0;
 }
 
 auto DataPath::fromString(const std::string string) -> std::optional<DataPath>
@@ -196,9 +489,16 @@ auto DataPath::fromString(const std::string string) -> std::optional<DataPath>
     return parser.parse(string);
 }
 
+auto DataPath::elementsFromString(std::string_view string)
+    -> std::optional<std::vector<DataPathElement>>
+{
+    DataPathParser parser;
+    return parser.parseElements(string);
+}
+
 bool DataPath::isEmpty() const
 {
-    return m_elements.empty();
+    return m_id == 0;
 }
 
 } // namespace kaizo::data
\ No newline at end of file
@@ -3,24 +3,39 @@
 
 namespace kaizo::data {
 
-auto DataPathParser::parse(const std::string& string) -> std::optional<DataPath>
+auto DataPathParser::parse(std::string_view string) -> std::optional<DataPath>
 {
-    m_string = &string;
+    if (auto maybeElements = parseElements(string))
+    {
+        DataPath path;
+        for (auto const& element : *maybeElements)
+        {
+            path /= element;
+        }
+        return path;
+    }
+    return {};
+}
+
+auto DataPathParser::parseElements(std::string_view string)
+    -> std::optional<std::vector<DataPathElement>>
+{
+    m_string = string;
     m_index = 0;
 
-    DataPath path;
+    std::vector<DataPathElement> elements;
     while (hasNext())
     {
         if (auto maybeElement = parseElement())
         {
-            path /= *maybeElement;
+            elements.push_back(std::move(*maybeElement));
         }
         else
         {
             return {};
         }
     }
-    return path;
+    return elements;
 }
 
 auto DataPathParser::parseElement() -> std::optional<DataPathElement>
@@ -28,12 +43,16 @@ auto DataPathParser::parseElement() -> std::optional<DataPathElement>
     if (fetch() == '.')
     {
         consume();
-        return parseNameElement();
+        return fetch() == '*' ? parseWildcardElement() : parseNameElement();
     }
     else if (isFirst() && std::isalpha(fetch()))
     {
         return parseNameElement();
     }
+    else if (isFirst() && fetch() == '*')
+    {
+        return parseWildcardElement();
+    }
     else if (fetch() == '[')
     {
         return parseIndexElement();
@@ -78,6 +97,16 @@ auto DataPathParser::parseIndexElement() -> std::optional<DataPathElement>
 {
     consume(); // '['
 
+    if (fetch() == '*')
+    {
+        consume();
+        if (fetch() != ']')
+        {
+            return {};
+        }
+        consume();
+        return DataPathElement::makeIndexWildcard();
+    }
     if (!std::isdigit(fetch()))
     {
         return {};
@@ -109,14 +138,25 @@ auto DataPathParser::parseIndexElement() -> std::optional<DataPathElement>
     }
 }
 
+auto DataPathParser::parseWildcardElement() -> std::optional<DataPathElement>
+{
+    consume(); // '*'
+    if (fetch() == '*')
+    {
+        consume();
+        return DataPathElement::makeDoubleWildcard();
+    }
+    return DataPathElement::makeNameWildcard();
+}
+
 bool DataPathParser::hasNext() const
 {
-    return m_index < m_string->length();
+    return m_index < m_string.length();
 }
 
 auto DataPathParser::fetch() const -> char
 {
-    return (*m_string)[m_index];
+    return hasNext() ? m_string[m_index] : '\0';
 }
 
 void DataPathParser::consume()
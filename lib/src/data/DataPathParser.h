@@ -3,16 +3,20 @@
 #include <kaizo/data/DataPath.h>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace kaizo::data {
 
 class DataPathParser
 {
 public:
-    auto parse(const std::string& string) -> std::optional<DataPath>;
+    auto parse(std::string_view string) -> std::optional<DataPath>;
+    auto parseElements(std::string_view string) -> std::optional<std::vector<DataPathElement>>;
     auto parseElement() -> std::optional<DataPathElement>;
     auto parseNameElement() -> std::optional<DataPathElement>;
     auto parseIndexElement() -> std::optional<DataPathElement>;
+    auto parseWildcardElement() -> std::optional<DataPathElement>;
 
 private:
     bool hasNext() const;
@@ -20,7 +24,7 @@ private:
     void consume();
     bool isFirst() const;
 
-    const std::string* m_string{nullptr};
+    std::string_view m_string;
     size_t m_index{0};
 };
 
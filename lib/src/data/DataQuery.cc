@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <kaizo/data/DataQuery.h>
+#include <kaizo/data/data/ArrayData.h>
+#include <kaizo/data/data/RecordData.h>
+#include <stdexcept>
+
+namespace kaizo::data {
+
+auto DataQuery::add(const DataPath& pattern) -> size_t
+{
+    std::vector<DataPathElement> elements;
+    for (auto i = 0U; i < pattern.length(); ++i)
+    {
+        auto const& element = pattern.element(i);
+        if (!element.isStatic() && !element.isWildcard())
+        {
+            throw std::runtime_error{"DataQuery: unsupported path element '" +
+                                        element.toString() + "'"};
+        }
+        elements.push_back(element);
+    }
+    m_patterns.push_back(std::move(elements));
+    return m_patterns.size() - 1;
+}
+
+auto DataQuery::queryCount() const -> size_t
+{
+    return m_patterns.size();
+}
+
+auto DataQuery::run(const Data& root) const -> std::vector<std::vector<Match>>
+{
+    std::vector<std::vector<Match>> results(m_patterns.size());
+    std::vector<State> states;
+    for (auto i = 0U; i < m_patterns.size(); ++i)
+    {
+        states.push_back(State{i, 0});
+    }
+    std::vector<DataPathElement> path;
+    visit(root, states, path, results);
+    return results;
+}
+
+void DataQuery::close(std::vector<State>& states) const
+{
+    // '**' may match no level at all, so the pattern may also continue right here
+    for (auto i = 0U; i < states.size(); ++i)
+    {
+        auto const [query, position] = states[i];
+        auto const& pattern = m_patterns[query];
+        if (position < pattern.size() &&
+            pattern[position].kind() == DataPathElement::Kind::DoubleWildcard)
+        {
+            states.push_back(State{query, position + 1});
+        }
+    }
+    std::sort(states.begin(), states.end());
+    states.erase(std::unique(states.begin(), states.end()), states.end());
+}
+
+void DataQuery::advance(const std::vector<State>& states, const DataPathElement& child,
+                        std::vector<State>& next) const
+{
+    next.clear();
+    for (auto const [query, position] : states)
+    {
+        auto const& pattern = m_patterns[query];
+        if (position == pattern.size())
+        {
+            continue;
+        }
+        auto const& element = pattern[position];
+        switch (element.kind())
+        {
+        case DataPathElement::Kind::DoubleWildcard: next.push_back(State{query, position}); break;
+        case DataPathElement::Kind::NameWildcard:
+            if (child.isName())
+            {
+                next.push_back(State{query, position + 1});
+            }
+            break;
+        case DataPathElement::Kind::IndexWildcard:
+            if (child.isIndex())
+            {
+                next.push_back(State{query, position + 1});
+            }
+            break;
+        default:
+            if (element == child)
+            {
+                next.push_back(State{query, position + 1});
+            }
+            break;
+        }
+    }
+    close(next);
+}
+
+void DataQuery::visit(const Data& data, std::vector<State>& states,
+                      std::vector<DataPathElement>& path,
+                      std::vector<std::vector<Match>>& results) const
+{
+    close(states);
+    bool descend{false};
+    for (auto const [query, position] : states)
+    {
+        if (position == m_patterns[query].size())
+        {
+            DataPath matchPath;
+            for (auto const& element : path)
+            {
+                matchPath /= element;
+            }
+            results[query].push_back(Match{matchPath, &data});
+        }
+        else
+        {
+            descend = true;
+        }
+    }
+    if (!descend)
+    {
+        return;
+    }
+
+    std::vector<State> next;
+    auto visitChild = [&](const DataPathElement& element, const Data& child) {
+        advance(states, element, next);
+        if (!next.empty())
+        {
+            path.push_back(element);
+            visit(child, next, path, results);
+            path.pop_back();
+        }
+    };
+
+    if (data.type() == DataType::Record)
+    {
+        auto const& record = static_cast<const RecordData&>(data);
+        for (auto const& name : record.elementNames())
+        {
+            visitChild(DataPathElement::makeName(name), record.element(name));
+        }
+    }
+    else if (data.type() == DataType::Array)
+    {
+        auto const& array = static_cast<const ArrayData&>(data);
+        for (auto i = 0U; i < array.elementCount(); ++i)
+        {
+            visitChild(DataPathElement::makeIndex(i + 1), array.element(i));
+        }
+    }
+}
+
+} // namespace kaizo::data
@@ -9,26 +9,83 @@ namespace kaizo::data {
 
 DataReader::DataReader(const BinaryView& binary)
 {
-    m_source = Binary::fromArray(binary.data(), binary.size());
-    m_addressMap = std::make_unique<IdempotentAddressMap>(fileOffsetFormat());
+    m_source = std::make_shared<Binary>(Binary::fromArray(binary.data(), binary.size()));
+    m_addressMap = std::make_shared<IdempotentAddressMap>(fileOffsetFormat());
+}
+
+DataReader::DataReader(Binary&& binary)
+{
+    m_source = std::make_shared<Binary>(std::move(binary));
+    m_addressMap = std::make_shared<IdempotentAddressMap>(fileOffsetFormat());
 }
 
 DataReader::DataReader(const std::filesystem::path& filename)
 {
-    m_source = Binary::load(filename);
-    m_addressMap = std::make_unique<IdempotentAddressMap>(fileOffsetFormat());
+    m_source = std::make_shared<Binary>(Binary::load(filename));
+    m_addressMap = std::make_shared<IdempotentAddressMap>(fileOffsetFormat());
+}
+
+DataReader::DataReader(const std::shared_ptr<const Binary>& source,
+                       const std::shared_ptr<const AddressMap>& addressMap)
+    : m_addressMap{addressMap}
+    , m_source{source}
+{
+}
+
+auto DataReader::fork() const -> std::unique_ptr<DataReader>
+{
+    auto reader = std::unique_ptr<DataReader>{new DataReader{m_source, m_addressMap}};
+    reader->m_offset = m_offset;
+    return reader;
+}
+
+void DataReader::join(DataReader& fork)
+{
+    Expects(fork.m_currentNode == &fork.m_root);
+    for (auto* child : fork.m_root.children)
+    {
+        child->parent = m_currentNode;
+        m_currentNode->children.push_back(child);
+    }
+    fork.m_root.children.clear();
+    // moving a deque keeps its nodes in place
+    m_joinedStructures.push_back(
+        std::make_unique<std::deque<DataStructure>>(std::move(fork.m_structure)));
+    fork.m_structure.clear();
+}
+
+void DataReader::visitStructure(
+    const std::function<void(const DataPath&, const Data*)>& visitor) const
+{
+    std::vector<std::pair<const DataStructure*, DataPath>> pending;
+    auto const push = [&pending](const DataStructure& node, const DataPath& parentPath) {
+        for (auto child = node.children.crbegin(); child != node.children.crend(); ++child)
+        {
+            auto& [next, path] = pending.emplace_back(*child, parentPath);
+            path /= next->pathElement;
+        }
+    };
+
+    push(m_root, DataPath{});
+    while (!pending.empty())
+    {
+        auto const [node, path] = std::move(pending.back());
+        pending.pop_back();
+        visitor(path, node->data);
+        push(*node, path);
+    }
 }
 
 DataReader::~DataReader() = default;
 
 auto DataReader::dataSize() const -> size_t
 {
-    return m_source.size();
+    return m_source->size();
 }
 
 auto DataReader::binary() const -> const Binary&
 {
-    return m_source;
+    return *m_source;
 }
 
 auto DataReader::offset() const -> size_t
@@ -38,34 +95,33 @@ auto DataReader::offset() const -> size_t
 
 void DataReader::advance(size_t size)
 {
-    Expects(m_offset + size <= m_source.size());
+    Expects(m_offset + size <= m_source->size());
     m_offset += size;
 }
 
 void DataReader::setOffset(size_t offset)
 {
-    Expects(offset <= m_source.size());
+    Expects(offset <= m_source->size());
     m_offset = offset;
 }
 
 void DataReader::enter(const DataPathElement& element)
 {
     Expects(element.isStatic());
-    m_path /= element;
 
-    auto structure = std::make_unique<DataStructure>();
-    structure->pathElement = element;
-    structure->data = nullptr;
-    structure->parent = m_currentNode;
-    m_currentNode->children.push_back(std::move(structure));
-    m_currentNode = m_currentNode->children.back().get();
+    auto& structure = m_structure.emplace_back();
+    structure.pathElement = element;
+    structure.data = nullptr;
+    structure.parent = m_currentNode;
+    m_currentNode->children.push_back(&structure);
+    m_currentNode = &structure;
 }
 
 void DataReader::trackRange(const std::string& tag, size_t address, size_t size)
 {
     if (m_dataRangeConsumer)
     {
-        m_dataRangeConsumer->track(m_path, DataRangeTracker::Range{address, size}, tag);
+        m_dataRangeConsumer->track(currentPath(), DataRangeTracker::Range{address, size}, tag);
     }
 }
 
@@ -73,7 +129,22 @@ void DataReader::leave(const Data* data)
 {
     m_currentNode->data = data;
     m_currentNode = m_currentNode->parent;
-    m_path.goUp();
+}
+
+auto DataReader::currentPath() const -> DataPath
+{
+    // only interned when needed, since most decoded nodes are never tracked
+    std::vector<const DataStructure*> nodes;
+    for (auto const* node = m_currentNode; node != &m_root; node = node->parent)
+    {
+        nodes.push_back(node);
+    }
+    DataPath path;
+    for (auto node = nodes.crbegin(); node != nodes.crend(); ++node)
+    {
+        path /= (*node)->pathElement;
+    }
+    return path;
 }
 
 void DataReader::setAddressMap(std::unique_ptr<AddressMap>&& addressMap)
@@ -92,4 +163,9 @@ void DataReader::setTracker(DataRangeTracker* tracker)
     m_dataRangeConsumer = tracker;
 }
 
+bool DataReader::isTracking() const
+{
+    return m_dataRangeConsumer != nullptr;
+}
+
 } // namespace kaizo::data
\ No newline at end of file
@@ -84,6 +84,11 @@ void DataWriter::skip(size_t size)
     section().annotated.skip(size);
 }
 
+void DataWriter::align(size_t alignment)
+{
+    section().annotated.align(alignment);
+}
+
 void DataWriter::leaveLevel()
 {
     Expects(m_sectionIndex > 0);
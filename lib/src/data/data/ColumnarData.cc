@@ -0,0 +1,311 @@
+#include <contracts/Contracts.h>
+#include <kaizo/data/data/ArrayData.h>
+#include <kaizo/data/data/ColumnarData.h>
+#include <kaizo/data/data/IntegerData.h>
+#include <kaizo/data/data/RecordData.h>
+#include <kaizo/data/data/StringData.h>
+#include <limits>
+#include <stdexcept>
+
+namespace kaizo::data {
+
+ColumnarData::Column::Column(const std::string& name, ColumnType type)
+    : m_name{name}
+    , m_type{type}
+{
+    switch (type)
+    {
+    case ColumnType::Int32: m_values = std::vector<int32_t>{}; break;
+    case ColumnType::UInt32:
+    case ColumnType::String: m_values = std::vector<uint32_t>{}; break;
+    case ColumnType::Int64: m_values = std::vector<int64_t>{}; break;
+    case ColumnType::UInt64: m_values = std::vector<uint64_t>{}; break;
+    default: InvalidCase(type);
+    }
+}
+
+auto ColumnarData::Column::name() const -> const std::string&
+{
+    return m_name;
+}
+
+auto ColumnarData::Column::type() const -> ColumnType
+{
+    return m_type;
+}
+
+bool ColumnarData::Column::isString() const
+{
+    return m_type == ColumnType::String;
+}
+
+bool ColumnarData::Column::isSigned() const
+{
+    return m_type == ColumnType::Int32 || m_type == ColumnType::Int64;
+}
+
+auto ColumnarData::Column::size() const -> size_t
+{
+    if (isString())
+    {
+        return m_offsets.size() - 1;
+    }
+    return std::visit([](auto const& values) { return values.size(); }, m_values);
+}
+
+void ColumnarData::Column::reserve(size_t size)
+{
+    if (isString())
+    {
+        m_offsets.reserve(size + 1);
+    }
+    else
+    {
+        std::visit([size](auto& values) { values.reserve(size); }, m_values);
+    }
+}
+
+void ColumnarData::Column::appendSigned(int64_t value)
+{
+    Expects(!isString());
+    std::visit(
+        [value](auto& values) {
+            using value_t = typename std::decay_t<decltype(values)>::value_type;
+            values.push_back(static_cast<value_t>(value));
+        },
+        m_values);
+}
+
+void ColumnarData::Column::appendUnsigned(uint64_t value)
+{
+    Expects(!isString());
+    std::visit(
+        [value](auto& values) {
+            using value_t = typename std::decay_t<decltype(values)>::value_type;
+            values.push_back(static_cast<value_t>(value));
+        },
+        m_values);
+}
+
+void ColumnarData::Column::appendString(std::string_view value)
+{
+    Expects(isString());
+    if (m_arena.size() + value.size() > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::runtime_error{"ColumnarData: string arena exceeds 4 GiB"};
+    }
+    m_arena.append(value);
+    m_offsets.push_back(static_cast<uint32_t>(m_arena.size()));
+}
+
+void ColumnarData::Column::append(const Data& data)
+{
+    if (isString())
+    {
+        if (data.type() != DataType::String)
+        {
+            throw std::runtime_error{"ColumnarData: column '" + m_name + "' expects a string"};
+        }
+        appendString(static_cast<const StringData&>(data).value());
+    }
+    else
+    {
+        if (data.type() != DataType::Integer)
+        {
+            throw std::runtime_error{"ColumnarData: column '" + m_name + "' expects an integer"};
+        }
+        auto const& integer = static_cast<const IntegerData&>(data);
+        if (integer.isNegative())
+        {
+            appendSigned(integer.asSigned());
+        }
+        else
+        {
+            appendUnsigned(integer.asUnsigned());
+        }
+    }
+}
+
+auto ColumnarData::Column::signedValue(size_t row) const -> int64_t
+{
+    Expects(!isString() && row < size());
+    return std::visit([row](auto const& values) { return static_cast<int64_t>(values[row]); },
+                      m_values);
+}
+
+auto ColumnarData::Column::unsignedValue(size_t row) const -> uint64_t
+{
+    Expects(!isString() && row < size());
+    return std::visit([row](auto const& values) { return static_cast<uint64_t>(values[row]); },
+                      m_values);
+}
+
+auto ColumnarData::Column::string(size_t row) const -> std::string_view
+{
+    Expects(isString() && row < size());
+    return std::string_view{m_arena}.substr(m_offsets[row], m_offsets[row + 1] - m_offsets[row]);
+}
+
+auto ColumnarData::Column::element(size_t row) const -> std::unique_ptr<Data>
+{
+    if (isString())
+    {
+        return std::make_unique<StringData>(std::string{string(row)});
+    }
+    else if (isSigned())
+    {
+        return std::make_unique<IntegerData>(signedValue(row));
+    }
+    else
+    {
+        return std::make_unique<IntegerData>(unsignedValue(row));
+    }
+}
+
+auto ColumnarData::Column::data() const -> const void*
+{
+    if (isString())
+    {
+        return m_offsets.data();
+    }
+    return std::visit([](auto const& values) -> const void* { return values.data(); }, m_values);
+}
+
+auto ColumnarData::Column::elementSize() const -> size_t
+{
+    if (isString())
+    {
+        return sizeof(uint32_t);
+    }
+    return std::visit(
+        [](auto const& values) {
+            return sizeof(typename std::decay_t<decltype(values)>::value_type);
+        },
+        m_values);
+}
+
+auto ColumnarData::Column::arena() const -> const std::string&
+{
+    Expects(isString());
+    return m_arena;
+}
+
+ColumnarData::ColumnarData()
+    : Data{DataType::Columnar}
+{
+}
+
+auto ColumnarData::addColumn(const std::string& name, ColumnType type) -> Column&
+{
+    Expects(!hasColumn(name));
+    Expects(rowCount() == 0);
+    return m_columns.emplace_back(name, type);
+}
+
+auto ColumnarData::columnCount() const -> size_t
+{
+    return m_columns.size();
+}
+
+bool ColumnarData::hasColumn(const std::string& name) const
+{
+    for (auto const& column : m_columns)
+    {
+        if (column.name() == name)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+auto ColumnarData::column(size_t index) const -> const Column&
+{
+    Expects(index < m_columns.size());
+    return m_columns[index];
+}
+
+auto ColumnarData::column(size_t index) -> Column&
+{
+    Expects(index < m_columns.size());
+    return m_columns[index];
+}
+
+auto ColumnarData::column(const std::string& name) const -> const Column&
+{
+    for (auto const& column : m_columns)
+    {
+        if (column.name() == name)
+        {
+            return column;
+        }
+    }
+    throw std::runtime_error{"ColumnarData: no column named '" + name + "'"};
+}
+
+auto ColumnarData::rowCount() const -> size_t
+{
+    return m_columns.empty() ? 0 : m_columns.front().size();
+}
+
+void ColumnarData::reserve(size_t rows)
+{
+    for (auto& column : m_columns)
+    {
+        column.reserve(rows);
+    }
+}
+
+void ColumnarData::appendRow(const Data& record)
+{
+    if (record.type() != DataType::Record)
+    {
+        throw std::runtime_error{"ColumnarData: rows must be records"};
+    }
+    auto const& recordData = static_cast<const RecordData&>(record);
+    for (auto& column : m_columns)
+    {
+        if (!recordData.has(column.name()))
+        {
+            throw std::runtime_error{"ColumnarData: row is missing '" + column.name() + "'"};
+        }
+        column.append(recordData.element(column.name()));
+    }
+}
+
+auto ColumnarData::row(size_t index) const -> std::unique_ptr<RecordData>
+{
+    Expects(index < rowCount());
+    auto record = std::make_unique<RecordData>();
+    for (auto const& column : m_columns)
+    {
+        record->set(column.name(), column.element(index));
+    }
+    return record;
+}
+
+auto ColumnarData::toArray() const -> std::unique_ptr<ArrayData>
+{
+    auto array = std::make_unique<ArrayData>();
+    for (auto i = 0U; i < rowCount(); ++i)
+    {
+        array->append(row(i));
+    }
+    return array;
+}
+
+bool ColumnarData::isEqual(const Data& rhs) const
+{
+    if (rhs.type() == type())
+    {
+        return m_columns == static_cast<const ColumnarData&>(rhs).m_columns;
+    }
+    return false;
+}
+
+auto ColumnarData::copy() const -> std::unique_ptr<Data>
+{
+    return std::unique_ptr<ColumnarData>{new ColumnarData{*this}};
+}
+
+} // namespace kaizo::data
@@ -1,5 +1,6 @@
 #include <contracts/Contracts.h>
 #include <kaizo/data/data/Data.h>
+#include <kaizo/data/data/DataArena.h>
 #include <map>
 
 namespace kaizo::data {
@@ -14,10 +15,21 @@ auto Data::type() const -> DataType
     return m_type;
 }
 
+auto Data::operator new(size_t size) -> void*
+{
+    return DataArena::allocate(size);
+}
+
+void Data::operator delete(void* pointer)
+{
+    DataArena::deallocate(pointer);
+}
+
 static const std::map<std::string, DataType> DataTypeMap = {
     {"null", DataType::Null},     {"array", DataType::Array},   {"integer", DataType::Integer},
     {"image", DataType::Image},   {"record", DataType::Record}, {"string", DataType::String},
     {"binary", DataType::Record}, {"custom", DataType::Custom}, {"reference", DataType::Reference},
+    {"columnar", DataType::Columnar},
 };
 
 auto toDataType(const std::string& string) -> std::optional<DataType>
@@ -44,6 +56,7 @@ auto toString(DataType type) -> std::string
     case DataType::String: return "string";
     case DataType::Binary: return "binary";
     case DataType::Image: return "image";
+    case DataType::Columnar: return "columnar";
     case DataType::Custom: return "custom";
     case DataType::Reference: return "reference";
     default: InvalidCase(type);
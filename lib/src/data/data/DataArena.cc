@@ -0,0 +1,92 @@
+#include <kaizo/data/data/Data.h>
+#include <kaizo/data/data/DataArena.h>
+#include <new>
+#include <utility>
+
+namespace kaizo::data {
+
+namespace {
+
+// Every allocation is preceded by the arena it was taken from (nullptr for the heap), padded to
+// keep the object maximally aligned.
+constexpr size_t HeaderSize = alignof(std::max_align_t);
+static_assert(HeaderSize >= sizeof(void*));
+
+thread_local DataArena* ActiveArena{nullptr};
+
+} // namespace
+
+DataArena::Scope::Scope()
+{
+    if (!ActiveArena)
+    {
+        m_arena = new DataArena;
+        ActiveArena = m_arena;
+    }
+}
+
+DataArena::Scope::~Scope()
+{
+    if (m_arena)
+    {
+        ActiveArena = nullptr;
+        m_arena->release();
+    }
+}
+
+auto DataArena::allocate(size_t size) -> void*
+{
+    void* block;
+    if (auto* arena = ActiveArena)
+    {
+        block = arena->m_resource.allocate(HeaderSize + size, HeaderSize);
+        arena->m_references.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        block = ::operator new(HeaderSize + size);
+    }
+    *static_cast<DataArena**>(block) = ActiveArena;
+    return static_cast<std::byte*>(block) + HeaderSize;
+}
+
+void DataArena::deallocate(void* pointer)
+{
+    if (!pointer)
+    {
+        return;
+    }
+    auto* block = static_cast<std::byte*>(pointer) - HeaderSize;
+    if (auto* arena = *reinterpret_cast<DataArena**>(block))
+    {
+        arena->release();
+    }
+    else
+    {
+        ::operator delete(block);
+    }
+}
+
+auto DataArena::detach(const Data& data) -> std::unique_ptr<Data>
+{
+    // copies made while a scope is active would go to its arena
+    struct Suspension
+    {
+        DataArena* arena{std::exchange(ActiveArena, nullptr)};
+        ~Suspension()
+        {
+            ActiveArena = arena;
+        }
+    } const suspension;
+    return data.copy();
+}
+
+void DataArena::release()
+{
+    if (m_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this;
+    }
+}
+
+} // namespace kaizo::data
@@ -31,6 +31,7 @@ bool IntegerData::isEqual(const Data& rhs) const
 
 IntegerData::IntegerData(const IntegerData& other)
     : Data{other}
+    , m_value{other.m_value}
 {
 }
 
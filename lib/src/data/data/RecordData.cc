@@ -30,6 +30,12 @@ auto RecordData::element(const std::string& name) const -> const Data&
     return *m_elements.at(name);
 }
 
+auto RecordData::find(const std::string& name) const -> const Data*
+{
+    auto const iter = m_elements.find(name);
+    return iter == m_elements.cend() ? nullptr : iter->second.get();
+}
+
 auto RecordData::element(const std::string& name) -> Data&
 {
     Expects(has(name));
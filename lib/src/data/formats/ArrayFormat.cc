@@ -1,12 +1,67 @@
 #include "FormatHelpers.h"
+#include <algorithm>
 #include <contracts/Contracts.h>
 #include <kaizo/data/DataReader.h>
 #include <kaizo/data/DataWriter.h>
 #include <kaizo/data/data/ArrayData.h>
+#include <kaizo/data/data/ColumnarData.h>
+#include <kaizo/data/data/DataArena.h>
+#include <kaizo/data/data/RecordData.h>
+#include <kaizo/data/formats/CompiledFormat.h>
 #include <kaizo/data/formats/ArrayFormat.h>
+#include <kaizo/data/formats/PointerFormat.h>
+#include <kaizo/utilities/Parallel.h>
 
 namespace kaizo::data {
 
+namespace {
+
+class ColumnSink
+{
+public:
+    explicit ColumnSink(ColumnarData& columns)
+        : m_columns{columns}
+    {
+    }
+
+    void signedInteger(int64_t value)
+    {
+        m_columns.column(m_field++).appendSigned(value);
+    }
+
+    void unsignedInteger(uint64_t value)
+    {
+        m_columns.column(m_field++).appendUnsigned(value);
+    }
+
+    void beginRecord()
+    {
+        m_field = 0;
+    }
+
+    void field(const std::string&)
+    {
+    }
+
+    void endRecord()
+    {
+    }
+
+    void beginArray(size_t)
+    {
+    }
+
+    void endArray()
+    {
+    }
+
+private:
+    ColumnarData& m_columns;
+    size_t m_field{0};
+};
+
+} // namespace
+
 void ArrayFormat::setSizeProvider(std::unique_ptr<ArraySizeProvider>&& sizeProvider)
 {
     Expects(sizeProvider);
@@ -17,6 +72,19 @@ void ArrayFormat::setElementFormat(std::unique_ptr<DataFormat>&& format)
 {
     Expects(format);
     m_elementFormat = std::move(format);
+
+    // elements made of nothing but integers need neither paths (they contain no pointers) nor
+    // sections (they skip no bytes) when encoded
+    m_denseElements = CompiledFormat::compile(*m_elementFormat);
+    if (m_denseElements && !m_denseElements->denseSize())
+    {
+        m_denseElements.reset();
+    }
+}
+
+void ArrayFormat::setThreadCount(size_t threads)
+{
+    m_threadCount = threads;
 }
 
 auto ArrayFormat::doDecode(DataReader& reader) -> std::unique_ptr<Data>
@@ -24,8 +92,13 @@ auto ArrayFormat::doDecode(DataReader& reader) -> std::unique_ptr<Data>
     Expects(m_sizeProvider);
     Expects(m_elementFormat);
 
-    auto arrayData = std::make_unique<ArrayData>();
     auto const size = m_sizeProvider->provideSize(reader);
+    if (m_threadCount != 1 && m_elementFormat->isPointer() && !reader.isTracking())
+    {
+        return decodePointees(reader, size);
+    }
+
+    auto arrayData = std::make_unique<ArrayData>();
     for (auto i = 0U; i < size; ++i)
     {
         reader.enter(DataPathElement::makeIndex(i + 1));
@@ -43,10 +116,150 @@ auto ArrayFormat::doDecode(DataReader& reader) -> std::unique_ptr<Data>
     return std::move(arrayData);
 }
 
+auto ArrayFormat::decodePointees(DataReader& reader, size_t size) -> std::unique_ptr<Data>
+{
+    auto& pointerFormat = static_cast<PointerFormat&>(*m_elementFormat);
+    std::vector<PointerFormat::Target> targets;
+    targets.reserve(size);
+    for (auto i = 0U; i < size; ++i)
+    {
+        if (auto const target = pointerFormat.decodeAddress(reader))
+        {
+            targets.push_back(*target);
+        }
+        else
+        {
+            return {};
+        }
+    }
+
+    // every batch gets its own reader and format copy; the readers' data structures are joined
+    // back in order afterwards
+    auto const threadCount = m_threadCount == 0 ? defaultThreadCount() : m_threadCount;
+    auto const batchCount = std::min<size_t>(size, threadCount * 4);
+    std::vector<std::unique_ptr<Data>> elements(size);
+    std::vector<std::unique_ptr<DataReader>> batchReaders(batchCount);
+    parallelFor(
+        batchCount,
+        [&](size_t batch) {
+            DataArena::Scope arena;
+            auto& batchReader = *(batchReaders[batch] = reader.fork());
+            auto const batchFormat = pointerFormat.copy();
+            auto& batchPointerFormat = static_cast<PointerFormat&>(*batchFormat);
+            for (auto i = batch * size / batchCount; i < (batch + 1) * size / batchCount; ++i)
+            {
+                batchReader.enter(DataPathElement::makeIndex(i + 1));
+                elements[i] = batchPointerFormat.decodeTarget(batchReader, targets[i]);
+                batchReader.leave(elements[i].get());
+            }
+        },
+        threadCount);
+
+    if (std::any_of(elements.cbegin(), elements.cend(), [](auto const& data) { return !data; }))
+    {
+        return {};
+    }
+    for (auto const& batchReader : batchReaders)
+    {
+        reader.join(*batchReader);
+    }
+    auto arrayData = std::make_unique<ArrayData>();
+    for (auto& element : elements)
+    {
+        arrayData->append(std::move(element));
+    }
+    return arrayData;
+}
+
+auto ArrayFormat::decodeColumnar(DataReader& reader) -> std::unique_ptr<ColumnarData>
+{
+    Expects(m_sizeProvider);
+    Expects(m_elementFormat);
+
+    auto columns = m_elementFormat->makeColumns();
+    if (!columns)
+    {
+        return {};
+    }
+
+    beginDecode(reader);
+    auto const size = m_sizeProvider->provideSize(reader);
+    columns->reserve(size);
+    if (auto const program = CompiledFormat::compile(*m_elementFormat))
+    {
+        // integer-only records stream straight into the columns without intermediate Data
+        ColumnSink sink{*columns};
+        auto offset = reader.offset();
+        for (auto i = 0U; i < size; ++i)
+        {
+            offset = program->run(reader.binary(), offset, sink);
+        }
+        reader.setOffset(offset);
+    }
+    else
+    {
+        for (auto i = 0U; i < size; ++i)
+        {
+            reader.enter(DataPathElement::makeIndex(i + 1));
+            auto data = m_elementFormat->decode(reader);
+            reader.leave(nullptr);
+            if (!data)
+            {
+                return {};
+            }
+            columns->appendRow(*data);
+        }
+    }
+    endDecode(reader);
+    return columns;
+}
+
+auto ArrayFormat::decodeLazy(DataReader& reader) -> std::unique_ptr<LazyArray>
+{
+    Expects(m_sizeProvider);
+    Expects(m_elementFormat);
+
+    beginDecode(reader);
+    auto const size = m_sizeProvider->provideSize(reader);
+    auto lazyArray =
+        std::make_unique<LazyArray>(reader, m_elementFormat->copy(), reader.offset(), size);
+    if (auto const stride = lazyArray->stride())
+    {
+        auto const end = reader.offset() + size * *stride;
+        if (end > reader.dataSize())
+        {
+            throw std::runtime_error{"ArrayFormat: array exceeds binary"};
+        }
+        reader.setOffset(end);
+        endDecode(reader);
+    }
+    return lazyArray;
+}
+
 void ArrayFormat::doEncode(DataWriter& writer, const Data& data)
 {
+    if (data.type() == DataType::Columnar)
+    {
+        auto const& columnarData = static_cast<const ColumnarData&>(data);
+        if (encodeDense(writer, columnarData))
+        {
+            return;
+        }
+        for (auto i = 0U; i < columnarData.rowCount(); ++i)
+        {
+            writer.enter(DataPathElement::makeIndex(i + 1));
+            m_elementFormat->encode(writer, *columnarData.row(i));
+            writer.leave();
+        }
+        return;
+    }
+
     expectDataType(DataType::Array, data, writer.path());
     auto const& arrayData = static_cast<const ArrayData&>(data);
+    if (encodeDense(writer, arrayData))
+    {
+        return;
+    }
 
     for (auto i = 0U; i < arrayData.elementCount(); ++i)
     {
@@ -56,9 +269,83 @@ void ArrayFormat::doEncode(DataWriter& writer, const Data& data)
     }
 }
 
+bool ArrayFormat::encodeDense(DataWriter& writer, const ArrayData& data) const
+{
+    if (!m_denseElements || data.elementCount() == 0)
+    {
+        return false;
+    }
+
+    auto& binary = writer.binary();
+    auto const offset = binary.size();
+    binary.resize(offset + data.elementCount() * *m_denseElements->denseSize());
+    if (!m_denseElements->encode(data, binary.data(offset)))
+    {
+        // let the regular encoding report the mismatch
+        binary.resize(offset);
+        return false;
+    }
+    return true;
+}
+
+bool ArrayFormat::encodeDense(DataWriter& writer, const ColumnarData& data) const
+{
+    if (!m_denseElements || data.rowCount() == 0)
+    {
+        return false;
+    }
+
+    auto& binary = writer.binary();
+    auto const offset = binary.size();
+    binary.resize(offset + data.rowCount() * *m_denseElements->denseSize());
+    if (!m_denseElements->encode(data, binary.data(offset)))
+    {
+        binary.resize(offset);
+        return false;
+    }
+    return true;
+}
+
+bool ArrayFormat::doCompile(CompiledFormat& program) const
+{
+    if (!m_sizeProvider || !m_elementFormat)
+    {
+        return false;
+    }
+    auto const size = m_sizeProvider->fixedSize();
+    if (!size)
+    {
+        return false;
+    }
+    program.beginArray(*size);
+    if (!m_elementFormat->compile(program))
+    {
+        return false;
+    }
+    program.endArray();
+    return true;
+}
+
+auto ArrayFormat::doFixedSize() const -> std::optional<size_t>
+{
+    if (!m_sizeProvider || !m_elementFormat)
+    {
+        return {};
+    }
+    auto const size = m_sizeProvider->fixedSize();
+    auto const elementSize = m_elementFormat->fixedSize();
+    if (!size || !elementSize)
+    {
+        return {};
+    }
+    return *size * *elementSize;
+}
+
 ArrayFormat::ArrayFormat(const ArrayFormat& other)
     : DataFormat{other}
     , m_elementFormat{other.m_elementFormat->copy()}
+    , m_denseElements{other.m_denseElements}
+    , m_threadCount{other.m_threadCount}
 {
     if (other.m_sizeProvider)
     {
@@ -0,0 +1,436 @@
+#include <contracts/Contracts.h>
+#include <kaizo/data/DataReader.h>
+#include <kaizo/data/data/ArrayData.h>
+#include <kaizo/data/data/ColumnarData.h>
+#include <kaizo/data/data/IntegerData.h>
+#include <kaizo/data/data/RecordData.h>
+#include <kaizo/data/formats/CompiledFormat.h>
+#include <kaizo/data/formats/DataFormat.h>
+#include <utility>
+
+namespace kaizo::data {
+
+namespace {
+
+class DataBuilder
+{
+public:
+    void signedInteger(int64_t value)
+    {
+        emit(std::make_unique<IntegerData>(value));
+    }
+
+    void unsignedInteger(uint64_t value)
+    {
+        emit(std::make_unique<IntegerData>(value));
+    }
+
+    void beginRecord()
+    {
+        m_stack.push_back(Frame{std::make_unique<RecordData>(), {}});
+    }
+
+    void field(const std::string& name)
+    {
+        m_stack.back().field = &name;
+    }
+
+    void endRecord()
+    {
+        close();
+    }
+
+    void beginArray(size_t)
+    {
+        m_stack.push_back(Frame{std::make_unique<ArrayData>(), {}});
+    }
+
+    void endArray()
+    {
+        close();
+    }
+
+    auto result() -> std::unique_ptr<Data>
+    {
+        return std::move(m_result);
+    }
+
+private:
+    void close()
+    {
+        auto data = std::move(m_stack.back().data);
+        m_stack.pop_back();
+        emit(std::move(data));
+    }
+
+    void emit(std::unique_ptr<Data>&& data)
+    {
+        if (m_stack.empty())
+        {
+            m_result = std::move(data);
+        }
+        else if (auto& top = m_stack.back(); top.field)
+        {
+            static_cast<RecordData&>(*top.data).set(*top.field, std::move(data));
+        }
+        else
+        {
+            static_cast<ArrayData&>(*top.data).append(std::move(data));
+        }
+    }
+
+    struct Frame
+    {
+        std::unique_ptr<Data> data;
+        const std::string* field{nullptr};
+    };
+
+    std::vector<Frame> m_stack;
+    std::unique_ptr<Data> m_result;
+};
+
+} // namespace
+
+auto CompiledFormat::compile(const DataFormat& format) -> std::optional<CompiledFormat>
+{
+    CompiledFormat program;
+    if (format.compile(program))
+    {
+        Expects(program.m_openArrays.empty());
+        program.flush();
+        return program;
+    }
+    return {};
+}
+
+void CompiledFormat::appendInteger(const IntegerLayout& layout)
+{
+    Expects(layout.sizeInBytes > 0 && layout.sizeInBytes <= 8);
+    Operation operation{Code::Integer};
+    operation.size = static_cast<uint8_t>(layout.sizeInBytes);
+    operation.isSigned = layout.signedness == Signedness::Signed;
+    operation.isBigEndian = layout.endianness == Endianness::Big;
+    operation.argument = m_pending;
+    m_operations.push_back(operation);
+    m_pending += layout.sizeInBytes;
+}
+
+void CompiledFormat::appendSkip(size_t size)
+{
+    m_pending += size;
+}
+
+void CompiledFormat::appendAlign(size_t alignment)
+{
+    Expects(alignment > 0);
+    flush();
+    Operation operation{Code::Align};
+    operation.argument = alignment;
+    m_operations.push_back(operation);
+}
+
+void CompiledFormat::beginRecord()
+{
+    m_operations.push_back(Operation{Code::BeginRecord});
+}
+
+void CompiledFormat::appendField(const std::string& name)
+{
+    Operation operation{Code::Field};
+    operation.argument = m_names.size();
+    m_names.push_back(name);
+    m_operations.push_back(operation);
+}
+
+void CompiledFormat::endRecord()
+{
+    m_operations.push_back(Operation{Code::EndRecord});
+}
+
+void CompiledFormat::beginArray(size_t count)
+{
+    flush();
+    Operation operation{Code::BeginArray};
+    operation.argument = count;
+    m_openArrays.push_back(m_operations.size());
+    m_operations.push_back(operation);
+}
+
+void CompiledFormat::endArray()
+{
+    Expects(!m_openArrays.empty());
+    flush();
+    auto const begin = m_openArrays.back();
+    m_openArrays.pop_back();
+
+    Operation operation{Code::EndArray};
+    operation.jump = static_cast<uint32_t>(begin);
+    m_operations[begin].jump = static_cast<uint32_t>(m_operations.size());
+    m_operations.push_back(operation);
+}
+
+void CompiledFormat::flush()
+{
+    if (m_pending > 0)
+    {
+        Operation operation{Code::Advance};
+        operation.argument = m_pending;
+        m_operations.push_back(operation);
+        m_pending = 0;
+    }
+}
+
+auto CompiledFormat::operations() const -> const std::vector<Operation>&
+{
+    return m_operations;
+}
+
+auto CompiledFormat::fixedSize() const -> std::optional<size_t>
+{
+    size_t index{0};
+    return measure(index);
+}
+
+auto CompiledFormat::measure(size_t& index) const -> std::optional<size_t>
+{
+    size_t size{0};
+    for (; index < m_operations.size(); ++index)
+    {
+        auto const& operation = m_operations[index];
+        switch (operation.code)
+        {
+        case Code::Advance: size += operation.argument; break;
+        case Code::Align: return {};
+        case Code::BeginArray:
+        {
+            ++index;
+            auto const elementSize = measure(index);
+            if (!elementSize)
+            {
+                return {};
+            }
+            size += operation.argument * *elementSize;
+            break;
+        }
+        case Code::EndArray: return size;
+        default: break;
+        }
+    }
+    return size;
+}
+
+auto CompiledFormat::denseSize() const -> std::optional<size_t>
+{
+    size_t index{0};
+    auto const size = fixedSize();
+    if (size && *size == measureIntegers(index))
+    {
+        return size;
+    }
+    return {};
+}
+
+auto CompiledFormat::measureIntegers(size_t& index) const -> size_t
+{
+    size_t size{0};
+    for (; index < m_operations.size(); ++index)
+    {
+        auto const& operation = m_operations[index];
+        switch (operation.code)
+        {
+        case Code::Integer: size += operation.size; break;
+        case Code::BeginArray:
+            ++index;
+            size += operation.argument * measureIntegers(index);
+            break;
+        case Code::EndArray: return size;
+        default: break;
+        }
+    }
+    return size;
+}
+
+auto CompiledFormat::decode(const BinaryView& binary, size_t offset) const
+    -> std::pair<std::unique_ptr<Data>, size_t>
+{
+    DataBuilder builder;
+    auto const end = run(binary, offset, builder);
+    return std::make_pair(builder.result(), end);
+}
+
+auto CompiledFormat::decode(DataReader& reader) const -> std::unique_ptr<Data>
+{
+    auto [data, end] = decode(reader.binary(), reader.offset());
+    reader.setOffset(end);
+    return std::move(data);
+}
+
+bool CompiledFormat::encode(const ArrayData& array, uint8_t* output) const
+{
+    auto const elementSize = denseSize();
+    Expects(elementSize);
+
+    std::vector<EncodeFrame> stack;
+    for (auto i = 0U; i < array.elementCount(); ++i, output += *elementSize)
+    {
+        if (!encode(array.element(i), output, stack))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompiledFormat::encode(const ColumnarData& columns, uint8_t* output) const
+{
+    auto const stride = denseSize();
+    Expects(stride);
+    if (m_operations.empty() || m_operations.front().code != Code::BeginRecord)
+    {
+        return false;
+    }
+
+    // each field is written for all rows at once, straight from its column's contiguous values
+    auto const encodeColumn = [&](const auto* values, const Operation& operation, uint8_t* data) {
+        for (auto row = 0U; row < columns.rowCount(); ++row, data += *stride)
+        {
+            writeInteger(data, operation, static_cast<uint64_t>(values[row]));
+        }
+    };
+
+    size_t offset{0};
+    const std::string* field{nullptr};
+    for (size_t pc = 0; pc < m_operations.size(); ++pc)
+    {
+        auto const& operation = m_operations[pc];
+        switch (operation.code)
+        {
+        case Code::BeginRecord:
+            if (pc != 0)
+            {
+                return false;
+            }
+            break;
+        case Code::EndRecord: break;
+        case Code::Field: field = &m_names[operation.argument]; break;
+        case Code::Advance: offset += operation.argument; break;
+        case Code::Integer:
+        {
+            if (!columns.hasColumn(*field) || columns.column(*field).isString())
+            {
+                return false;
+            }
+            auto const& column = columns.column(*field);
+            auto* data = output + offset + operation.argument;
+            switch (column.type())
+            {
+            case ColumnarData::ColumnType::Int32:
+                encodeColumn(static_cast<const int32_t*>(column.data()), operation, data);
+                break;
+            case ColumnarData::ColumnType::UInt32:
+                encodeColumn(static_cast<const uint32_t*>(column.data()), operation, data);
+                break;
+            case ColumnarData::ColumnType::Int64:
+                encodeColumn(static_cast<const int64_t*>(column.data()), operation, data);
+                break;
+            case ColumnarData::ColumnType::UInt64:
+                encodeColumn(static_cast<const uint64_t*>(column.data()), operation, data);
+                break;
+            default: return false;
+            }
+            break;
+        }
+        default: return false;
+        }
+    }
+    return true;
+}
+
+bool CompiledFormat::encode(const Data& data, uint8_t* output,
+                            std::vector<EncodeFrame>& stack) const
+{
+    stack.clear();
+    bool isRootConsumed{false};
+
+    // the value the next operation encodes, in the order the DataBuilder would have decoded it
+    auto const next = [&]() -> const Data* {
+        if (stack.empty())
+        {
+            return std::exchange(isRootConsumed, true) ? nullptr : &data;
+        }
+        auto& top = stack.back();
+        if (top.field)
+        {
+            return static_cast<const RecordData&>(*top.data).find(*top.field);
+        }
+        auto const& array = static_cast<const ArrayData&>(*top.data);
+        return top.index < array.elementCount() ? &array.element(top.index++) : nullptr;
+    };
+
+    size_t offset{0};
+    for (size_t pc = 0; pc < m_operations.size(); ++pc)
+    {
+        auto const& operation = m_operations[pc];
+        switch (operation.code)
+        {
+        case Code::Integer:
+        {
+            auto const* value = next();
+            if (!value || value->type() != DataType::Integer)
+            {
+                return false;
+            }
+            auto const& integer = static_cast<const IntegerData&>(*value);
+            writeInteger(output + offset + operation.argument, operation,
+                         operation.isSigned ? static_cast<uint64_t>(integer.asSigned())
+                                            : integer.asUnsigned());
+            break;
+        }
+        case Code::Advance: offset += operation.argument; break;
+        case Code::Align: return false;
+        case Code::BeginRecord:
+        {
+            auto const* value = next();
+            if (!value || value->type() != DataType::Record)
+            {
+                return false;
+            }
+            stack.push_back(EncodeFrame{value});
+            break;
+        }
+        case Code::Field: stack.back().field = &m_names[operation.argument]; break;
+        case Code::EndRecord: stack.pop_back(); break;
+        case Code::BeginArray:
+        {
+            auto const* value = next();
+            if (!value || value->type() != DataType::Array ||
+                static_cast<const ArrayData&>(*value).elementCount() != operation.argument)
+            {
+                return false;
+            }
+            if (operation.argument == 0)
+            {
+                pc = operation.jump;
+            }
+            else
+            {
+                stack.push_back(EncodeFrame{value});
+            }
+            break;
+        }
+        case Code::EndArray:
+            if (stack.back().index < m_operations[operation.jump].argument)
+            {
+                pc = operation.jump;
+            }
+            else
+            {
+                stack.pop_back();
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace kaizo::data
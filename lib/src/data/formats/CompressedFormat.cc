@@ -0,0 +1,64 @@
+#include <contracts/Contracts.h>
+#include <kaizo/data/DataReader.h>
+#include <kaizo/data/DataWriter.h>
+#include <kaizo/data/data/Data.h>
+#include <kaizo/data/formats/CompressedFormat.h>
+#include <stdexcept>
+
+namespace kaizo::data {
+
+void CompressedFormat::setCodec(std::unique_ptr<Codec>&& codec)
+{
+    m_codec = std::move(codec);
+}
+
+void CompressedFormat::setInnerFormat(std::unique_ptr<DataFormat>&& format)
+{
+    m_innerFormat = std::move(format);
+}
+
+auto CompressedFormat::doDecode(DataReader& reader) -> std::unique_ptr<Data>
+{
+    Expects(m_codec && m_innerFormat);
+
+    auto const& binary = reader.binary();
+    auto [decompressed, size] = m_codec->decompress(
+        BinaryView{binary.data(reader.offset()), binary.size() - reader.offset()});
+    DataReader innerReader{std::move(decompressed)};
+    auto data = m_innerFormat->decode(innerReader);
+
+    track(reader, reader.offset(), size);
+    reader.advance(size);
+    return data;
+}
+
+void CompressedFormat::doEncode(DataWriter& writer, const Data& data)
+{
+    Expects(m_codec && m_innerFormat);
+
+    DataWriter innerWriter;
+    innerWriter.startData(writer.path());
+    m_innerFormat->encode(innerWriter, data);
+    innerWriter.finishData();
+    auto const inner = innerWriter.assemble();
+    if (inner.objectCount() != 1 || inner.object(0)->unresolvedReferenceCount() > 0)
+    {
+        throw std::runtime_error{"CompressedFormat: compressed data cannot contain pointers"};
+    }
+
+    writer.binary() += m_codec->compress(inner.binary());
+}
+
+CompressedFormat::CompressedFormat(const CompressedFormat& other)
+    : DataFormat{other}
+    , m_codec{other.m_codec ? other.m_codec->copy() : nullptr}
+    , m_innerFormat{other.m_innerFormat ? other.m_innerFormat->copy() : nullptr}
+{
+}
+
+auto CompressedFormat::copy() const -> std::unique_ptr<DataFormat>
+{
+    return std::unique_ptr<CompressedFormat>{new CompressedFormat{*this}};
+}
+
+} // namespace kaizo::data
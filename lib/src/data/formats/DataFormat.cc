@@ -1,7 +1,10 @@
 #include <contracts/Contracts.h>
 #include <kaizo/data/DataReader.h>
 #include <kaizo/data/DataWriter.h>
+#include <kaizo/data/data/ColumnarData.h>
 #include <kaizo/data/data/Data.h>
+#include <kaizo/data/data/DataArena.h>
+#include <kaizo/data/formats/CompiledFormat.h>
 #include <kaizo/data/formats/DataFormat.h>
 
 namespace kaizo::data {
@@ -28,6 +31,15 @@ void DataFormat::setSkipBefore(size_t size)
 }
 
 auto DataFormat::decode(DataReader& reader) -> std::unique_ptr<Data>
+{
+    DataArena::Scope arena;
+    beginDecode(reader);
+    auto data = doDecode(reader);
+    endDecode(reader);
+    return data;
+}
+
+void DataFormat::beginDecode(DataReader& reader) const
 {
     auto const unalignedOffset = m_skipBefore + (m_offset ? *m_offset : reader.offset());
     if (unalignedOffset % m_alignment != 0)
@@ -38,9 +50,11 @@ auto DataFormat::decode(DataReader& reader) -> std::unique_ptr<Data>
     {
         reader.setOffset(unalignedOffset);
     }
-    auto data = doDecode(reader);
+}
+
+void DataFormat::endDecode(DataReader& reader) const
+{
     reader.setOffset(reader.offset() + m_skipAfter);
-    return std::move(data);
 }
 
 void DataFormat::encode(DataWriter& writer, const Data& data)
@@ -49,12 +63,53 @@ void DataFormat::encode(DataWriter& writer, const Data& data)
     {
         writer.startNewObject(*m_offset);
     }
-    // TODO: alignment
     writer.skip(m_skipBefore);
+    if (m_alignment > 1)
+    {
+        // only the object's alignment is recorded; the bytes skipped inside it are left untouched
+        writer.align(m_alignment);
+    }
     doEncode(writer, data);
     writer.skip(m_skipAfter);
 }
 
+bool DataFormat::compile(CompiledFormat& program) const
+{
+    if (m_offset || m_trackTag)
+    {
+        return false;
+    }
+    program.appendSkip(m_skipBefore);
+    if (m_alignment > 1)
+    {
+        program.appendAlign(m_alignment);
+    }
+    if (!doCompile(program))
+    {
+        return false;
+    }
+    program.appendSkip(m_skipAfter);
+    return true;
+}
+
+auto DataFormat::fixedSize() const -> std::optional<size_t>
+{
+    if (m_offset || m_alignment > 1)
+    {
+        return {};
+    }
+    if (auto const size = doFixedSize())
+    {
+        return m_skipBefore + *size + m_skipAfter;
+    }
+    return {};
+}
+
+auto DataFormat::makeColumns() const -> std::unique_ptr<ColumnarData>
+{
+    return {};
+}
+
 void DataFormat::track(DataReader& reader, size_t offset, size_t size)
 {
     if (m_trackTag)
@@ -1,7 +1,9 @@
 #include <contracts/Contracts.h>
 #include <kaizo/data/DataReader.h>
 #include <kaizo/data/DataWriter.h>
+#include <kaizo/data/data/ColumnarData.h>
 #include <kaizo/data/data/IntegerData.h>
+#include <kaizo/data/formats/CompiledFormat.h>
 #include <kaizo/data/formats/IntegerFormat.h>
 
 namespace kaizo::data {
@@ -117,6 +119,39 @@ auto IntegerFormat::layout() const -> const IntegerLayout&
     return m_layout;
 }
 
+bool IntegerFormat::doCompile(CompiledFormat& program) const
+{
+    if (sizeInBytes() > 8)
+    {
+        return false;
+    }
+    program.appendInteger(m_layout);
+    return true;
+}
+
+bool IntegerFormat::addColumn(ColumnarData& columns, const std::string& name) const
+{
+    using ColumnType = ColumnarData::ColumnType;
+    if (sizeInBytes() > 8)
+    {
+        return false;
+    }
+    else if (sizeInBytes() > 4)
+    {
+        columns.addColumn(name, isSigned() ? ColumnType::Int64 : ColumnType::UInt64);
+    }
+    else
+    {
+        columns.addColumn(name, isSigned() ? ColumnType::Int32 : ColumnType::UInt32);
+    }
+    return true;
+}
+
+auto IntegerFormat::doFixedSize() const -> std::optional<size_t>
+{
+    return sizeInBytes();
+}
+
 IntegerFormat::IntegerFormat(const IntegerFormat& other)
     : DataFormat{other}
     , m_layout{other.m_layout}
@@ -0,0 +1,103 @@
+#include <contracts/Contracts.h>
+#include <kaizo/data/DataReader.h>
+#include <kaizo/data/data/ArrayData.h>
+#include <kaizo/data/formats/DataFormat.h>
+#include <kaizo/data/formats/LazyArray.h>
+#include <stdexcept>
+#include <string>
+
+namespace kaizo::data {
+
+LazyArray::LazyArray(DataReader& reader, std::unique_ptr<DataFormat>&& elementFormat,
+                     size_t offset, size_t size)
+    : m_reader{&reader}
+    , m_elementFormat{std::move(elementFormat)}
+    , m_offset{offset}
+    , m_elements(size)
+{
+    Expects(m_elementFormat);
+    m_stride = m_elementFormat->fixedSize();
+    if (!m_stride)
+    {
+        m_offsets.push_back(offset);
+    }
+}
+
+LazyArray::~LazyArray() = default;
+
+auto LazyArray::elementCount() const -> size_t
+{
+    return m_elements.size();
+}
+
+auto LazyArray::offset() const -> size_t
+{
+    return m_offset;
+}
+
+auto LazyArray::stride() const -> std::optional<size_t>
+{
+    return m_stride;
+}
+
+bool LazyArray::isDecoded(size_t index) const
+{
+    Expects(index < elementCount());
+    return m_elements[index] != nullptr;
+}
+
+auto LazyArray::element(size_t index) -> const Data&
+{
+    Expects(index < elementCount());
+    if (!m_elements[index])
+    {
+        decode(index, elementOffset(index));
+    }
+    return *m_elements[index];
+}
+
+auto LazyArray::materialize() -> std::unique_ptr<ArrayData>
+{
+    auto array = std::make_unique<ArrayData>();
+    for (auto i = 0U; i < elementCount(); ++i)
+    {
+        array->append(element(i).copy());
+    }
+    return array;
+}
+
+auto LazyArray::elementOffset(size_t index) -> size_t
+{
+    if (m_stride)
+    {
+        return m_offset + index * *m_stride;
+    }
+    // the end of each decoded element is the start of the next one
+    while (m_offsets.size() <= index)
+    {
+        auto const previous = m_offsets.size() - 1;
+        decode(previous, m_offsets.back());
+    }
+    return m_offsets[index];
+}
+
+void LazyArray::decode(size_t index, size_t offset)
+{
+    auto const oldOffset = m_reader->offset();
+    m_reader->setOffset(offset);
+    m_reader->enter(DataPathElement::makeIndex(index + 1));
+    auto data = m_elementFormat->decode(*m_reader);
+    m_reader->leave(data.get());
+    if (!m_stride && m_offsets.size() == index + 1)
+    {
+        m_offsets.push_back(m_reader->offset());
+    }
+    m_reader->setOffset(oldOffset);
+    if (!data)
+    {
+        throw std::runtime_error{"LazyArray: could not decode element " + std::to_string(index)};
+    }
+    m_elements[index] = std::move(data);
+}
+
+} // namespace kaizo::data
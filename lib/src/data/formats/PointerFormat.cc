@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <contracts/Contracts.h>
 #include <kaizo/addresses/AddressFormat.h>
 #include <kaizo/data/DataReader.h>
@@ -61,66 +62,93 @@ void PointerFormat::setLayout(std::unique_ptr<AddressLayout>&& layout)
     m_layout = std::shared_ptr<AddressLayout>(layout.release());
 }
 
+auto PointerFormat::decodeAddress(DataReader& reader) -> std::optional<Target>
+{
+    beginDecode(reader);
+    auto target = readTarget(reader);
+    endDecode(reader);
+    return target;
+}
+
+auto PointerFormat::decodeTarget(DataReader& reader, const Target& target) -> std::unique_ptr<Data>
+{
+    Expects(m_pointedFormat);
+    if (!target.offset)
+    {
+        return std::make_unique<NullData>();
+    }
+
+    auto const oldOffset = reader.offset();
+    reader.setOffset(*target.offset);
+    if (auto data = m_pointedFormat->decode(reader))
+    {
+        reader.setOffset(oldOffset);
+        return data;
+    }
+    return {};
+}
+
 auto PointerFormat::doDecode(DataReader& reader) -> std::unique_ptr<Data>
+{
+    if (auto const target = readTarget(reader))
+    {
+        return decodeTarget(reader, *target);
+    }
+    return {};
+}
+
+auto PointerFormat::readTarget(DataReader& reader) -> std::optional<Target>
 {
     Expects(m_addressFormat);
     Expects(m_pointedFormat);
 
     auto const pointerOffset = reader.offset();
-    if (auto maybeAddress = readAddress(reader))
+    auto const maybeAddress = readAddress(reader);
+    if (!maybeAddress)
     {
-        if (!m_nullPointer || !(*maybeAddress == *m_nullPointer))
+        return {};
+    }
+    if (m_nullPointer && *maybeAddress == *m_nullPointer)
+    {
+        return Target{};
+    }
+
+    uint64_t newOffset;
+    if (m_useAddressMap)
+    {
+        auto const addresses = reader.addressMap().toSourceAddresses(*maybeAddress);
+        if (addresses.size() == 1)
+        {
+            newOffset = addresses.front().toInteger();
+        }
+        else if (addresses.empty())
         {
-            auto const oldOffset = reader.offset();
-            uint64_t newOffset;
-            if (m_useAddressMap)
-            {
-                auto const addresses = reader.addressMap().toSourceAddresses(*maybeAddress);
-                if (addresses.size() == 1)
-                {
-                    newOffset = addresses.front().toInteger();
-                }
-                else if (addresses.empty())
-                {
-                    throw std::runtime_error{"Error decoding pointer at offset " +
-                                             std::to_string(pointerOffset) + " using '" +
-                                             m_layout->getName() + "'; could not map address " +
-                                             maybeAddress->toString()};
-                }
-                else
-                {
-                    throw std::runtime_error{"error decoding pointer at offset " +
-                                             std::to_string(pointerOffset) + "address " +
-                                             maybeAddress->toString() +
-                                             " maps to more than one source address"};
-                }
-            }
-            else
-            {
-                newOffset = maybeAddress->toInteger();
-            }
-
-            if (newOffset >= reader.dataSize())
-            {
-                throw std::runtime_error{"error decoding pointer at offset " +
-                                         std::to_string(pointerOffset) + ": address " +
-                                         maybeAddress->toString() + " maps to invalid offset " +
-                                         std::to_string(newOffset)};
-            }
-
-            reader.setOffset(newOffset);
-            if (auto data = m_pointedFormat->decode(reader))
-            {
-                reader.setOffset(oldOffset);
-                return std::move(data);
-            }
+            throw std::runtime_error{"Error decoding pointer at offset " +
+                                     std::to_string(pointerOffset) + " using '" +
+                                     m_layout->getName() + "'; could not map address " +
+                                     maybeAddress->toString()};
         }
         else
         {
-            return std::make_unique<NullData>();
+            throw std::runtime_error{"error decoding pointer at offset " +
+                                     std::to_string(pointerOffset) + "address " +
+                                     maybeAddress->toString() +
+                                     " maps to more than one source address"};
         }
     }
-    return {};
+    else
+    {
+        newOffset = maybeAddress->toInteger();
+    }
+
+    if (newOffset >= reader.dataSize())
+    {
+        throw std::runtime_error{"error decoding pointer at offset " +
+                                 std::to_string(pointerOffset) + ": address " +
+                                 maybeAddress->toString() + " maps to invalid offset " +
+                                 std::to_string(newOffset)};
+    }
+    return Target{newOffset};
 }
 
 void PointerFormat::doEncode(DataWriter& writer, const Data& data)
@@ -159,6 +187,24 @@ void PointerFormat::doEncode(DataWriter& writer, const Data& data)
     }
 }
 
+auto PointerFormat::doFixedSize() const -> std::optional<size_t>
+{
+    if (!m_layout)
+    {
+        return {};
+    }
+    size_t size{0};
+    for (auto const& patch : m_layout->writePlaceHolder())
+    {
+        if (patch.relativeOffset() < 0)
+        {
+            return {};
+        }
+        size = std::max(size, static_cast<size_t>(patch.relativeOffset()) + patch.size());
+    }
+    return size;
+}
+
 bool PointerFormat::hasNullPointer() const
 {
     return m_nullPointer.has_value();
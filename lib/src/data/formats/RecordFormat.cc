@@ -3,7 +3,9 @@
 #include <contracts/Contracts.h>
 #include <kaizo/data/DataReader.h>
 #include <kaizo/data/DataWriter.h>
+#include <kaizo/data/data/ColumnarData.h>
 #include <kaizo/data/data/RecordData.h>
+#include <kaizo/data/formats/CompiledFormat.h>
 #include <kaizo/data/formats/RecordFormat.h>
 
 namespace kaizo::data {
@@ -76,6 +78,49 @@ void RecordFormat::doEncode(DataWriter& writer, const Data& data)
     }
 }
 
+auto RecordFormat::makeColumns() const -> std::unique_ptr<ColumnarData>
+{
+    auto columns = std::make_unique<ColumnarData>();
+    for (auto const& element : m_elements)
+    {
+        if (!element.format->addColumn(*columns, element.name))
+        {
+            return {};
+        }
+    }
+    return columns;
+}
+
+bool RecordFormat::doCompile(CompiledFormat& program) const
+{
+    program.beginRecord();
+    for (auto const& element : m_elements)
+    {
+        program.appendField(element.name);
+        if (!element.format->compile(program))
+        {
+            return false;
+        }
+    }
+    program.endRecord();
+    return true;
+}
+
+auto RecordFormat::doFixedSize() const -> std::optional<size_t>
+{
+    size_t size{0};
+    for (auto const& element : m_elements)
+    {
+        auto const elementSize = element.format->fixedSize();
+        if (!elementSize)
+        {
+            return {};
+        }
+        size += *elementSize;
+    }
+    return size;
+}
+
 RecordFormat::RecordFormat(const RecordFormat& other)
     : DataFormat{other}
 {
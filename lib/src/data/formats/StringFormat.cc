@@ -2,6 +2,7 @@
 #include <contracts/Contracts.h>
 #include <kaizo/data/DataReader.h>
 #include <kaizo/data/DataWriter.h>
+#include <kaizo/data/data/ColumnarData.h>
 #include <kaizo/data/data/StringData.h>
 #include <kaizo/data/formats/StringFormat.h>
 
@@ -22,6 +23,12 @@ void StringFormat::setFixedLength(size_t length)
     m_fixedLength = length;
 }
 
+bool StringFormat::addColumn(ColumnarData& columns, const std::string& name) const
+{
+    columns.addColumn(name, ColumnarData::ColumnType::String);
+    return true;
+}
+
 auto StringFormat::doDecode(DataReader& reader) -> std::unique_ptr<Data>
 {
     Expects(m_encoding);
@@ -67,6 +74,11 @@ void StringFormat::doEncode(DataWriter& writer, const Data& data)
     writer.binary().append(binary);
 }
 
+auto StringFormat::doFixedSize() const -> std::optional<size_t>
+{
+    return m_fixedLength;
+}
+
 auto StringFormat::copy() const -> std::unique_ptr<DataFormat>
 {
     return std::unique_ptr<StringFormat>{new StringFormat{*this}};
@@ -1,11 +1,14 @@
 #include "kaizo/data/linking/Backtracker.h"
+#include "kaizo/data/linking/GreedyPacker.h"
 #include <algorithm>
 #include <contracts/Contracts.h>
-#include <iostream>
+#include <stdexcept>
 #include <type_traits>
 
 namespace kaizo::data {
 
+using EventKind = PackingTrace::EventKind;
+
 static auto defaultScoringStrategy(const FreeSpace& space, const LinkObject& object) -> long long
 {
     auto const slack = object.measureSlack(space);
@@ -15,12 +18,14 @@ static auto defaultScoringStrategy(const FreeSpace& space, const LinkObject& obj
 
 PriorityObjectList::PriorityObjectList()
     : m_scoreObject{&defaultScoringStrategy}
+    , m_feasibility{nullptr}
 {
 }
 
 PriorityObjectList::PriorityObjectList(const FreeSpace* freeSpace)
     : m_freeSpace{freeSpace}
     , m_scoreObject{&defaultScoringStrategy}
+    , m_feasibility{freeSpace}
 {
 }
 
@@ -33,6 +38,14 @@ void PriorityObjectList::addObject(LinkObject* object)
         std::upper_bound(m_unmapped.begin(), m_unmapped.end(), score,
                          [](auto const& score, auto const& b) { return score < b.score; }),
         ScoredObject{score, object});
+    m_feasibility.addObject(object);
+}
+
+void PriorityObjectList::clear()
+{
+    m_unmapped.clear();
+    m_mapped.clear();
+    m_feasibility.clear();
 }
 
 void PriorityObjectList::setScoringStrategy(ScoreObjectStrategy strategy)
@@ -44,6 +57,7 @@ auto PriorityObjectList::mapNext()
 {
     m_mapped.push_back(m_unmapped.back());
     m_unmapped.pop_back();
+    m_feasibility.setWaiting(m_mapped.back().object, false);
     // TODO: sort again? expensive, but better results?
 }
 
@@ -51,6 +65,7 @@ auto PriorityObjectList::unmapLast()
 {
     m_unmapped.push_back(m_mapped.back());
     m_mapped.pop_back();
+    m_feasibility.setWaiting(m_unmapped.back().object, true);
     // TODO: sort again?
 }
 
@@ -59,17 +74,14 @@ auto PriorityObjectList::nextUnmapped() const -> LinkObject*
     return m_unmapped.back().object;
 }
 
-bool PriorityObjectList::canBeSatisfied() const
+bool PriorityObjectList::canBeSatisfied()
 {
-    for (auto i = 0U; i < m_unmapped.size(); ++i)
-    {
-        auto const* object = m_unmapped[m_unmapped.size() - 1 - i].object;
-        if (!object->hasAllocations(*m_freeSpace))
-        {
-            return false;
-        }
-    }
-    return true;
+    return m_feasibility.isFeasible();
+}
+
+auto PriorityObjectList::feasibility() -> FeasibilityTracker&
+{
+    return m_feasibility;
 }
 
 void PriorityObjectList::resortUnmappedObjects()
@@ -108,118 +120,221 @@ void BacktrackingPacker::setScoringStrategy(ScoringStrategy strategy)
     m_objects.setScoringStrategy(strategy);
 }
 
-void BacktrackingPacker::setFreeBlocks(std::vector<FreeBlock>&& blocks)
+void BacktrackingPacker::setStepLimit(size_t steps)
 {
-    m_freeSpace = FreeSpace{std::move(blocks)};
+    m_stepLimit = steps;
 }
 
-void BacktrackingPacker::addFreeBlock(const FreeBlock& block)
+bool BacktrackingPacker::reachedStepLimit() const
 {
-    m_freeSpace.addBlock(block);
+    return m_reachedStepLimit;
 }
 
-void BacktrackingPacker::addObject(std::unique_ptr<LinkObject>&& object)
+void BacktrackingPacker::setGreedyFirst(bool greedyFirst)
 {
-    if (object->hasFixedAddress())
-    {
-        throw std::runtime_error{"TODO: reimplement"};
-        // No need to pack objects that have a fixed address anyway.
-        // However, block other objects from using its address range.
-        // m_freeSpace.allocateRange(object->allocation().address, object->size());
-    }
-    else
-    {
-        m_objects.addObject(object.get());
-        m_objectSize += object->size();
-        m_linkObjects.push_back(std::move(object));
-    }
+    m_isGreedyFirst = greedyFirst;
 }
 
-auto BacktrackingPacker::object(const size_t index) const -> LinkObject*
+void BacktrackingPacker::setProfiling(bool profiling)
 {
-    return m_linkObjects[index].get();
+    m_isProfiling = profiling;
 }
 
-auto BacktrackingPacker::objectCount() const -> size_t
+auto BacktrackingPacker::statistics() const -> const PackingStatistics&
 {
-    return m_linkObjects.size();
+    return m_statistics;
 }
 
-bool BacktrackingPacker::pack()
+bool BacktrackingPacker::doPack()
 {
-    initializeLogging();
-    log_StartPacking();
-
+    m_statistics.clear();
+    ScopedTimer const timer{&m_statistics.totalTime};
+    if (m_traceFile)
+    {
+        m_trace.open(*m_traceFile, m_traceLevel, m_freeSpace, m_linkObjects);
+    }
+    m_reachedStepLimit = false;
     if (m_objectSize > m_freeSpace.capacity())
     {
-        log_InstantFail();
+        m_trace.record(TraceLevel::Outcome, EventKind::NoSpace);
+        m_trace.close();
+        return false;
+    }
+
+    std::vector<LinkObject*> objects;
+    for (auto const& object : m_linkObjects)
+    {
+        objects.push_back(object.get());
+    }
+
+    bool packed{false};
+    if (m_isGreedyFirst)
+    {
+        auto const allocationCount = m_freeSpace.allocationCount();
+        std::vector<LinkObject*> residual;
+        {
+            ScopedTimer const greedyTimer{profiled(m_statistics.greedyTime)};
+            residual =
+                allocateGreedily(*this, m_freeSpace, objects, GreedyPacker::Fit::Best, false);
+        }
+        m_statistics.greedyAllocations = objects.size() - residual.size();
+        packed = residual.empty() || backtrack(residual);
+        if (!packed && !isStopped() && !m_reachedStepLimit)
+        {
+            // the greedy allocations left no room for the residual objects; start over
+            m_statistics.restarts += 1;
+            while (m_freeSpace.allocationCount() > allocationCount)
+            {
+                m_freeSpace.deallocateLast();
+            }
+            for (auto* object : objects)
+            {
+                object->unsetAllocation();
+            }
+            packed = backtrack(objects);
+        }
+    }
+    else
+    {
+        packed = backtrack(objects);
+    }
+    m_trace.close();
+
+    if (packed && !isSolved())
+    {
+        throw std::runtime_error{"BacktrackingPacker: allocations violate constraints"};
+    }
+    return packed;
+}
+
+bool BacktrackingPacker::backtrack(const std::vector<LinkObject*>& objects)
+{
+    m_objects.clear();
+    m_state = {};
+    FreeSpace::ScopedObserver const observer{m_freeSpace, m_objects.feasibility()};
+    for (auto* object : objects)
+    {
+        m_objects.addObject(object);
+    }
+    m_trace.record(TraceLevel::Outcome, EventKind::Start, nullptr, objects.size());
+
+    if (!m_objects.hasUnmapped())
+    {
+        m_trace.record(TraceLevel::Outcome, EventKind::Solved);
+        return true;
+    }
+    if (!canBeSatisfied())
+    {
+        m_trace.record(TraceLevel::Outcome, EventKind::Exhausted);
         return false;
     }
 
-    m_state.push(BacktrackingState{m_objects.nextUnmapped()->findAllocations(m_freeSpace)});
+    auto* object = m_objects.nextUnmapped();
+    m_state.push(BacktrackingState{findAllocations(*object), object->size()});
+    size_t steps{0};
     while (!m_state.empty())
     {
         while (m_state.top().hasMore())
         {
-            if (m_objects.canBeSatisfied())
+            m_reachedStepLimit = m_stepLimit && steps++ == *m_stepLimit;
+            if (m_reachedStepLimit || isStopped())
+            {
+                m_trace.record(TraceLevel::Outcome, EventKind::Stopped);
+                return false;
+            }
+
+            m_statistics.addStep(m_freeSpace);
+            object = m_objects.nextUnmapped();
+            auto const allocation = m_state.top().allocation();
+            object->setAllocation(allocation);
+            if (!satisfiesDependents(*object))
+            {
+                // an allocated object is constrained relative to this one and rules it out
+                m_trace.record(TraceLevel::Search, EventKind::Rejected, object, allocation.offset);
+                m_statistics.rejections += 1;
+                object->unsetAllocation();
+                m_state.top().next();
+                continue;
+            }
+            m_freeSpace.allocateRange(allocation.target, allocation.address, object->size());
+            m_objects.mapNext();
+            if (!m_objects.hasUnmapped())
             {
-                auto const allocation = m_state.top().allocation();
-                auto const size = m_objects.nextUnmapped()->size();
-                // std::cout << "trying '" << m_objects.nextUnmapped()->path().toString() << " @ "
-                //<< address.toString() << "\n";
-                m_objects.nextUnmapped()->setAllocation(allocation);
-                // TODO: use method that ensures the range exists
-                m_log << "    "
-                      << m_freeSpace.findBlockThatContains(allocation.address).value_or(1234)
-                      << "\n";
-                m_freeSpace.allocateRange(allocation.address, size);
-                log_Allocated(*m_objects.nextUnmapped());
-                m_objects.mapNext();
-                if (!m_objects.hasUnmapped())
-                {
-                    log_Success();
-                    return true;
-                }
-                m_state.push(
-                    BacktrackingState{m_objects.nextUnmapped()->findAllocations(m_freeSpace)});
-
-                m_log << "    " << size << "\n";
-                for (size_t i = 0; i < m_freeSpace.blockCount(); ++i)
-                {
-                    m_log << "    [" << i << "] " << m_freeSpace.block(i).size() << " @ "
-                          << m_freeSpace.block(i).offset() << " / "
-                          << m_freeSpace.block(i).address().toString() << "\n";
-                }
+                m_trace.record(TraceLevel::Search, EventKind::Allocated, object, allocation.offset);
+                m_trace.record(TraceLevel::Outcome, EventKind::Solved);
+                return true;
+            }
+
+            // forward checking: only descend if every remaining object can still be allocated,
+            // taking into account constraints relative to the object just allocated
+            if (canBeSatisfied())
+            {
+                m_trace.record(TraceLevel::Search, EventKind::Allocated, object, allocation.offset);
+                auto* next = m_objects.nextUnmapped();
+                m_state.push(BacktrackingState{findAllocations(*next), next->size()});
+                m_statistics.maximumDepth = std::max(m_statistics.maximumDepth, m_state.size());
             }
             else
             {
                 // Ran into a deadend. Try next allocation candidate.
+                m_trace.record(TraceLevel::Search, EventKind::Rejected, object, allocation.offset);
+                m_statistics.rejections += 1;
+                m_freeSpace.deallocateLast();
+                m_objects.unmapLast();
+                object->unsetAllocation();
                 m_state.top().next();
             }
         }
 
+        // the object whose allocations were tried has none left
+        m_statistics.exhaustedObjects[m_objects.nextUnmapped()] += 1;
         m_state.pop();
         if (!m_state.empty())
         {
-            std::cout << "Backtracking...\n";
+            m_trace.record(TraceLevel::Search, EventKind::Backtracked, nullptr, m_state.size());
+            m_statistics.backtracks += 1;
+            m_statistics.backtrackDepths.add(m_state.size());
             m_freeSpace.deallocateLast();
             m_objects.unmapLast();
-            log_Deallocated(*m_objects.nextUnmapped());
+            m_trace.record(TraceLevel::Search, EventKind::Deallocated, m_objects.nextUnmapped());
             m_objects.nextUnmapped()->unsetAllocation();
+            m_state.top().next();
         }
     }
 
-    log_Fail();
+    m_trace.record(TraceLevel::Outcome, EventKind::Exhausted);
     return false;
 }
 
-void BacktrackingPacker::setLogFile(const std::filesystem::path& log)
+auto BacktrackingPacker::findAllocations(const LinkObject& object) -> std::vector<Allocation>
+{
+    ScopedTimer const timer{profiled(m_statistics.findAllocationsTime)};
+    auto allocations = object.findAllocations(m_freeSpace);
+    m_statistics.candidateCounts.add(allocations.size());
+    return allocations;
+}
+
+bool BacktrackingPacker::canBeSatisfied()
+{
+    ScopedTimer const timer{profiled(m_statistics.canBeSatisfiedTime)};
+    return m_objects.canBeSatisfied();
+}
+
+auto BacktrackingPacker::profiled(std::chrono::nanoseconds& total) -> std::chrono::nanoseconds*
+{
+    return m_isProfiling ? &total : nullptr;
+}
+
+void BacktrackingPacker::setTraceFile(const std::filesystem::path& trace, TraceLevel level)
 {
-    m_logFile = log;
+    m_traceFile = trace;
+    m_traceLevel = level;
 }
 
-BacktrackingPacker::BacktrackingState::BacktrackingState(std::vector<Allocation>&& allocations)
+BacktrackingPacker::BacktrackingState::BacktrackingState(std::vector<Allocation>&& allocations,
+                                                         size_t objectSize)
     : m_allocations{std::move(allocations)}
+    , m_objectSize{objectSize}
 {
     m_isAtEnd = m_allocations.empty();
 }
@@ -235,8 +350,8 @@ bool BacktrackingPacker::BacktrackingState::next()
     // Overall, this would take just as long as just traversing an allocation linearly, but we cover
     // a larger range in fewer iterations, making it possible to cancel earlier and saying there is
     // no viable allocation.
-    m_allocationOffset += (m_allocations[m_allocationIndex].size >> m_shift);
-    if (m_allocationOffset >= m_allocations[m_allocationIndex].size)
+    m_allocationOffset += (span(m_allocationIndex) >> m_shift);
+    if (m_allocationOffset >= span(m_allocationIndex))
     {
         m_allocationOffset = 0;
         if (++m_allocationIndex == m_allocations.size())
@@ -244,7 +359,7 @@ bool BacktrackingPacker::BacktrackingState::next()
             m_allocationIndex = 0;
             m_shift += 1;
         }
-        while (m_allocations[m_allocationIndex].size < (1ULL << m_shift))
+        while (span(m_allocationIndex) < (1ULL << m_shift))
         {
             if (++m_allocationIndex == m_allocations.size())
             {
@@ -258,92 +373,28 @@ bool BacktrackingPacker::BacktrackingState::next()
 
 auto BacktrackingPacker::BacktrackingState::allocation() const -> Allocation
 {
+    auto const& allocation = m_allocations[m_allocationIndex];
+    auto const offset = m_allocationOffset - m_allocationOffset % allocation.alignment;
     Allocation shiftedAllocation;
-    shiftedAllocation.size = m_allocations[m_allocationIndex].size;
-    shiftedAllocation.block = m_allocations[m_allocationIndex].block;
-    shiftedAllocation.offset = m_allocations[m_allocationIndex].offset + m_allocationOffset;
-    shiftedAllocation.address =
-        m_allocations[m_allocationIndex].address.applyOffset(m_allocationOffset);
+    shiftedAllocation.size = allocation.size;
+    shiftedAllocation.block = allocation.block;
+    shiftedAllocation.offset = allocation.offset + offset;
+    shiftedAllocation.address = allocation.address.applyOffset(offset);
+    shiftedAllocation.alignment = allocation.alignment;
+    shiftedAllocation.target = allocation.target;
     return shiftedAllocation;
 }
 
-bool BacktrackingPacker::BacktrackingState::hasMore() const
-{
-    return !m_isAtEnd;
-}
-
-void BacktrackingPacker::initializeLogging()
-{
-    if (m_logFile)
-    {
-        m_log.open(*m_logFile);
-    }
-}
-
-void BacktrackingPacker::log_StartPacking()
-{
-    if (m_log.is_open())
-    {
-        m_log << "Start packing...\n";
-
-        m_log << "Free blocks:\n";
-        for (size_t i = 0; i < m_freeSpace.blockCount(); ++i)
-        {
-            m_log << "[" << i << "] " << m_freeSpace.block(i).size() << " @ "
-                  << m_freeSpace.block(i).offset() << " / "
-                  << m_freeSpace.block(i).address().toString() << "\n";
-        }
-
-        m_log << "Objects:\n";
-        for (size_t i = 0; i < m_objects.unmappedObjectCount(); ++i)
-        {
-            auto const* object = m_objects.unmappedObject(i);
-            m_log << " [" << i << "] " << object->id() << ": " << object->size()
-                  << " (score: " << m_objects.unmappedObjectScore(i) << ")\n";
-        }
-    }
-}
-
-void BacktrackingPacker::log_InstantFail()
-{
-    if (m_log.is_open())
-    {
-        m_log << "Failed instantly due to insufficient free space (objects: " << m_objectSize
-              << " bytes / free space: " << m_freeSpace.capacity() << ")\n";
-    }
-}
-
-void BacktrackingPacker::log_Allocated(const LinkObject& object)
-{
-    if (m_log.is_open())
-    {
-        m_log << "  allocated object " << object.id() << " at offset " << object.allocation().offset
-              << ", corresponding to address " << object.allocation().address.toString() << "\n";
-    }
-}
-
-void BacktrackingPacker::log_Deallocated(const LinkObject& object)
-{
-    if (m_log.is_open())
-    {
-        m_log << "  deallocated object " << object.id() << "\n";
-    }
-}
-
-void BacktrackingPacker::log_Success()
+auto BacktrackingPacker::BacktrackingState::span(size_t index) const -> size_t
 {
-    if (m_log.is_open())
-    {
-        m_log << "Success!";
-    }
+    auto const& allocation = m_allocations[index];
+    Expects(allocation.size >= m_objectSize);
+    return allocation.size - m_objectSize + 1;
 }
 
-void BacktrackingPacker::log_Fail()
+bool BacktrackingPacker::BacktrackingState::hasMore() const
 {
-    if (m_log.is_open())
-    {
-        m_log << "Fail.";
-    }
+    return !m_isAtEnd;
 }
 
 } // namespace kaizo::data
\ No newline at end of file
@@ -1,21 +1,223 @@
 #include "kaizo/data/linking/Constraint.h"
+#include "kaizo/data/linking/FreeSpace.h"
+#include "kaizo/data/linking/LinkObject.h"
+#include <algorithm>
+#include <contracts/Contracts.h>
+#include <numeric>
 
 namespace kaizo::data {
 
-FixedAddressConstraint::FixedAddressConstraint(Address address)
-    : m_address{address}
+/// Returns the address the given number of bytes away, or the lowest address if that precedes it.
+static auto applyClampedOffset(const Address& address, int64_t offset) -> Address
 {
+    if (offset < 0 && static_cast<uint64_t>(-offset) > address.toInteger())
+    {
+        return address.applyOffset(-static_cast<int64_t>(address.toInteger()));
+    }
+    return address.applyOffset(offset);
 }
 
-auto FixedAddressConstraint::findAllocations(const FreeSpace&, size_t) const
+static auto segmentOf(const Address& address, size_t segmentSize) -> Placement
+{
+    auto const lower =
+        address.applyOffset(-static_cast<int64_t>(address.toInteger() % segmentSize));
+    Placement placement;
+    placement.lower = lower;
+    placement.upper = lower.applyOffset(segmentSize);
+    return placement;
+}
+
+bool Placement::isBounded() const
+{
+    return lower || upper;
+}
+
+bool Placement::allowsTarget(size_t target) const
+{
+    return target < MaximumTargetCount && (targets >> target & 1) != 0;
+}
+
+auto Placement::clip(const FreeBlock& block) const -> std::optional<FreeBlock>
+{
+    if (!allowsTarget(block.target()) || (lower && !lower->isCompatible(block.address())) ||
+        (upper && !upper->isCompatible(block.address())))
+    {
+        return {};
+    }
+    auto start = block.address();
+    auto length = block.size();
+    if (lower && start < *lower)
+    {
+        auto const cut = static_cast<size_t>(lower->subtract(start));
+        if (cut >= length)
+        {
+            return {};
+        }
+        start = *lower;
+        length -= cut;
+    }
+    if (upper)
+    {
+        auto const available = upper->subtract(start);
+        if (available <= 0)
+        {
+            return {};
+        }
+        length = std::min(length, static_cast<size_t>(available));
+    }
+    return FreeBlock{block.offset() + start.subtract(block.address()), start, length,
+                     block.target()};
+}
+
+bool Placement::fits(const FreeBlock& block, size_t size) const
+{
+    auto const window = clip(block);
+    return window && window->size() >= size && window->alignedFit(size, alignment);
+}
+
+/// Finds up to limit allocations within the placement, those that waste the fewest bytes first.
+/// Bounded placements only visit the blocks that overlap them.
+static auto findPlacedAllocations(const FreeSpace& space, size_t size, const Placement& placement,
+                                  size_t limit) -> std::vector<Allocation>
+{
+    // the bytes an allocation leaves unusable, i.e. its padding or the gap to the block's end
+    std::vector<std::pair<size_t, Allocation>> allocations;
+    auto const consider = [&](size_t index) {
+        auto const& block = space.block(index);
+        auto const window = placement.clip(block);
+        if (!window || window->size() < size)
+        {
+            return true;
+        }
+        auto const address = window->alignedFit(size, placement.alignment);
+        if (!address)
+        {
+            return true;
+        }
+        auto const padding = static_cast<size_t>(address->subtract(window->address()));
+
+        Allocation allocation;
+        allocation.block = index;
+        allocation.offset = window->offset() + padding;
+        allocation.address = *address;
+        allocation.size = window->size() - padding;
+        allocation.alignment = placement.alignment;
+        allocation.target = block.target();
+        auto const waste = padding < placement.alignment ? padding : allocation.size - size;
+        allocations.emplace_back(waste, allocation);
+        return allocations.size() < limit;
+    };
+
+    if (placement.isBounded())
+    {
+        auto isFull = false;
+        for (size_t target = 0; target < space.targetCount() && !isFull; ++target)
+        {
+            if (!placement.allowsTarget(target))
+            {
+                continue;
+            }
+            auto const [first, last] =
+                space.findBlocksWithinRange(target, placement.lower, placement.upper);
+            for (auto i = first; i < last && !isFull; ++i)
+            {
+                isFull = !consider(i);
+            }
+        }
+    }
+    else
+    {
+        for (auto const index : space.findBlocksThatFit(size, placement.alignment))
+        {
+            if (!consider(index))
+            {
+                break;
+            }
+        }
+    }
+
+    std::stable_sort(allocations.begin(), allocations.end(),
+                     [](auto const& a, auto const& b) { return a.first < b.first; });
+    std::vector<Allocation> sorted(allocations.size());
+    for (auto i = 0U; i < allocations.size(); ++i)
+    {
+        sorted[i] = allocations[i].second;
+    }
+    return sorted;
+}
+
+auto Constraint::findAllocations(const FreeSpace& space, size_t size) const
     -> std::vector<Allocation>
 {
+    if (auto const maybePlacement = placement(size))
+    {
+        return findPlacedAllocations(space, size, *maybePlacement,
+                                     std::numeric_limits<size_t>::max());
+    }
     return {};
 }
 
-bool FixedAddressConstraint::hasAllocations(const FreeSpace&, size_t) const
+bool Constraint::hasAllocations(const FreeSpace& space, size_t size) const
 {
-    return false;
+    auto const maybePlacement = placement(size);
+    if (!maybePlacement)
+    {
+        return false;
+    }
+    if (!maybePlacement->lower && !maybePlacement->upper && maybePlacement->alignment == 1 &&
+        maybePlacement->targets == Placement::AllTargets)
+    {
+        return space.hasBlockThatFits(size);
+    }
+    return !findPlacedAllocations(space, size, *maybePlacement, 1).empty();
+}
+
+bool Constraint::isSatisfiedBy(size_t target, const Address& address, size_t size) const
+{
+    auto const maybePlacement = placement(size);
+    if (!maybePlacement || !maybePlacement->allowsTarget(target))
+    {
+        return false;
+    }
+    if ((maybePlacement->lower && !maybePlacement->lower->isCompatible(address)) ||
+        (maybePlacement->upper && !maybePlacement->upper->isCompatible(address)))
+    {
+        return false;
+    }
+    if (maybePlacement->lower && address < *maybePlacement->lower)
+    {
+        return false;
+    }
+    if (maybePlacement->upper &&
+        maybePlacement->upper->subtract(address) < static_cast<int64_t>(size))
+    {
+        return false;
+    }
+    return address.toInteger() % maybePlacement->alignment == 0;
+}
+
+auto Constraint::references() const -> std::vector<const LinkObject*>
+{
+    return {};
+}
+
+void Constraint::rebind(const std::unordered_map<const LinkObject*, const LinkObject*>&)
+{
+}
+
+//##[ FixedAddressConstraint ]#####################################################################
+
+FixedAddressConstraint::FixedAddressConstraint(Address address)
+    : m_address{address}
+{
+}
+
+auto FixedAddressConstraint::placement(size_t size) const -> std::optional<Placement>
+{
+    Placement placement;
+    placement.lower = m_address;
+    placement.upper = m_address.applyOffset(size);
+    return placement;
 }
 
 auto FixedAddressConstraint::yieldsFixedAddress() const -> std::optional<Address>
@@ -38,19 +240,319 @@ auto FixedAddressConstraint::toString() const -> std::string
     return "FixedAddress(" + m_address.toString() + ")";
 }
 
+//##[ AddressRangeConstraint ]#####################################################################
+
+AddressRangeConstraint::AddressRangeConstraint(Address lower, Address upper)
+    : m_lower{lower}
+    , m_upper{upper}
+{
+    Expects(lower <= upper);
+}
+
+auto AddressRangeConstraint::placement(size_t) const -> std::optional<Placement>
+{
+    Placement placement;
+    placement.lower = m_lower;
+    placement.upper = m_upper;
+    return placement;
+}
+
+auto AddressRangeConstraint::yieldsFixedAddress() const -> std::optional<Address>
+{
+    return {};
+}
+
+auto AddressRangeConstraint::strength() const -> unsigned
+{
+    return 100;
+}
+
+auto AddressRangeConstraint::copy() const -> std::unique_ptr<Constraint>
+{
+    return std::make_unique<AddressRangeConstraint>(m_lower, m_upper);
+}
+
+auto AddressRangeConstraint::toString() const -> std::string
+{
+    return "AddressRange(" + m_lower.toString() + "," + m_upper.toString() + ")";
+}
+
+//##[ SegmentConstraint ]##########################################################################
+
+SegmentConstraint::SegmentConstraint(Address address, size_t segmentSize)
+    : m_address{address}
+    , m_segmentSize{segmentSize}
+{
+    Expects(segmentSize > 0);
+}
+
+auto SegmentConstraint::placement(size_t) const -> std::optional<Placement>
+{
+    return segmentOf(m_address, m_segmentSize);
+}
+
+auto SegmentConstraint::yieldsFixedAddress() const -> std::optional<Address>
+{
+    return {};
+}
+
+auto SegmentConstraint::strength() const -> unsigned
+{
+    return 100;
+}
+
+auto SegmentConstraint::copy() const -> std::unique_ptr<Constraint>
+{
+    return std::make_unique<SegmentConstraint>(m_address, m_segmentSize);
+}
+
+auto SegmentConstraint::toString() const -> std::string
+{
+    return "Segment(" + m_address.toString() + "," + std::to_string(m_segmentSize) + ")";
+}
+
+//##[ AlignmentConstraint ]########################################################################
+
+AlignmentConstraint::AlignmentConstraint(size_t alignment)
+    : m_alignment{alignment}
+{
+    Expects(alignment > 0);
+}
+
+auto AlignmentConstraint::placement(size_t) const -> std::optional<Placement>
+{
+    Placement placement;
+    placement.alignment = m_alignment;
+    return placement;
+}
+
+auto AlignmentConstraint::yieldsFixedAddress() const -> std::optional<Address>
+{
+    return {};
+}
+
+auto AlignmentConstraint::strength() const -> unsigned
+{
+    return 10;
+}
+
+auto AlignmentConstraint::copy() const -> std::unique_ptr<Constraint>
+{
+    return std::make_unique<AlignmentConstraint>(m_alignment);
+}
+
+auto AlignmentConstraint::toString() const -> std::string
+{
+    return "Alignment(" + std::to_string(m_alignment) + ")";
+}
+
+//##[ TargetConstraint ]###########################################################################
+
+TargetConstraint::TargetConstraint(uint64_t targets)
+    : m_targets{targets}
+{
+    Expects(targets != 0);
+}
+
+auto TargetConstraint::placement(size_t) const -> std::optional<Placement>
+{
+    Placement placement;
+    placement.targets = m_targets;
+    return placement;
+}
+
+auto TargetConstraint::yieldsFixedAddress() const -> std::optional<Address>
+{
+    return {};
+}
+
+auto TargetConstraint::strength() const -> unsigned
+{
+    return 10;
+}
+
+auto TargetConstraint::copy() const -> std::unique_ptr<Constraint>
+{
+    return std::make_unique<TargetConstraint>(m_targets);
+}
+
+auto TargetConstraint::toString() const -> std::string
+{
+    return "Target(" + std::to_string(m_targets) + ")";
+}
+
+//##[ SameSegmentConstraint ]######################################################################
+
+SameSegmentConstraint::SameSegmentConstraint(const LinkObject* other, size_t segmentSize)
+    : m_other{other}
+    , m_segmentSize{segmentSize}
+{
+    Expects(other);
+    Expects(segmentSize > 0);
+}
+
+auto SameSegmentConstraint::placement(size_t) const -> std::optional<Placement>
+{
+    if (!m_other->hasAllocation())
+    {
+        return Placement{};
+    }
+    return segmentOf(m_other->allocation().address, m_segmentSize);
+}
+
+auto SameSegmentConstraint::yieldsFixedAddress() const -> std::optional<Address>
+{
+    return {};
+}
+
+auto SameSegmentConstraint::strength() const -> unsigned
+{
+    return 50;
+}
+
+auto SameSegmentConstraint::copy() const -> std::unique_ptr<Constraint>
+{
+    return std::make_unique<SameSegmentConstraint>(m_other, m_segmentSize);
+}
+
+auto SameSegmentConstraint::toString() const -> std::string
+{
+    return "SameSegment(" + m_other->id() + "," + std::to_string(m_segmentSize) + ")";
+}
+
+auto SameSegmentConstraint::references() const -> std::vector<const LinkObject*>
+{
+    return {m_other};
+}
+
+void SameSegmentConstraint::rebind(
+    const std::unordered_map<const LinkObject*, const LinkObject*>& copies)
+{
+    if (auto const copy = copies.find(m_other); copy != copies.end())
+    {
+        m_other = copy->second;
+    }
+}
+
+//##[ RelativeRangeConstraint ]####################################################################
+
+RelativeRangeConstraint::RelativeRangeConstraint(const LinkObject* other, int64_t minimum,
+                                                 int64_t maximum)
+    : m_other{other}
+    , m_minimum{minimum}
+    , m_maximum{maximum}
+{
+    Expects(other);
+    Expects(minimum <= maximum);
+}
+
+auto RelativeRangeConstraint::placement(size_t size) const -> std::optional<Placement>
+{
+    if (!m_other->hasAllocation())
+    {
+        return Placement{};
+    }
+
+    auto const& base = m_other->allocation().address;
+    if (m_maximum < 0 && static_cast<uint64_t>(-m_maximum) > base.toInteger())
+    {
+        return {};
+    }
+    Placement placement;
+    placement.lower = applyClampedOffset(base, m_minimum);
+    placement.upper = base.applyOffset(m_maximum).applyOffset(size);
+    return placement;
+}
+
+auto RelativeRangeConstraint::yieldsFixedAddress() const -> std::optional<Address>
+{
+    return {};
+}
+
+auto RelativeRangeConstraint::strength() const -> unsigned
+{
+    return 50;
+}
+
+auto RelativeRangeConstraint::copy() const -> std::unique_ptr<Constraint>
+{
+    return std::make_unique<RelativeRangeConstraint>(m_other, m_minimum, m_maximum);
+}
+
+auto RelativeRangeConstraint::toString() const -> std::string
+{
+    return "RelativeRange(" + m_other->id() + "," + std::to_string(m_minimum) + "," +
+           std::to_string(m_maximum) + ")";
+}
+
+auto RelativeRangeConstraint::references() const -> std::vector<const LinkObject*>
+{
+    return {m_other};
+}
+
+void RelativeRangeConstraint::rebind(
+    const std::unordered_map<const LinkObject*, const LinkObject*>& copies)
+{
+    if (auto const copy = copies.find(m_other); copy != copies.end())
+    {
+        m_other = copy->second;
+    }
+}
+
+//##[ AndConstraint ]##############################################################################
+
 AndConstraint::AndConstraint(std::vector<std::unique_ptr<Constraint>>&& constraints)
     : m_constraints{std::move(constraints)}
 {
 }
 
-auto AndConstraint::findAllocations(const FreeSpace&, size_t) const -> std::vector<Allocation>
+void AndConstraint::append(std::unique_ptr<Constraint>&& constraint)
 {
-    return {};
+    Expects(constraint);
+    m_constraints.push_back(std::move(constraint));
 }
 
-bool AndConstraint::hasAllocations(const FreeSpace&, size_t) const
+auto AndConstraint::placement(size_t size) const -> std::optional<Placement>
 {
-    return false;
+    Placement combined;
+    for (auto const& constraint : m_constraints)
+    {
+        auto const placement = constraint->placement(size);
+        if (!placement)
+        {
+            return {};
+        }
+        // no block is compatible with bounds of different address formats
+        for (auto const& bound : {placement->lower, placement->upper})
+        {
+            for (auto const& other : {combined.lower, combined.upper})
+            {
+                if (bound && other && !bound->isCompatible(*other))
+                {
+                    return {};
+                }
+            }
+        }
+        if (placement->lower && (!combined.lower || *combined.lower < *placement->lower))
+        {
+            combined.lower = placement->lower;
+        }
+        if (placement->upper && (!combined.upper || *placement->upper < *combined.upper))
+        {
+            combined.upper = placement->upper;
+        }
+        combined.alignment = std::lcm(combined.alignment, placement->alignment);
+        combined.targets &= placement->targets;
+    }
+    if (combined.targets == 0)
+    {
+        return {};
+    }
+    if (combined.lower && combined.upper && !(*combined.lower < *combined.upper))
+    {
+        return {};
+    }
+    return combined;
 }
 
 auto AndConstraint::yieldsFixedAddress() const -> std::optional<Address>
@@ -67,7 +569,12 @@ auto AndConstraint::yieldsFixedAddress() const -> std::optional<Address>
 
 auto AndConstraint::strength() const -> unsigned
 {
-    return 1;
+    unsigned strength{1};
+    for (auto const& constraint : m_constraints)
+    {
+        strength = std::max(strength, constraint->strength());
+    }
+    return strength;
 }
 
 auto AndConstraint::copy() const -> std::unique_ptr<Constraint>
@@ -95,4 +602,23 @@ auto AndConstraint::toString() const -> std::string
     return repr;
 }
 
+auto AndConstraint::references() const -> std::vector<const LinkObject*>
+{
+    std::vector<const LinkObject*> references;
+    for (auto const& constraint : m_constraints)
+    {
+        auto const more = constraint->references();
+        references.insert(references.end(), more.cbegin(), more.cend());
+    }
+    return references;
+}
+
+void AndConstraint::rebind(const std::unordered_map<const LinkObject*, const LinkObject*>& copies)
+{
+    for (auto& constraint : m_constraints)
+    {
+        constraint->rebind(copies);
+    }
+}
+
 } // namespace kaizo::data
\ No newline at end of file
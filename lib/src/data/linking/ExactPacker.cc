@@ -0,0 +1,439 @@
+#include "kaizo/data/linking/ExactPacker.h"
+#include <algorithm>
+#include <contracts/Contracts.h>
+#include <map>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace kaizo::data {
+
+// asking for the time at every node would dominate cheap nodes
+static constexpr size_t StopCheckInterval = 256;
+// larger blocks are rarely worth the subset sums, see isWithinBounds()
+static constexpr size_t MaximumFillSize = 1 << 16;
+
+/// Sets every bit that is the given number of bits above a set bit.
+static void orShifted(std::vector<uint64_t>& bits, size_t shift)
+{
+    auto const words = shift / 64;
+    auto const remainder = shift % 64;
+    for (auto i = bits.size(); i-- > words;)
+    {
+        auto shifted = bits[i - words] << remainder;
+        if (remainder > 0 && i > words)
+        {
+            shifted |= bits[i - words - 1] >> (64 - remainder);
+        }
+        bits[i] |= shifted;
+    }
+}
+
+auto ExactPacker::Class::remaining() const -> size_t
+{
+    return objects.size() - allocated;
+}
+
+ExactPacker::ExactPacker()
+    : m_feasibility{&m_freeSpace}
+{
+}
+
+bool ExactPacker::provedInfeasible() const
+{
+    return m_provedInfeasible;
+}
+
+auto ExactPacker::nodeCount() const -> size_t
+{
+    return m_nodeCount;
+}
+
+bool ExactPacker::doPack()
+{
+    m_provedInfeasible = false;
+    m_nodeCount = 0;
+    m_decisions.clear();
+    m_feasibility.clear();
+    if (!placeFixedObjects())
+    {
+        m_provedInfeasible = true;
+        return false;
+    }
+    buildClasses();
+
+    FreeSpace::ScopedObserver const observer{m_freeSpace, m_feasibility};
+    for (auto const& objectClass : m_classes)
+    {
+        for (auto const* object : objectClass.objects)
+        {
+            m_feasibility.addObject(object);
+        }
+    }
+    if (!search())
+    {
+        return false;
+    }
+    if (!isSolved())
+    {
+        throw std::runtime_error{"ExactPacker: allocations violate constraints"};
+    }
+    return true;
+}
+
+/// Objects with a fixed address can only go to one place, so they are not part of the search.
+bool ExactPacker::placeFixedObjects()
+{
+    for (auto const& object : m_linkObjects)
+    {
+        if (!object->hasFixedAddress())
+        {
+            continue;
+        }
+        auto const allocations = object->findAllocations(m_freeSpace);
+        if (allocations.empty())
+        {
+            return false;
+        }
+        object->setAllocation(allocations.front());
+        m_freeSpace.allocateRange(allocations.front().target, allocations.front().address,
+                                  object->size());
+    }
+    return true;
+}
+
+void ExactPacker::buildClasses()
+{
+    std::unordered_set<const LinkObject*> referenced;
+    for (auto const& object : m_linkObjects)
+    {
+        for (auto const* other : object->references())
+        {
+            referenced.insert(other);
+        }
+    }
+
+    m_hasReferences = !referenced.empty();
+    m_classes.clear();
+    m_remainingSize = 0;
+    m_remainingCount = 0;
+    std::map<size_t, size_t> plainClasses;
+    for (auto const& object : m_linkObjects)
+    {
+        if (object->hasAllocation())
+        {
+            continue;
+        }
+        m_remainingSize += object->size();
+        m_remainingCount += 1;
+        auto const isPlain = object->isUnconstrained() && !referenced.contains(object.get());
+        if (isPlain)
+        {
+            auto const [plainClass, isNew] =
+                plainClasses.emplace(object->size(), m_classes.size());
+            if (!isNew)
+            {
+                m_classes[plainClass->second].objects.push_back(object.get());
+                continue;
+            }
+        }
+        m_classes.push_back(Class{object->size(), isPlain, {object.get()}});
+    }
+    std::stable_sort(m_classes.begin(), m_classes.end(),
+                     [](auto const& a, auto const& b) { return a.size > b.size; });
+}
+
+bool ExactPacker::search()
+{
+    if (m_remainingCount == 0)
+    {
+        return true;
+    }
+    if (!isWithinBounds())
+    {
+        m_provedInfeasible = !m_hasReferences;
+        return false;
+    }
+
+    // every frame but the first was entered by a decision, which is undone when it is left
+    std::vector<Frame> frames(1);
+    while (!frames.empty())
+    {
+        if (++m_nodeCount % StopCheckInterval == 0 && isStopped())
+        {
+            return false;
+        }
+
+        auto& frame = frames.back();
+        if (!frame.classes)
+        {
+            frame.classes = orderClasses(frame.firstPlainClass);
+        }
+        std::optional<Frame> child;
+        while (!child && frame.nextClass < frame.classes->size())
+        {
+            auto const index = (*frame.classes)[frame.nextClass++];
+            auto const& objectClass = m_classes[index];
+            if (!place(index))
+            {
+                continue;
+            }
+            if (m_remainingCount == 0)
+            {
+                return true;
+            }
+            if (isWithinBounds())
+            {
+                child = Frame{};
+                if (objectClass.isPlain && continuesBlock(index))
+                {
+                    child->firstPlainClass = index;
+                }
+            }
+            else
+            {
+                undo();
+            }
+        }
+        if (!child && !frame.hasLeftBlockEmpty && m_freeSpace.blockCount() > 0)
+        {
+            frame.hasLeftBlockEmpty = true;
+            leaveBlockEmpty();
+            if (isWithinBounds())
+            {
+                child = Frame{};
+            }
+            else
+            {
+                undo();
+            }
+        }
+
+        if (child)
+        {
+            frames.push_back(*child);
+        }
+        else
+        {
+            frames.pop_back();
+            if (!frames.empty())
+            {
+                undo();
+            }
+        }
+    }
+    m_provedInfeasible = !m_hasReferences;
+    return false;
+}
+
+auto ExactPacker::orderClasses(size_t firstPlainClass) const -> std::vector<size_t>
+{
+    // the classes are ordered by decreasing size already; the bounds of different targets may have
+    // different address formats, so they are compared as integers
+    std::vector<std::pair<std::optional<uint64_t>, size_t>> classes;
+    for (auto i = 0U; i < m_classes.size(); ++i)
+    {
+        auto const& objectClass = m_classes[i];
+        if (objectClass.remaining() == 0 || (objectClass.isPlain && i < firstPlainClass))
+        {
+            continue;
+        }
+        std::optional<uint64_t> upper;
+        if (!objectClass.isPlain)
+        {
+            if (auto const placement = objectClass.objects.front()->placement();
+                placement && placement->upper)
+            {
+                upper = placement->upper->toInteger();
+            }
+        }
+        classes.emplace_back(upper, i);
+    }
+    std::stable_sort(classes.begin(), classes.end(), [](auto const& a, auto const& b) {
+        return a.first && (!b.first || *a.first < *b.first);
+    });
+
+    std::vector<size_t> order(classes.size());
+    for (auto i = 0U; i < classes.size(); ++i)
+    {
+        order[i] = classes[i].second;
+    }
+    return order;
+}
+
+bool ExactPacker::place(size_t index)
+{
+    auto& objectClass = m_classes[index];
+    auto* object = objectClass.objects[objectClass.allocated];
+    auto const placement = object->placement();
+    if (!placement || m_freeSpace.blockCount() == 0)
+    {
+        return false;
+    }
+    auto const block = m_freeSpace.block(0);
+    auto const window = placement->clip(block);
+    if (!window)
+    {
+        return false;
+    }
+    auto const misalignment = window->address().toInteger() % placement->alignment;
+    auto const padding = misalignment == 0 ? 0 : placement->alignment - misalignment;
+    if (padding + object->size() > window->size())
+    {
+        return false;
+    }
+
+    // the bytes skipped before the object stay unused
+    auto const address = window->address().applyOffset(padding);
+    auto const skipped = static_cast<size_t>(address.subtract(block.address()));
+    Allocation allocation;
+    allocation.block = 0;
+    allocation.offset = block.offset() + skipped;
+    allocation.address = address;
+    allocation.size = object->size();
+    allocation.alignment = placement->alignment;
+    allocation.target = block.target();
+    object->setAllocation(allocation);
+    if (!satisfiesDependents(*object))
+    {
+        object->unsetAllocation();
+        return false;
+    }
+    m_freeSpace.allocate(0, block.address(), skipped + object->size());
+    m_feasibility.setWaiting(object, false);
+
+    objectClass.allocated += 1;
+    m_remainingSize -= object->size();
+    m_remainingCount -= 1;
+    m_decisions.push_back(index);
+    return true;
+}
+
+/// Returns the largest number of bytes up to the given size that the remaining objects add up to.
+auto ExactPacker::largestFill(size_t size) const -> size_t
+{
+    std::vector<uint64_t> reachable(size / 64 + 1);
+    reachable[0] = 1;
+    for (auto const& objectClass : m_classes)
+    {
+        if (objectClass.size == 0)
+        {
+            continue;
+        }
+        // copies are added in powers of two, which still reaches every count
+        auto copies = std::min(objectClass.remaining(), size / objectClass.size);
+        for (size_t chunk = 1; copies > 0; chunk *= 2)
+        {
+            auto const added = std::min(chunk, copies);
+            orShifted(reachable, added * objectClass.size);
+            copies -= added;
+        }
+    }
+    for (auto fill = size;; --fill)
+    {
+        if (reachable[fill / 64] >> (fill % 64) & 1)
+        {
+            return fill;
+        }
+    }
+}
+
+/// Checks whether the lowest block continues right after the last object of the given class, i.e.
+/// whether that object did not fill its block.
+bool ExactPacker::continuesBlock(size_t index) const
+{
+    auto const& objectClass = m_classes[index];
+    auto const* object = objectClass.objects[objectClass.allocated - 1];
+    auto const end = object->allocation().address.applyOffset(object->size());
+    return m_freeSpace.blockCount() > 0 &&
+           m_freeSpace.block(0).target() == object->allocation().target &&
+           m_freeSpace.block(0).address() == end;
+}
+
+void ExactPacker::leaveBlockEmpty()
+{
+    Expects(m_freeSpace.blockCount() > 0);
+    m_freeSpace.allocate(0, m_freeSpace.block(0).size());
+    m_decisions.push_back(std::nullopt);
+}
+
+void ExactPacker::undo()
+{
+    Expects(!m_decisions.empty());
+    auto const decision = m_decisions.back();
+    m_decisions.pop_back();
+    m_freeSpace.deallocateLast();
+    if (decision)
+    {
+        auto& objectClass = m_classes[*decision];
+        objectClass.allocated -= 1;
+        auto* object = objectClass.objects[objectClass.allocated];
+        object->unsetAllocation();
+        m_feasibility.setWaiting(object, true);
+        m_remainingSize += object->size();
+        m_remainingCount += 1;
+    }
+}
+
+bool ExactPacker::isWithinBounds()
+{
+    if (m_remainingSize > m_freeSpace.capacity() || !m_feasibility.isFeasible())
+    {
+        return false;
+    }
+
+    // the lowest block is filled from its start, so whatever the remaining objects cannot fill of
+    // it is lost; only worth asking if that could exceed the bytes there are to spare
+    auto const slack = m_freeSpace.capacity() - m_remainingSize;
+    if (m_freeSpace.blockCount() > 0)
+    {
+        auto const room = m_freeSpace.block(0).size();
+        if (slack < room && room <= MaximumFillSize && room - largestFill(room) > slack)
+        {
+            return false;
+        }
+    }
+
+    // objects of at least a given size only fit into blocks of at least that size, both in bytes
+    // and in number; the classes are ordered by decreasing size
+    auto const blockSizes = m_freeSpace.blockSizes();
+    size_t volume{0};
+    size_t count{0};
+    size_t eligible{0};
+    size_t capacity{0};
+    for (auto i = 0U; i < m_classes.size(); ++i)
+    {
+        auto const size = m_classes[i].size;
+        volume += size * m_classes[i].remaining();
+        count += m_classes[i].remaining();
+        if (count == 0 || size == 0 || (i + 1 < m_classes.size() && m_classes[i + 1].size == size))
+        {
+            continue;
+        }
+        while (eligible < blockSizes.size() && blockSizes[eligible] >= size)
+        {
+            capacity += blockSizes[eligible++];
+        }
+        if (volume > capacity)
+        {
+            return false;
+        }
+        // every eligible block holds at least one object, and rounding down loses less than one
+        // object per block
+        if (count <= eligible || count + eligible <= capacity / size)
+        {
+            continue;
+        }
+        size_t slots{0};
+        for (auto j = 0U; j < eligible && slots < count; ++j)
+        {
+            slots += blockSizes[j] / size;
+        }
+        if (slots < count)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace kaizo::data
@@ -0,0 +1,279 @@
+#include "kaizo/data/linking/FeasibilityTracker.h"
+#include <algorithm>
+#include <contracts/Contracts.h>
+
+namespace kaizo::data {
+
+static auto usableSize(const FreeBlock& block, size_t alignment) -> size_t
+{
+    auto const padding = (alignment - block.address().toInteger() % alignment) % alignment;
+    return block.size() > padding ? block.size() - padding : 0;
+}
+
+static bool isAllowed(uint64_t targets, const FreeBlock& block)
+{
+    return (targets >> block.target() & 1) != 0;
+}
+
+FeasibilityTracker::FeasibilityTracker(const FreeSpace* space)
+    : m_space{space}
+{
+}
+
+void FeasibilityTracker::clear()
+{
+    m_entries.clear();
+    m_indices.clear();
+    m_dependents.clear();
+    m_dirty.clear();
+    m_bounded.clear();
+    m_maximumRange = 0;
+    m_halfBounded.clear();
+    m_groups.clear();
+    m_infeasibleCount = 0;
+}
+
+void FeasibilityTracker::addObject(const LinkObject* object)
+{
+    Expects(object);
+    Expects(!m_indices.contains(object));
+    auto const index = m_entries.size();
+    Entry entry;
+    entry.object = object;
+    m_entries.push_back(entry);
+    m_indices[object] = index;
+    for (auto const* other : object->references())
+    {
+        m_dependents[other].push_back(index);
+    }
+    markDirty(index);
+}
+
+void FeasibilityTracker::setWaiting(const LinkObject* object, bool isWaiting)
+{
+    auto const index = m_indices.at(object);
+    m_entries[index].isWaiting = isWaiting;
+    markDirty(index);
+    if (auto const dependents = m_dependents.find(object); dependents != m_dependents.end())
+    {
+        for (auto const dependent : dependents->second)
+        {
+            markDirty(dependent);
+        }
+    }
+}
+
+bool FeasibilityTracker::isFeasible()
+{
+    // objects are only updated here, when all allocations are settled
+    for (auto const index : m_dirty)
+    {
+        m_entries[index].isDirty = false;
+        if (m_entries[index].isTracked)
+        {
+            untrack(index);
+        }
+        if (m_entries[index].isWaiting)
+        {
+            track(index);
+        }
+    }
+    m_dirty.clear();
+
+    auto isFeasible = m_infeasibleCount == 0;
+    for (auto const& [key, group] : m_groups)
+    {
+        if (!group.waiting.empty() &&
+            (group.usable.empty() || *group.usable.rbegin() < *group.waiting.rbegin()))
+        {
+            isFeasible = false;
+        }
+    }
+    checkConsistency(isFeasible);
+    return isFeasible;
+}
+
+void FeasibilityTracker::blockAdded(const FreeBlock& block)
+{
+    update(block, true);
+}
+
+void FeasibilityTracker::blockRemoved(const FreeBlock& block)
+{
+    update(block, false);
+}
+
+void FeasibilityTracker::markDirty(size_t index)
+{
+    if (!m_entries[index].isDirty)
+    {
+        m_entries[index].isDirty = true;
+        m_dirty.push_back(index);
+    }
+}
+
+void FeasibilityTracker::track(size_t index)
+{
+    auto& entry = m_entries[index];
+    entry.placement = entry.object->placement();
+    entry.isTracked = true;
+    if (!entry.placement)
+    {
+        entry.kind = Kind::Impossible;
+        m_infeasibleCount += 1;
+    }
+    else if (!entry.placement->isBounded())
+    {
+        entry.kind = Kind::Unbounded;
+        auto const key = std::make_pair(entry.placement->alignment, entry.placement->targets);
+        auto group = m_groups.find(key);
+        if (group == m_groups.end())
+        {
+            group = m_groups.emplace(key, Group{}).first;
+            for (size_t i = 0; i < m_space->blockCount(); ++i)
+            {
+                if (isAllowed(key.second, m_space->block(i)))
+                {
+                    group->second.usable.insert(usableSize(m_space->block(i), key.first));
+                }
+            }
+        }
+        entry.size = group->second.waiting.insert(entry.object->size());
+    }
+    else
+    {
+        if (entry.placement->lower && entry.placement->upper)
+        {
+            entry.kind = Kind::Bounded;
+            entry.bound = m_bounded.emplace(entry.placement->upper->toInteger(), index);
+            auto const range = entry.placement->upper->subtract(*entry.placement->lower);
+            m_maximumRange = std::max(m_maximumRange, static_cast<size_t>(range));
+        }
+        else
+        {
+            entry.kind = Kind::HalfBounded;
+            m_halfBounded.push_back(index);
+        }
+        entry.blockCount = countBlocks(entry);
+        if (entry.blockCount == 0)
+        {
+            m_infeasibleCount += 1;
+        }
+    }
+}
+
+void FeasibilityTracker::untrack(size_t index)
+{
+    auto& entry = m_entries[index];
+    entry.isTracked = false;
+    switch (entry.kind)
+    {
+    case Kind::Impossible:
+        m_infeasibleCount -= 1;
+        return;
+    case Kind::Unbounded:
+        m_groups.at(std::make_pair(entry.placement->alignment, entry.placement->targets))
+            .waiting.erase(entry.size);
+        return;
+    case Kind::Bounded:
+        m_bounded.erase(entry.bound);
+        break;
+    case Kind::HalfBounded:
+        m_halfBounded.erase(std::find(m_halfBounded.begin(), m_halfBounded.end(), index));
+        break;
+    }
+    if (entry.blockCount == 0)
+    {
+        m_infeasibleCount -= 1;
+    }
+}
+
+void FeasibilityTracker::update(const FreeBlock& block, bool isAdded)
+{
+    for (auto& [key, group] : m_groups)
+    {
+        if (!isAllowed(key.second, block))
+        {
+            continue;
+        }
+        auto const usable = usableSize(block, key.first);
+        if (isAdded)
+        {
+            group.usable.insert(usable);
+        }
+        else
+        {
+            group.usable.erase(group.usable.find(usable));
+        }
+    }
+
+    // a bounded object overlaps the block if its upper bound lies after the block's start and its
+    // lower bound before the block's end, which limits its upper bound by the largest range
+    auto const end = block.endAddress().toInteger() + m_maximumRange;
+    for (auto iter = m_bounded.upper_bound(block.address().toInteger());
+         iter != m_bounded.end() && iter->first < end; ++iter)
+    {
+        count(iter->second, block, isAdded);
+    }
+    for (auto const index : m_halfBounded)
+    {
+        count(index, block, isAdded);
+    }
+}
+
+void FeasibilityTracker::count(size_t index, const FreeBlock& block, bool isAdded)
+{
+    auto& entry = m_entries[index];
+    if (!entry.placement->fits(block, entry.object->size()))
+    {
+        return;
+    }
+    if (isAdded)
+    {
+        if (entry.blockCount++ == 0)
+        {
+            m_infeasibleCount -= 1;
+        }
+    }
+    else if (--entry.blockCount == 0)
+    {
+        m_infeasibleCount += 1;
+    }
+}
+
+auto FeasibilityTracker::countBlocks(const Entry& entry) const -> size_t
+{
+    size_t count{0};
+    for (size_t target = 0; target < m_space->targetCount(); ++target)
+    {
+        if (!entry.placement->allowsTarget(target))
+        {
+            continue;
+        }
+        auto const [first, last] = m_space->findBlocksWithinRange(target, entry.placement->lower,
+                                                                  entry.placement->upper);
+        for (auto i = first; i < last; ++i)
+        {
+            if (entry.placement->fits(m_space->block(i), entry.object->size()))
+            {
+                count += 1;
+            }
+        }
+    }
+    return count;
+}
+
+/// Compares the result with asking every waiting object, which is what the tracker avoids, so it
+/// is only done in debug builds.
+void FeasibilityTracker::checkConsistency([[maybe_unused]] bool isFeasible) const
+{
+#ifndef NDEBUG
+    auto const isEveryObjectAllocatable =
+        std::all_of(m_entries.cbegin(), m_entries.cend(), [this](auto const& entry) {
+            return !entry.isWaiting || entry.object->hasAllocations(*m_space);
+        });
+    Expects(isFeasible == isEveryObjectAllocatable);
+#endif
+}
+
+} // namespace kaizo::data
@@ -3,13 +3,20 @@
 
 namespace kaizo::data {
 
-FreeBlock::FreeBlock(const size_t offset, const Address address, size_t size)
+FreeBlock::FreeBlock(const size_t offset, const Address address, size_t size, size_t target)
     : m_offset{offset}
     , m_address{address}
     , m_size{size}
+    , m_target{target}
 {
     Expects(address.isValid());
     Expects(size > 0);
+    Expects(target < MaximumTargetCount);
+}
+
+auto FreeBlock::target() const -> size_t
+{
+    return m_target;
 }
 
 auto FreeBlock::offset() const -> size_t
@@ -52,6 +59,26 @@ bool FreeBlock::fits(const Address address, size_t length) const
     return !(address < m_address) && (m_size - address.subtract(m_address)) >= length;
 }
 
+auto FreeBlock::alignedFit(size_t size, size_t alignment) const -> std::optional<Address>
+{
+    Expects(alignment > 0);
+    auto const padding = (alignment - m_address.toInteger() % alignment) % alignment;
+    if (padding + size > m_size)
+    {
+        return {};
+    }
+
+    // a gap at the end only remains if the object is placed at the start; placing it at the end
+    // keeps the rest of the block in one piece if that wastes fewer bytes
+    auto const last = m_address.applyOffset(m_size - size);
+    auto const endGap = last.toInteger() % alignment;
+    if (padding > 0 && endGap < padding)
+    {
+        return last.applyOffset(-static_cast<int64_t>(endGap));
+    }
+    return m_address.applyOffset(padding);
+}
+
 auto FreeBlock::allocate(const Address address, size_t length) const -> SplitFreeBlocks
 {
     if (length == m_size)
@@ -60,19 +87,21 @@ auto FreeBlock::allocate(const Address address, size_t length) const -> SplitFre
     }
     else if (address == m_address)
     {
-        return SplitFreeBlocks{
-            FreeBlock{m_offset + length, m_address.applyOffset(length), m_size - length}};
+        return SplitFreeBlocks{FreeBlock{m_offset + length, m_address.applyOffset(length),
+                                         m_size - length, m_target}};
     }
     else if (m_address.applyOffset(m_size) == address.applyOffset(length))
     {
-        return SplitFreeBlocks{FreeBlock{m_offset, m_address, m_size - length}};
+        return SplitFreeBlocks{FreeBlock{m_offset, m_address, m_size - length, m_target}};
     }
     else
     {
-        FreeBlock left{m_offset, m_address, static_cast<size_t>(address.subtract(m_address))};
+        FreeBlock left{m_offset, m_address, static_cast<size_t>(address.subtract(m_address)),
+                       m_target};
         auto const allocatedEndAddress = address.applyOffset(length);
         auto const rightSize = endAddress().subtract(allocatedEndAddress);
-        FreeBlock right{m_offset + length, allocatedEndAddress, static_cast<size_t>(rightSize)};
+        FreeBlock right{m_offset + allocatedEndAddress.subtract(m_address), allocatedEndAddress,
+                        static_cast<size_t>(rightSize), m_target};
         return SplitFreeBlocks{left, right};
     }
 }
@@ -88,7 +117,7 @@ auto FreeBlock::toString() const -> std::string
 
 static bool operator<(const FreeBlock& a, const FreeBlock& b)
 {
-    return a.address() < b.address();
+    return a.target() < b.target() || (a.target() == b.target() && a.address() < b.address());
 }
 
 SplitFreeBlocks::SplitFreeBlocks(FreeBlock a)
@@ -1,155 +1,528 @@
 #include "kaizo/data/linking/FreeSpace.h"
 #include <algorithm>
 #include <contracts/Contracts.h>
-#include <numeric>
 
 namespace kaizo::data {
 
 static bool operator<(const FreeBlock& lhs, const FreeBlock& rhs)
 {
+    if (lhs.target() != rhs.target())
+    {
+        return lhs.target() < rhs.target();
+    }
     return lhs.address() < rhs.address();
 }
 
 FreeSpace::FreeSpace(std::vector<FreeBlock>&& blocks)
-    : m_blocks{std::move(blocks)}
 {
-    std::sort(m_blocks.begin(), m_blocks.end());
+    std::sort(blocks.begin(), blocks.end());
+    m_nodes.reserve(blocks.size());
+    for (auto const& block : blocks)
+    {
+        replaceBlocks(blockCount(), 0, SplitFreeBlocks{block});
+        m_targetCount = std::max(m_targetCount, block.target() + 1);
+    }
 }
 
-auto FreeSpace::findBlockThatContains(const Address address) -> std::optional<size_t>
+auto FreeSpace::findBlockThatContains(size_t target, const Address address) const
+    -> std::optional<size_t>
 {
-    auto lower = m_blocks.begin();
-    auto upper = m_blocks.end();
-    while (upper > lower)
-    {
-        auto const step = std::distance(lower, upper) / 2;
-        auto middle = lower + step;
-        if (middle->contains(address))
+    // the block that contains the address is the last one starting at or before it
+    auto const index = partitionPoint([&](auto const& block) {
+        if (block.target() != target)
         {
-            return std::distance(m_blocks.begin(), middle);
+            return block.target() < target;
         }
-        else if (middle->address() < address)
-        {
-            lower = middle + 1;
-        }
-        else
+        return !(address < block.address());
+    });
+    if (index > 0 && block(index - 1).target() == target && block(index - 1).contains(address))
+    {
+        return index - 1;
+    }
+    return {};
+}
+
+auto FreeSpace::findFirstBlockThatFits(size_t size) const -> std::optional<size_t>
+{
+    if (m_root == NoNode || largest(m_root) < size)
+    {
+        return {};
+    }
+
+    // descends towards the leftmost subtree whose largest block fits
+    size_t index{0};
+    auto node = m_root;
+    while (true)
+    {
+        auto const& current = m_nodes[node];
+        if (current.left != NoNode && largest(current.left) >= size)
         {
-            upper = middle;
+            node = current.left;
+            continue;
         }
-        if (step == 0)
+        index += count(current.left);
+        if (current.block.size() >= size)
         {
-            break;
+            return index;
         }
+        ++index;
+        node = current.right;
+    }
+}
+
+auto FreeSpace::findBestFit(size_t size) const -> std::optional<size_t>
+{
+    if (auto const iter = m_sizes.lower_bound(size); iter != m_sizes.end())
+    {
+        return indexOf(iter->target, iter->address);
     }
     return {};
 }
 
-auto FreeSpace::findFirstBlockThatFits(size_t size) const -> std::optional<size_t>
+auto FreeSpace::findWorstFit(size_t size) const -> std::optional<size_t>
 {
-    for (auto i = 0U; i < m_blocks.size(); ++i)
+    if (hasBlockThatFits(size))
     {
-        if (m_blocks[i].size() >= size)
-        {
-            return i;
-        }
+        return indexOf(m_sizes.rbegin()->target, m_sizes.rbegin()->address);
     }
     return {};
 }
 
 bool FreeSpace::hasBlockThatFits(size_t size) const
 {
-    return findFirstBlockThatFits(size).has_value();
+    return !m_sizes.empty() && m_sizes.rbegin()->size >= size;
 }
 
 auto FreeSpace::findBlocksThatFit(size_t size) const -> std::vector<size_t>
 {
     std::vector<size_t> blocks;
-    for (auto i = 0U; i < m_blocks.size(); ++i)
-    {
-        if (m_blocks[i].size() >= size)
+    visitBlocksThatFit(size, [&](size_t index, const FreeBlock&) { blocks.push_back(index); });
+    return blocks;
+}
+
+auto FreeSpace::findBlocksThatFit(size_t size, size_t alignment) const -> std::vector<size_t>
+{
+    std::vector<size_t> blocks;
+    visitBlocksThatFit(size, [&](size_t index, const FreeBlock& block) {
+        if (block.alignedFit(size, alignment))
         {
-            blocks.push_back(i);
+            blocks.push_back(index);
         }
-    }
+    });
     return blocks;
 }
 
+auto FreeSpace::findBlocksWithinRange(size_t target, const std::optional<Address>& lower,
+                                      const std::optional<Address>& upper) const
+    -> std::pair<size_t, size_t>
+{
+    auto const [targetFirst, targetLast] = targetRange(target);
+    if (targetFirst != targetLast &&
+        ((lower && !lower->isCompatible(block(targetFirst).address())) ||
+         (upper && !upper->isCompatible(block(targetFirst).address()))))
+    {
+        return std::make_pair(targetFirst, targetFirst);
+    }
+
+    // the blocks of a target are disjoint, so their end addresses are ordered just like their
+    // addresses
+    auto first = targetFirst;
+    if (lower)
+    {
+        first = partitionPoint([&](auto const& block) {
+            if (block.target() != target)
+            {
+                return block.target() < target;
+            }
+            return block.endAddress() <= *lower;
+        });
+    }
+    auto last = targetLast;
+    if (upper)
+    {
+        last = std::max(first, partitionPoint([&](auto const& block) {
+                            if (block.target() != target)
+                            {
+                                return block.target() < target;
+                            }
+                            return block.address() < *upper;
+                        }));
+    }
+    return std::make_pair(first, last);
+}
+
 auto FreeSpace::blockCount() const -> size_t
 {
-    return m_blocks.size();
+    return count(m_root);
 }
 
 auto FreeSpace::capacity() const -> size_t
 {
-    return std::accumulate(m_blocks.cbegin(), m_blocks.cend(), static_cast<size_t>(0),
-                           [](auto sum, auto const& block) { return sum + block.size(); });
+    return m_capacity;
+}
+
+auto FreeSpace::targetCount() const -> size_t
+{
+    return m_targetCount;
+}
+
+auto FreeSpace::largestBlockSize() const -> size_t
+{
+    return m_sizes.empty() ? 0 : m_sizes.rbegin()->size;
+}
+
+auto FreeSpace::blockSizes() const -> std::vector<size_t>
+{
+    std::vector<size_t> sizes;
+    sizes.reserve(m_sizes.size());
+    for (auto iter = m_sizes.crbegin(); iter != m_sizes.crend(); ++iter)
+    {
+        sizes.push_back(iter->size);
+    }
+    return sizes;
 }
 
 auto FreeSpace::block(size_t index) const -> const FreeBlock&
 {
-    return m_blocks[index];
+    return m_nodes[nodeAt(index)].block;
 }
 
 void FreeSpace::allocate(size_t hint, const Address address, size_t length)
 {
-    Expects(m_blocks[hint].fits(address, length));
-    auto const splitBlocks = m_blocks[hint].allocate(address, length);
-    Split split;
-    split.begin = hint;
-    split.end = hint + splitBlocks.size();
-    split.original = m_blocks[hint];
-    m_splits.push(split);
+    auto const& original = block(hint);
+    Expects(original.fits(address, length));
+    auto const splitBlocks = original.allocate(address, length);
+    m_splits.push_back(Split{original, splitBlocks});
+    replaceBlocks(hint, 1, splitBlocks);
+    checkInvariants();
+}
+
+void FreeSpace::allocate(size_t hint, size_t length)
+{
+    allocate(hint, block(hint).address(), length);
+}
 
-    if (split.isDeletion())
+void FreeSpace::allocateRange(size_t target, const Address address, size_t length)
+{
+    if (auto maybeBlock = findBlockThatContains(target, address))
     {
-        m_blocks.erase(m_blocks.begin() + hint);
+        // TODO: given address range might span several blocks!
+        allocate(*maybeBlock, address, length);
     }
-    else
+}
+
+void FreeSpace::deallocateLast()
+{
+    Expects(!m_splits.empty());
+    // the blocks the allocation left over start where the original did, or there are none
+    auto const& split = m_splits.back();
+    auto const index = indexOf(split.original.target(), split.original.address());
+    Expects(split.blocks.size() == 0 ||
+            (index < blockCount() && block(index).address() == split.blocks[0].address()));
+    replaceBlocks(index, split.blocks.size(), SplitFreeBlocks{split.original});
+    m_splits.pop_back();
+    checkInvariants();
+}
+
+auto FreeSpace::allocationCount() const -> size_t
+{
+    return m_splits.size();
+}
+
+void FreeSpace::addBlock(const FreeBlock& block)
+{
+    replaceBlocks(partitionPoint([&](auto const& other) { return !(block < other); }), 0,
+                  SplitFreeBlocks{block});
+    m_targetCount = std::max(m_targetCount, block.target() + 1);
+    checkInvariants();
+}
+
+void FreeSpace::setObserver(FreeSpaceObserver* observer)
+{
+    m_observer = observer;
+}
+
+FreeSpace::ScopedObserver::ScopedObserver(FreeSpace& space, FreeSpaceObserver& observer)
+    : m_space{space}
+{
+    m_space.setObserver(&observer);
+}
+
+FreeSpace::ScopedObserver::~ScopedObserver()
+{
+    m_space.setObserver(nullptr);
+}
+
+auto FreeSpace::count(uint32_t node) const -> size_t
+{
+    return node != NoNode ? m_nodes[node].count : 0;
+}
+
+auto FreeSpace::largest(uint32_t node) const -> size_t
+{
+    return node != NoNode ? m_nodes[node].largest : 0;
+}
+
+void FreeSpace::update(uint32_t node)
+{
+    auto& current = m_nodes[node];
+    current.count = static_cast<uint32_t>(1 + count(current.left) + count(current.right));
+    current.largest =
+        std::max({current.block.size(), largest(current.left), largest(current.right)});
+}
+
+auto FreeSpace::nodeAt(size_t index) const -> uint32_t
+{
+    Expects(index < blockCount());
+    auto node = m_root;
+    while (true)
     {
-        m_blocks[hint] = splitBlocks[0];
-        for (auto i = 1U; i < splitBlocks.size(); ++i)
+        auto const& current = m_nodes[node];
+        auto const leftCount = count(current.left);
+        if (index == leftCount)
+        {
+            return node;
+        }
+        if (index < leftCount)
+        {
+            node = current.left;
+        }
+        else
         {
-            m_blocks.insert(m_blocks.begin() + hint + i, splitBlocks[i]);
+            index -= leftCount + 1;
+            node = current.right;
         }
     }
 }
 
-void FreeSpace::allocate(size_t hint, size_t length)
+template <typename Predicate>
+auto FreeSpace::partitionPoint(Predicate isBefore) const -> size_t
+{
+    size_t index{0};
+    auto node = m_root;
+    while (node != NoNode)
+    {
+        auto const& current = m_nodes[node];
+        if (isBefore(current.block))
+        {
+            index += count(current.left) + 1;
+            node = current.right;
+        }
+        else
+        {
+            node = current.left;
+        }
+    }
+    return index;
+}
+
+template <typename Visitor>
+void FreeSpace::visitBlocksThatFit(size_t size, Visitor visit) const
 {
-    allocate(hint, m_blocks[hint].address(), length);
+    // subtrees whose largest block is too small are skipped entirely
+    auto const visitSubtree = [&](auto const& self, uint32_t node, size_t first) -> void {
+        if (node == NoNode || m_nodes[node].largest < size)
+        {
+            return;
+        }
+        auto const& current = m_nodes[node];
+        self(self, current.left, first);
+        auto const index = first + count(current.left);
+        if (current.block.size() >= size)
+        {
+            visit(index, current.block);
+        }
+        self(self, current.right, index + 1);
+    };
+    visitSubtree(visitSubtree, m_root, 0);
 }
 
-void FreeSpace::allocateRange(const Address address, size_t length)
+auto FreeSpace::split(uint32_t node, size_t index) -> std::pair<uint32_t, uint32_t>
 {
-    if (auto maybeBlock = findBlockThatContains(address))
+    if (node == NoNode)
     {
-        // TODO: given address range might span several blocks!
-        allocate(*maybeBlock, address, length);
+        return std::make_pair(NoNode, NoNode);
     }
+    auto const leftCount = count(m_nodes[node].left);
+    if (index <= leftCount)
+    {
+        auto const [first, rest] = split(m_nodes[node].left, index);
+        m_nodes[node].left = rest;
+        update(node);
+        return std::make_pair(first, node);
+    }
+    auto const [rest, last] = split(m_nodes[node].right, index - leftCount - 1);
+    m_nodes[node].right = rest;
+    update(node);
+    return std::make_pair(node, last);
 }
 
-void FreeSpace::deallocateLast()
+auto FreeSpace::merge(uint32_t left, uint32_t right) -> uint32_t
 {
-    Expects(!m_splits.empty());
-    auto const& split = m_splits.top();
-    if (split.isDeletion())
+    if (left == NoNode || right == NoNode)
+    {
+        return left == NoNode ? right : left;
+    }
+    if (m_nodes[left].priority > m_nodes[right].priority)
+    {
+        auto const merged = merge(m_nodes[left].right, right);
+        m_nodes[left].right = merged;
+        update(left);
+        return left;
+    }
+    auto const merged = merge(left, m_nodes[right].left);
+    m_nodes[right].left = merged;
+    update(right);
+    return right;
+}
+
+auto FreeSpace::indexOf(size_t target, const Address& address) const -> size_t
+{
+    return partitionPoint([&](auto const& block) {
+        if (block.target() != target)
+        {
+            return block.target() < target;
+        }
+        return block.address() < address;
+    });
+}
+
+auto FreeSpace::targetRange(size_t target) const -> std::pair<size_t, size_t>
+{
+    auto const first = partitionPoint([&](auto const& block) { return block.target() < target; });
+    auto const last = partitionPoint([&](auto const& block) { return block.target() <= target; });
+    return std::make_pair(first, last);
+}
+
+void FreeSpace::assign(uint32_t node, size_t index, const FreeBlock& block)
+{
+    auto const leftCount = count(m_nodes[node].left);
+    if (index < leftCount)
+    {
+        assign(m_nodes[node].left, index, block);
+    }
+    else if (index > leftCount)
     {
-        m_blocks.insert(m_blocks.begin() + split.begin, split.original);
+        assign(m_nodes[node].right, index - leftCount - 1, block);
     }
     else
     {
-        m_blocks[split.begin] = split.original;
-        if (split.begin + 1 < split.end)
+        m_nodes[node].block = block;
+    }
+    update(node);
+}
+
+void FreeSpace::replaceBlocks(size_t index, size_t replaced, const SplitFreeBlocks& blocks)
+{
+    Expects(index + replaced <= blockCount());
+    auto const removeKey = [this](const FreeBlock& block) {
+        if (m_observer)
+        {
+            m_observer->blockRemoved(block);
+        }
+        m_sizes.erase(SizeKey{block.size(), block.target(), block.address()});
+        m_capacity -= block.size();
+    };
+    auto const addKey = [this](const FreeBlock& block) {
+        m_sizes.insert(SizeKey{block.size(), block.target(), block.address()});
+        m_capacity += block.size();
+        if (m_observer)
+        {
+            m_observer->blockAdded(block);
+        }
+    };
+
+    // blocks taking the place of another one are assigned in place, which keeps the tree's shape
+    auto const common = std::min(replaced, blocks.size());
+    for (size_t i = 0; i < common; ++i)
+    {
+        removeKey(block(index + i));
+        assign(m_root, index + i, blocks[i]);
+        addKey(blocks[i]);
+    }
+
+    if (replaced > common)
+    {
+        auto const [first, rest] = split(m_root, index + common);
+        auto const [removed, last] = split(rest, replaced - common);
+        m_root = merge(first, last);
+        std::vector<uint32_t> pending{removed};
+        while (!pending.empty())
+        {
+            auto const node = pending.back();
+            pending.pop_back();
+            if (node != NoNode)
+            {
+                removeKey(m_nodes[node].block);
+                m_freeNodes.push_back(node);
+                pending.push_back(m_nodes[node].left);
+                pending.push_back(m_nodes[node].right);
+            }
+        }
+    }
+    else if (blocks.size() > common)
+    {
+        auto middle = NoNode;
+        for (auto i = common; i < blocks.size(); ++i)
         {
-            m_blocks.erase(m_blocks.begin() + split.begin + 1, m_blocks.end() + split.end);
+            uint32_t node{0};
+            if (m_freeNodes.empty())
+            {
+                node = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.emplace_back();
+            }
+            else
+            {
+                node = m_freeNodes.back();
+                m_freeNodes.pop_back();
+            }
+            m_nodes[node] = Node{blocks[i], NoNode, NoNode, static_cast<uint32_t>(m_priorities())};
+            update(node);
+            middle = merge(middle, node);
+            addKey(blocks[i]);
         }
+        auto const [first, last] = split(m_root, index + common);
+        m_root = merge(merge(first, middle), last);
     }
-    m_splits.pop();
 }
 
-void FreeSpace::addBlock(const FreeBlock& block)
+/// Checks that the blocks are sorted, disjoint within each target and agree with the size index and
+/// the capacity, and that the tree's priorities and subtree summaries are consistent.
+/// This walks every block, so it is only done in debug builds.
+void FreeSpace::checkInvariants() const
 {
-    m_blocks.insert(std::upper_bound(m_blocks.begin(), m_blocks.end(), block), block);
+#ifndef NDEBUG
+    Expects(m_sizes.size() == blockCount());
+    Expects(m_nodes.size() == blockCount() + m_freeNodes.size());
+    size_t capacity{0};
+    const FreeBlock* previous{nullptr};
+    auto const check = [&](auto const& self, uint32_t node) -> void {
+        if (node == NoNode)
+        {
+            return;
+        }
+        auto const& current = m_nodes[node];
+        Expects(current.count == 1 + count(current.left) + count(current.right));
+        Expects(current.largest ==
+                std::max({current.block.size(), largest(current.left), largest(current.right)}));
+        Expects(current.left == NoNode || m_nodes[current.left].priority <= current.priority);
+        Expects(current.right == NoNode || m_nodes[current.right].priority <= current.priority);
+        self(self, current.left);
+
+        auto const& block = current.block;
+        Expects(block.isValid());
+        Expects(!previous || previous->target() < block.target() ||
+                (previous->target() == block.target() &&
+                 previous->endAddress() <= block.address()));
+        Expects(m_sizes.contains(SizeKey{block.size(), block.target(), block.address()}));
+        capacity += block.size();
+        previous = &block;
+
+        self(self, current.right);
+    };
+    check(check, m_root);
+    Expects(capacity == m_capacity);
+#endif
 }
 
-} // namespace kaizo::data
\ No newline at end of file
+} // namespace kaizo::data
@@ -0,0 +1,96 @@
+#include "kaizo/data/linking/GreedyPacker.h"
+#include <algorithm>
+#include <optional>
+#include <tuple>
+
+namespace kaizo::data {
+
+GreedyPacker::GreedyPacker(Fit fit)
+    : m_fit{fit}
+{
+}
+
+bool GreedyPacker::doPack()
+{
+    std::vector<LinkObject*> objects;
+    objects.reserve(m_linkObjects.size());
+    for (auto const& object : m_linkObjects)
+    {
+        objects.push_back(object.get());
+    }
+    return allocateGreedily(*this, m_freeSpace, std::move(objects), m_fit, true).empty() &&
+           isSolved();
+}
+
+static auto chooseAllocation(const FreeSpace& space, const LinkObject& object,
+                             GreedyPacker::Fit fit) -> std::optional<Allocation>
+{
+    if (object.isUnconstrained())
+    {
+        auto const index = fit == GreedyPacker::Fit::First
+                               ? space.findFirstBlockThatFits(object.size())
+                               : space.findBestFit(object.size());
+        if (!index)
+        {
+            return {};
+        }
+        auto const& block = space.block(*index);
+        Allocation allocation;
+        allocation.block = *index;
+        allocation.offset = block.offset();
+        allocation.address = block.address();
+        allocation.size = block.size();
+        allocation.target = block.target();
+        return allocation;
+    }
+
+    auto const allocations = object.findAllocations(space);
+    if (allocations.empty())
+    {
+        return {};
+    }
+    if (fit == GreedyPacker::Fit::First)
+    {
+        return *std::min_element(
+            allocations.cbegin(), allocations.cend(),
+            [](auto const& a, auto const& b) {
+                return std::tie(a.target, a.address) < std::tie(b.target, b.address);
+            });
+    }
+    return *std::min_element(allocations.cbegin(), allocations.cend(),
+                             [](auto const& a, auto const& b) { return a.size < b.size; });
+}
+
+auto allocateGreedily(const Packer& packer, FreeSpace& space, std::vector<LinkObject*> objects,
+                      GreedyPacker::Fit fit, bool stopAtFailure) -> std::vector<LinkObject*>
+{
+    std::stable_sort(objects.begin(), objects.end(), [](auto const* a, auto const* b) {
+        return std::make_tuple(a->hasFixedAddress(), a->isConstrained(), a->size()) >
+               std::make_tuple(b->hasFixedAddress(), b->isConstrained(), b->size());
+    });
+
+    std::vector<LinkObject*> residual;
+    for (auto object = objects.cbegin(); object != objects.cend(); ++object)
+    {
+        if (packer.isStopped() || (stopAtFailure && !residual.empty()))
+        {
+            residual.insert(residual.end(), object, objects.cend());
+            break;
+        }
+        if (auto const allocation = chooseAllocation(space, **object, fit))
+        {
+            (*object)->setAllocation(*allocation);
+            if (packer.satisfiesDependents(**object))
+            {
+                space.allocateRange(allocation->target, allocation->address, (*object)->size());
+                continue;
+            }
+            // an object allocated before is constrained relative to this one and rules it out
+            (*object)->unsetAllocation();
+        }
+        residual.push_back(*object);
+    }
+    return residual;
+}
+
+} // namespace kaizo::data
@@ -37,15 +37,24 @@ bool LinkObject::hasAllocation() const
     return m_allocation.has_value();
 }
 
-void LinkObject::setFixedAddress(const Address)
+bool LinkObject::isSatisfied() const
 {
-    // m_address = address;
-    m_hasFixedAddress = true;
+    if (!m_allocation)
+    {
+        return false;
+    }
+    return !m_constraint ||
+           m_constraint->isSatisfiedBy(m_allocation->target, m_allocation->address, m_size);
+}
+
+void LinkObject::setFixedAddress(const Address address)
+{
+    constrain(std::make_unique<FixedAddressConstraint>(address));
 }
 
 bool LinkObject::hasFixedAddress() const
 {
-    return m_hasFixedAddress;
+    return m_constraint && m_constraint->yieldsFixedAddress().has_value();
 }
 
 auto LinkObject::allocation() const -> const Allocation&
@@ -54,6 +63,42 @@ auto LinkObject::allocation() const -> const Allocation&
     return *m_allocation;
 }
 
+auto LinkObject::copy() const -> std::unique_ptr<LinkObject>
+{
+    auto object = std::make_unique<LinkObject>(m_id, m_size);
+    if (m_constraint)
+    {
+        object->m_constraint = m_constraint->copy();
+    }
+    return object;
+}
+
+void LinkObject::rebind(const std::unordered_map<const LinkObject*, const LinkObject*>& copies)
+{
+    if (m_constraint)
+    {
+        m_constraint->rebind(copies);
+    }
+}
+
+auto LinkObject::placement() const -> std::optional<Placement>
+{
+    if (m_constraint)
+    {
+        return m_constraint->placement(size());
+    }
+    return Placement{};
+}
+
+auto LinkObject::references() const -> std::vector<const LinkObject*>
+{
+    if (m_constraint)
+    {
+        return m_constraint->references();
+    }
+    return {};
+}
+
 auto LinkObject::findAllocations(const FreeSpace& space) const -> std::vector<Allocation>
 {
     if (m_constraint)
@@ -66,10 +111,12 @@ auto LinkObject::findAllocations(const FreeSpace& space) const -> std::vector<Al
         std::vector<Allocation> allocations(blocks.size());
         for (auto i = 0U; i < blocks.size(); ++i)
         {
-            allocations[i].address = space.block(blocks[i]).address();
-            allocations[i].size = space.block(blocks[i]).size();
-            allocations[i].offset = space.block(blocks[i]).offset();
+            auto const& block = space.block(blocks[i]);
+            allocations[i].address = block.address();
+            allocations[i].size = block.size();
+            allocations[i].offset = block.offset();
             allocations[i].block = blocks[i];
+            allocations[i].target = block.target();
         }
         return allocations;
     }
@@ -100,7 +147,32 @@ auto LinkObject::measureSlack(const FreeSpace& space) const -> size_t
 
 void LinkObject::constrain(std::unique_ptr<Constraint>&& constraint)
 {
-    m_constraint = std::move(constraint);
+    Expects(constraint);
+    if (!m_constraint)
+    {
+        m_constraint = std::move(constraint);
+    }
+    else
+    {
+        std::vector<std::unique_ptr<Constraint>> constraints;
+        constraints.push_back(std::move(m_constraint));
+        constraints.push_back(std::move(constraint));
+        m_constraint = std::make_unique<AndConstraint>(std::move(constraints));
+    }
+}
+
+void LinkObject::constrainSameSegment(LinkObject& other, size_t segmentSize)
+{
+    Expects(&other != this);
+    constrain(std::make_unique<SameSegmentConstraint>(&other, segmentSize));
+    other.constrain(std::make_unique<SameSegmentConstraint>(this, segmentSize));
+}
+
+void LinkObject::constrainRelative(LinkObject& other, int64_t minimum, int64_t maximum)
+{
+    Expects(&other != this && minimum <= maximum);
+    constrain(std::make_unique<RelativeRangeConstraint>(&other, minimum, maximum));
+    other.constrain(std::make_unique<RelativeRangeConstraint>(this, -maximum, -minimum));
 }
 
 bool LinkObject::isConstrained() const
@@ -0,0 +1,149 @@
+#include "kaizo/data/linking/Packer.h"
+#include <algorithm>
+#include <contracts/Contracts.h>
+#include <unordered_map>
+
+namespace kaizo::data {
+
+void Packer::setFreeBlocks(std::vector<FreeBlock>&& blocks)
+{
+    m_freeSpace = FreeSpace{std::move(blocks)};
+}
+
+void Packer::addFreeBlock(const FreeBlock& block)
+{
+    m_freeSpace.addBlock(block);
+}
+
+auto Packer::addTarget(const Target& target) -> size_t
+{
+    auto const index = std::max(m_targetCount, m_freeSpace.targetCount());
+    Expects(index < MaximumTargetCount);
+    m_targetCount = index + 1;
+    for (size_t i = 0; i < target.freeBlockCount(); ++i)
+    {
+        auto const& block = target.freeBlock(i);
+        addFreeBlock(FreeBlock{block.offset(), block.address(), block.size(), index});
+    }
+    return index;
+}
+
+void Packer::addObject(std::unique_ptr<LinkObject>&& object)
+{
+    Expects(object);
+    m_objectSize += object->size();
+    m_linkObjects.push_back(std::move(object));
+}
+
+auto Packer::object(const size_t index) const -> LinkObject*
+{
+    return m_linkObjects[index].get();
+}
+
+auto Packer::objectCount() const -> size_t
+{
+    return m_linkObjects.size();
+}
+
+auto Packer::freeSpace() const -> const FreeSpace&
+{
+    return m_freeSpace;
+}
+
+void Packer::copyProblem(const Packer& other)
+{
+    m_freeSpace = other.m_freeSpace;
+    m_freeSpace.setObserver(nullptr);
+    m_targetCount = other.m_targetCount;
+    m_linkObjects.clear();
+    m_objectSize = 0;
+
+    std::unordered_map<const LinkObject*, const LinkObject*> copies;
+    for (auto const& object : other.m_linkObjects)
+    {
+        auto copy = object->copy();
+        copies[object.get()] = copy.get();
+        addObject(std::move(copy));
+    }
+    for (auto const& object : m_linkObjects)
+    {
+        object->rebind(copies);
+    }
+}
+
+void Packer::adoptAllocations(const Packer& other)
+{
+    Expects(other.objectCount() == objectCount());
+    for (auto i = 0U; i < m_linkObjects.size(); ++i)
+    {
+        auto const& allocation = other.object(i)->allocation();
+        m_linkObjects[i]->setAllocation(allocation);
+        m_freeSpace.allocateRange(allocation.target, allocation.address, m_linkObjects[i]->size());
+    }
+}
+
+void Packer::setTimeLimit(std::chrono::milliseconds limit)
+{
+    m_timeLimit = limit;
+}
+
+void Packer::cancel()
+{
+    m_isCancelled = true;
+}
+
+void Packer::setParent(const Packer* parent)
+{
+    m_parent = parent;
+}
+
+bool Packer::isStopped() const
+{
+    if (m_isCancelled.load(std::memory_order_relaxed))
+    {
+        return true;
+    }
+    if (m_deadline && std::chrono::steady_clock::now() >= *m_deadline)
+    {
+        return true;
+    }
+    return m_parent && m_parent->isStopped();
+}
+
+bool Packer::pack()
+{
+    if (m_timeLimit)
+    {
+        m_deadline = std::chrono::steady_clock::now() + *m_timeLimit;
+    }
+    m_dependents.clear();
+    for (auto const& object : m_linkObjects)
+    {
+        for (auto const* other : object->references())
+        {
+            m_dependents[other].push_back(object.get());
+        }
+    }
+    return doPack();
+}
+
+bool Packer::isSolved() const
+{
+    return std::all_of(m_linkObjects.cbegin(), m_linkObjects.cend(),
+                       [](auto const& object) { return object->isSatisfied(); });
+}
+
+bool Packer::satisfiesDependents(const LinkObject& object) const
+{
+    auto const dependents = m_dependents.find(&object);
+    if (dependents == m_dependents.cend())
+    {
+        return true;
+    }
+    return std::all_of(dependents->second.cbegin(), dependents->second.cend(),
+                       [](auto const* dependent) {
+                           return !dependent->hasAllocation() || dependent->isSatisfied();
+                       });
+}
+
+} // namespace kaizo::data
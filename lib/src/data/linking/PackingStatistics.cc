@@ -0,0 +1,107 @@
+#include "kaizo/data/linking/PackingStatistics.h"
+#include <algorithm>
+#include <bit>
+
+namespace kaizo::data {
+
+void Histogram::add(size_t value)
+{
+    auto const bucket = static_cast<size_t>(std::bit_width(value));
+    if (bucket >= m_buckets.size())
+    {
+        m_buckets.resize(bucket + 1);
+    }
+    m_buckets[bucket] += 1;
+    m_count += 1;
+    m_maximum = std::max(m_maximum, value);
+}
+
+void Histogram::clear()
+{
+    m_buckets.clear();
+    m_count = 0;
+    m_maximum = 0;
+}
+
+auto Histogram::buckets() const -> const std::vector<size_t>&
+{
+    return m_buckets;
+}
+
+auto Histogram::count() const -> size_t
+{
+    return m_count;
+}
+
+auto Histogram::maximum() const -> size_t
+{
+    return m_maximum;
+}
+
+ScopedTimer::ScopedTimer(std::chrono::nanoseconds* total)
+    : m_total{total}
+{
+    if (m_total)
+    {
+        m_start = std::chrono::steady_clock::now();
+    }
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    if (m_total)
+    {
+        *m_total += std::chrono::steady_clock::now() - m_start;
+    }
+}
+
+void PackingStatistics::clear()
+{
+    *this = {};
+}
+
+void PackingStatistics::addStep(const FreeSpace& space)
+{
+    steps += 1;
+    if (steps % m_sampleInterval == 0)
+    {
+        sampleFragmentation(space);
+    }
+}
+
+void PackingStatistics::sampleFragmentation(const FreeSpace& space)
+{
+    if (fragmentation.size() == MaximumSampleCount)
+    {
+        // keep every other sample, so that the samples still cover all steps evenly
+        for (auto i = 0U; i < MaximumSampleCount / 2; ++i)
+        {
+            fragmentation[i] = fragmentation[2 * i + 1];
+        }
+        fragmentation.resize(MaximumSampleCount / 2);
+        m_sampleInterval *= 2;
+        if (steps % m_sampleInterval != 0)
+        {
+            return;
+        }
+    }
+    fragmentation.push_back(
+        FragmentationSample{steps, space.blockCount(), space.capacity(), space.largestBlockSize()});
+}
+
+auto PackingStatistics::mostExhaustedObjects(size_t count) const
+    -> std::vector<std::pair<const LinkObject*, size_t>>
+{
+    std::vector<std::pair<const LinkObject*, size_t>> objects{exhaustedObjects.begin(),
+                                                              exhaustedObjects.end()};
+    count = std::min(count, objects.size());
+    std::partial_sort(objects.begin(), objects.begin() + static_cast<std::ptrdiff_t>(count),
+                      objects.end(), [](auto const& a, auto const& b) {
+                          return a.second > b.second ||
+                                 (a.second == b.second && a.first->id() < b.first->id());
+                      });
+    objects.resize(count);
+    return objects;
+}
+
+} // namespace kaizo::data
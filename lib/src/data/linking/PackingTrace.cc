@@ -0,0 +1,144 @@
+#include "kaizo/data/linking/PackingTrace.h"
+#include <stdexcept>
+
+namespace kaizo::data {
+
+// the writer is idle for so long when there are no events
+static constexpr std::chrono::milliseconds WriterInterval{1};
+
+static void appendInteger(std::vector<char>& buffer, uint64_t value, size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        buffer.push_back(static_cast<char>(value >> (8 * i) & 0xFF));
+    }
+}
+
+/// Appends the event, with the kind followed by three zero bytes.
+static void appendEvent(std::vector<char>& buffer, uint64_t time, uint64_t value, uint32_t object,
+                        PackingTrace::EventKind kind)
+{
+    appendInteger(buffer, time, 8);
+    appendInteger(buffer, value, 8);
+    appendInteger(buffer, object, 4);
+    appendInteger(buffer, static_cast<uint64_t>(kind), 4);
+}
+
+PackingTrace::~PackingTrace()
+{
+    close();
+}
+
+void PackingTrace::open(const std::filesystem::path& path, TraceLevel level,
+                        const FreeSpace& space,
+                        const std::vector<std::unique_ptr<LinkObject>>& objects)
+{
+    close();
+    if (level == TraceLevel::Off)
+    {
+        return;
+    }
+    m_file.open(path, std::ios::binary);
+    if (!m_file)
+    {
+        throw std::runtime_error{"PackingTrace: cannot open " + path.string()};
+    }
+
+    std::vector<char> header{'K', 'Z', 'P', 'T', 'R', 'A', 'C', 'E'};
+    appendInteger(header, Version, 4);
+    appendInteger(header, static_cast<uint64_t>(level), 4);
+    appendInteger(header, space.blockCount(), 4);
+    for (size_t i = 0; i < space.blockCount(); ++i)
+    {
+        appendInteger(header, space.block(i).offset(), 8);
+        appendInteger(header, space.block(i).size(), 8);
+    }
+    appendInteger(header, objects.size(), 4);
+    m_indices.clear();
+    for (auto const& object : objects)
+    {
+        m_indices.emplace(object.get(), static_cast<uint32_t>(m_indices.size()));
+        appendInteger(header, object->size(), 8);
+        appendInteger(header, object->id().size(), 4);
+        header.insert(header.end(), object->id().begin(), object->id().end());
+    }
+    m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    m_events.resize(Capacity);
+    m_head = 0;
+    m_tail = 0;
+    m_dropped = 0;
+    m_isClosing = false;
+    m_start = std::chrono::steady_clock::now();
+    m_level = level;
+    m_writer = std::thread{&PackingTrace::writeEvents, this};
+}
+
+void PackingTrace::close()
+{
+    if (m_level == TraceLevel::Off)
+    {
+        return;
+    }
+    m_level = TraceLevel::Off;
+    m_isClosing = true;
+    m_writer.join();
+    if (m_dropped > 0)
+    {
+        auto const time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start);
+        std::vector<char> buffer;
+        appendEvent(buffer, static_cast<uint64_t>(time.count()), m_dropped, NoObject,
+                    EventKind::Dropped);
+        m_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+    m_file.close();
+    m_events = {};
+}
+
+void PackingTrace::push(EventKind kind, const LinkObject* object, uint64_t value)
+{
+    auto const head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == Capacity)
+    {
+        m_dropped += 1;
+        return;
+    }
+    auto const index = object ? m_indices.at(object) : NoObject;
+    auto const time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_start);
+    m_events[head % Capacity] = Event{static_cast<uint64_t>(time.count()), value, index, kind};
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+void PackingTrace::writeEvents()
+{
+    std::vector<char> buffer;
+    auto tail = m_tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+        // events pushed before closing are seen once closing is
+        auto const isClosing = m_isClosing.load(std::memory_order_acquire);
+        auto const head = m_head.load(std::memory_order_acquire);
+        if (tail == head)
+        {
+            if (isClosing)
+            {
+                return;
+            }
+            std::this_thread::sleep_for(WriterInterval);
+            continue;
+        }
+
+        buffer.clear();
+        for (; tail != head; ++tail)
+        {
+            auto const& event = m_events[tail % Capacity];
+            appendEvent(buffer, event.time, event.value, event.object, event.kind);
+        }
+        m_tail.store(tail, std::memory_order_release);
+        m_file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+}
+
+} // namespace kaizo::data
@@ -0,0 +1,198 @@
+#include "kaizo/data/linking/Backtracker.h"
+#include "kaizo/data/linking/GreedyPacker.h"
+#include "kaizo/data/linking/PortfolioPacker.h"
+#include <algorithm>
+#include <contracts/Contracts.h>
+#include <kaizo/utilities/Parallel.h>
+#include <limits>
+#include <mutex>
+#include <random>
+
+namespace kaizo::data {
+
+namespace {
+
+// leaves room for scaling and offsetting scores
+constexpr long long MaximumSlack = 1LL << 48;
+
+auto scoreBySlack(const FreeSpace& space, const LinkObject& object) -> long long
+{
+    auto const slack = object.measureSlack(space);
+    return -static_cast<long long>(std::min(slack, static_cast<size_t>(MaximumSlack)));
+}
+
+/// Restarts backtracking with randomly perturbed slack scores and a growing step limit, so that
+/// an unlucky order of objects does not stall the search.
+class RestartingPacker : public Packer
+{
+public:
+    explicit RestartingPacker(unsigned seed)
+        : m_seed{seed}
+    {
+    }
+
+protected:
+    bool doPack() override
+    {
+        auto random = std::make_shared<std::mt19937>(m_seed);
+        for (size_t steps = InitialSteps; !isStopped(); steps *= 2)
+        {
+            BacktrackingPacker packer;
+            packer.copyProblem(*this);
+            packer.setParent(this);
+            packer.setGreedyFirst(false);
+            // the last restart searches exhaustively
+            if (steps <= MaximumSteps)
+            {
+                packer.setStepLimit(steps);
+            }
+            packer.setScoringStrategy([random](const FreeSpace& space, const LinkObject& object) {
+                return scoreBySlack(space, object) * static_cast<long long>(64 + (*random)() % 64);
+            });
+            if (packer.pack() && packer.isSolved())
+            {
+                adoptAllocations(packer);
+                return true;
+            }
+            if (!packer.reachedStepLimit())
+            {
+                break;
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr size_t InitialSteps = 1024;
+    static constexpr size_t MaximumSteps = size_t{1} << 24;
+
+    unsigned m_seed;
+};
+
+auto largestFreeBlock(const FreeSpace& space) -> long long
+{
+    if (auto const index = space.findWorstFit(0))
+    {
+        return static_cast<long long>(space.block(*index).size());
+    }
+    return 0;
+}
+
+} // namespace
+
+PortfolioPacker::PortfolioPacker()
+    : m_solutionScore{&largestFreeBlock}
+{
+    addStrategy("greedy best fit",
+                [] { return std::make_unique<GreedyPacker>(GreedyPacker::Fit::Best); });
+    addStrategy("greedy first fit",
+                [] { return std::make_unique<GreedyPacker>(GreedyPacker::Fit::First); });
+    // the greedy strategies above already cover what backtracking would try first
+    addStrategy("backtracking by slack", [] {
+        auto packer = std::make_unique<BacktrackingPacker>();
+        packer->setGreedyFirst(false);
+        return packer;
+    });
+    addStrategy("backtracking by size", [] {
+        auto packer = std::make_unique<BacktrackingPacker>();
+        packer->setGreedyFirst(false);
+        packer->setScoringStrategy([](const FreeSpace&, const LinkObject& object) {
+            return static_cast<long long>(object.size());
+        });
+        return packer;
+    });
+    addStrategy("backtracking constrained first", [] {
+        auto packer = std::make_unique<BacktrackingPacker>();
+        packer->setGreedyFirst(false);
+        packer->setScoringStrategy([](const FreeSpace& space, const LinkObject& object) {
+            auto const score = scoreBySlack(space, object);
+            return object.isConstrained() ? score : score - 2 * MaximumSlack;
+        });
+        return packer;
+    });
+    for (unsigned seed = 1; seed <= 3; ++seed)
+    {
+        addStrategy("random restarts " + std::to_string(seed),
+                    [seed] { return std::make_unique<RestartingPacker>(seed); });
+    }
+}
+
+void PortfolioPacker::addStrategy(const std::string& name, Strategy strategy)
+{
+    Expects(strategy);
+    m_strategies.push_back(NamedStrategy{name, std::move(strategy)});
+}
+
+void PortfolioPacker::clearStrategies()
+{
+    m_strategies.clear();
+}
+
+auto PortfolioPacker::strategyCount() const -> size_t
+{
+    return m_strategies.size();
+}
+
+void PortfolioPacker::setSolutionScore(SolutionScore score)
+{
+    Expects(score);
+    m_solutionScore = std::move(score);
+}
+
+void PortfolioPacker::setThreadCount(size_t threadCount)
+{
+    m_threadCount = threadCount;
+}
+
+auto PortfolioPacker::winner() const -> const std::string&
+{
+    return m_winner;
+}
+
+bool PortfolioPacker::doPack()
+{
+    Expects(!m_strategies.empty());
+
+    std::vector<std::unique_ptr<Packer>> packers;
+    for (auto const& strategy : m_strategies)
+    {
+        packers.push_back(strategy.strategy());
+        packers.back()->copyProblem(*this);
+        packers.back()->setParent(this);
+    }
+
+    std::mutex mutex;
+    std::vector<size_t> succeeded;
+    parallelFor(
+        packers.size(),
+        [&](size_t i) {
+            // strategies that have not started yet are skipped once another one succeeded; a
+            // strategy whose allocations violate constraints has not succeeded
+            if (packers[i]->isStopped() || !packers[i]->pack() || !packers[i]->isSolved())
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> lock{mutex};
+            succeeded.push_back(i);
+            for (auto const& packer : packers)
+            {
+                packer->cancel();
+            }
+        },
+        m_threadCount);
+
+    if (succeeded.empty())
+    {
+        return false;
+    }
+    auto const best = *std::max_element(
+        succeeded.cbegin(), succeeded.cend(), [&](auto const a, auto const b) {
+            return m_solutionScore(packers[a]->freeSpace()) <
+                   m_solutionScore(packers[b]->freeSpace());
+        });
+    adoptAllocations(*packers[best]);
+    m_winner = m_strategies[best].name;
+    return true;
+}
+
+} // namespace kaizo::data
@@ -1,13 +1,16 @@
-#include "Target.h"
-#include <diagnostics/Contracts.h>
+#include "kaizo/data/linking/Target.h"
+#include <contracts/Contracts.h>
+#include <kaizo/addresses/AddressFormat.h>
+#include <stdexcept>
 
-namespace fuse {
+namespace kaizo::data {
 
-Target::Target(const std::string& id, std::shared_ptr<AddressMap> addressMap)
+Target::Target(const std::string& id, std::shared_ptr<const AddressMap> addressMap)
     : m_id{id}
-    , m_addressMap{addressMap}
+    , m_addressMap{std::move(addressMap)}
 {
     Expects(!id.empty());
+    Expects(m_addressMap);
 }
 
 auto Target::id() const -> const std::string&
@@ -15,37 +18,21 @@ auto Target::id() const -> const std::string&
     return m_id;
 }
 
-void Target::setOutputPath(const std::filesystem::path& path)
+auto Target::addressMap() const -> const AddressMap&
 {
-    m_outputPath = path;
+    return *m_addressMap;
 }
 
-auto Target::outputPath() const -> const std::filesystem::path&
+void Target::addFreeBlock(size_t offset, size_t size)
 {
-    return m_outputPath;
-}
-
-void Target::setPath(const std::filesystem::path& path)
-{
-    m_fileName = path;
-}
-
-auto Target::path() const -> const std::filesystem::path&
-{
-    return m_fileName;
-}
-
-void Target::mapFreeBlock(const FreeBlock& block)
-{
-    if (auto maybeAddress = m_addressMap->toTargetAddress(block.address()))
-    {
-        m_freeBlocks.push_back(FreeBlock{*maybeAddress, block.size()});
-    }
-    else
+    auto const source = m_addressMap->sourceFormat().fromInteger(offset);
+    auto const address = source ? m_addressMap->toTargetAddress(*source) : std::nullopt;
+    if (!address)
     {
-        throw std::runtime_error{"could not map address " + block.address().toString() +
-                                 " for target " + path().string()};
+        throw std::runtime_error{"Target: could not map offset " + std::to_string(offset) +
+                                 " of " + m_id};
     }
+    m_freeBlocks.push_back(FreeBlock{offset, *address, size});
 }
 
 auto Target::freeBlockCount() const -> size_t
@@ -69,4 +56,4 @@ auto Target::toOffset(const Address address) const -> size_t
     return m_addressMap->toSourceAddresses(address).front().toInteger();
 }
 
-} // namespace fuse
\ No newline at end of file
+} // namespace kaizo::data
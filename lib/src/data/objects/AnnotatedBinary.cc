@@ -2,6 +2,7 @@
 #include <fstream>
 #include <kaizo/data/objects/AnnotatedBinary.h>
 #include <kaizo/utilities/DomReaderHelpers.h>
+#include <numeric>
 
 using namespace kaizo::data;
 
@@ -35,6 +36,18 @@ void AnnotatedBinary::skip(size_t skipSize)
     }
 }
 
+void AnnotatedBinary::align(size_t alignment)
+{
+    Expects(alignment > 0);
+    m_currentObject->setAlignment(std::lcm(m_currentObject->alignment(), alignment));
+    auto const realOffset =
+        m_nextRealOffset + m_binary.size() - m_currentObject->offset() - m_currentObject->size();
+    if (realOffset % alignment != 0)
+    {
+        skip(alignment - realOffset % alignment);
+    }
+}
+
 void AnnotatedBinary::endObject()
 {
     auto const sectionSize = m_binary.size() - m_currentObject->offset() - m_currentObject->size();
@@ -0,0 +1,442 @@
+#include <contracts/Contracts.h>
+#include <cstring>
+#include <fstream>
+#include <kaizo/addresses/AbsoluteOffset.h>
+#include <kaizo/addresses/MipsLayout.h>
+#include <kaizo/addresses/RelativeOffsetLayout.h>
+#include <kaizo/data/objects/AnnotatedBinary.h>
+#include <kaizo/data/objects/AnnotatedBinaryFile.h>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+namespace kaizo::data {
+
+struct AnnotatedBinaryFile::Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t objectCount;
+    uint64_t sectionCount;
+    uint64_t referenceCount;
+    uint64_t layoutCount;
+    uint64_t objectsOffset;
+    uint64_t sectionsOffset;
+    uint64_t referencesOffset;
+    uint64_t layoutsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+    uint64_t binaryOffset;
+    uint64_t binarySize;
+};
+
+namespace {
+
+constexpr char Magic[8] = {'K', 'A', 'I', 'Z', 'O', 'A', 'B', '\0'};
+constexpr uint32_t Version = 1;
+constexpr uint32_t ByteOrder = 0x01020304;
+
+auto error(const std::string& message) -> std::runtime_error
+{
+    return std::runtime_error{"AnnotatedBinaryFile: " + message};
+}
+
+auto alignUp(uint64_t offset) -> uint64_t
+{
+    return (offset + 7) & ~uint64_t{7};
+}
+
+auto toFileOffset(const Address& address) -> uint64_t
+{
+    if (!address.isValid() || !address.isCompatible(*fileOffsetFormat()))
+    {
+        throw error("only file offsets can be saved");
+    }
+    return address.toInteger();
+}
+
+auto fromFileOffset(uint64_t offset) -> Address
+{
+    if (auto maybeAddress = fileOffsetFormat()->fromInteger(offset))
+    {
+        return *maybeAddress;
+    }
+    throw error("invalid file offset");
+}
+
+auto encodeLayout(const AddressLayout& layout) -> AnnotatedBinaryFile::LayoutEntry
+{
+    AnnotatedBinaryFile::LayoutEntry entry{};
+    auto const name = layout.getName();
+    if (name == "relative")
+    {
+        auto const& relative = static_cast<const RelativeOffsetLayout&>(layout);
+        entry.kind = AnnotatedBinaryFile::LayoutEntry::Relative;
+        entry.hasBase = relative.baseAddress().isValid();
+        entry.base = entry.hasBase ? toFileOffset(relative.baseAddress()) : 0;
+        entry.sizeInBytes = static_cast<uint32_t>(relative.offsetLayout().sizeInBytes);
+        entry.isSigned = relative.offsetLayout().signedness == Signedness::Signed;
+        entry.isBigEndian = relative.offsetLayout().endianness == Endianness::Big;
+        if (relative.hasNullPointer())
+        {
+            entry.hasNullPointer = 1;
+            entry.nullOffset = relative.nullPointer().offset;
+            entry.nullAddress = toFileOffset(relative.nullPointer().address);
+        }
+    }
+    else if (name == "mips")
+    {
+        auto const& mips = static_cast<const MipsLayout&>(layout);
+        entry.kind = AnnotatedBinaryFile::LayoutEntry::Mips;
+        entry.hasBase = mips.baseAddress().isValid();
+        entry.base = entry.hasBase ? toFileOffset(mips.baseAddress()) : 0;
+        entry.offsetHi16 = mips.offsetHi16();
+        entry.offsetLo16 = mips.offsetLo16();
+    }
+    else
+    {
+        throw error("unsupported address layout '" + name + "'");
+    }
+    return entry;
+}
+
+class StringPool
+{
+public:
+    auto add(const std::string& string) -> std::pair<uint32_t, uint32_t>
+    {
+        if (m_strings.size() + string.size() > std::numeric_limits<uint32_t>::max())
+        {
+            throw error("paths exceed 4 GiB");
+        }
+        auto const offset = static_cast<uint32_t>(m_strings.size());
+        m_strings += string;
+        return {offset, static_cast<uint32_t>(string.size())};
+    }
+
+    auto strings() const -> const std::string&
+    {
+        return m_strings;
+    }
+
+private:
+    std::string m_strings;
+};
+
+template <class T> void writeTable(std::ofstream& output, const std::vector<T>& table)
+{
+    output.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+}
+
+void pad(std::ofstream& output, uint64_t offset)
+{
+    static constexpr char zeroes[8]{};
+    output.write(zeroes, alignUp(offset) - offset);
+}
+
+} // namespace
+
+void AnnotatedBinaryFile::save(const AnnotatedBinary& binary, const std::filesystem::path& filename)
+{
+    std::vector<ObjectEntry> objects;
+    std::vector<SectionEntry> sections;
+    std::vector<ReferenceEntry> references;
+    std::vector<LayoutEntry> layouts;
+    std::map<const AddressLayout*, uint32_t> layoutIndices;
+    std::map<std::string, uint32_t> encodedLayouts;
+    StringPool strings;
+
+    for (auto i = 0U; i < binary.objectCount(); ++i)
+    {
+        auto const& object = static_cast<const PackedObject&>(*binary.object(i));
+        ObjectEntry entry{};
+        entry.offset = object.offset();
+        entry.size = object.size();
+        entry.realSize = object.realSize();
+        entry.alignment = object.alignment();
+        entry.hasFixedOffset = object.hasFixedOffset();
+        entry.fixedOffset = object.hasFixedOffset() ? object.fixedOffset() : 0;
+        std::tie(entry.pathOffset, entry.pathLength) = strings.add(object.path().toString());
+
+        entry.firstSection = static_cast<uint32_t>(sections.size());
+        entry.sectionCount = static_cast<uint32_t>(object.sectionCount());
+        for (auto j = 0U; j < object.sectionCount(); ++j)
+        {
+            auto const& section = object.section(j);
+            sections.push_back(SectionEntry{section.offset, section.realOffset, section.size});
+        }
+
+        entry.firstReference = static_cast<uint32_t>(references.size());
+        entry.referenceCount = static_cast<uint32_t>(object.unresolvedReferenceCount());
+        for (auto j = 0U; j < object.unresolvedReferenceCount(); ++j)
+        {
+            auto const& reference = object.unresolvedReference(j);
+            ReferenceEntry referenceEntry{};
+            referenceEntry.offset = reference.relativeOffset();
+            std::tie(referenceEntry.pathOffset, referenceEntry.pathLength) =
+                strings.add(reference.referencedPath().toString());
+
+            // references usually share few layouts, but not necessarily the same instances
+            auto const* layout = &reference.addressLayout();
+            auto iter = layoutIndices.find(layout);
+            if (iter == layoutIndices.end())
+            {
+                auto const encoded = encodeLayout(*layout);
+                auto const [equal, isNew] = encodedLayouts.emplace(
+                    std::string{reinterpret_cast<const char*>(&encoded), sizeof(LayoutEntry)},
+                    static_cast<uint32_t>(layouts.size()));
+                if (isNew)
+                {
+                    layouts.push_back(encoded);
+                }
+                iter = layoutIndices.emplace(layout, equal->second).first;
+            }
+            referenceEntry.layout = iter->second;
+            references.push_back(referenceEntry);
+        }
+        objects.push_back(entry);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.byteOrder = ByteOrder;
+    header.objectCount = objects.size();
+    header.sectionCount = sections.size();
+    header.referenceCount = references.size();
+    header.layoutCount = layouts.size();
+    header.objectsOffset = sizeof(Header);
+    header.sectionsOffset = header.objectsOffset + objects.size() * sizeof(ObjectEntry);
+    header.referencesOffset = header.sectionsOffset + sections.size() * sizeof(SectionEntry);
+    header.layoutsOffset = header.referencesOffset + references.size() * sizeof(ReferenceEntry);
+    header.stringsOffset = header.layoutsOffset + layouts.size() * sizeof(LayoutEntry);
+    header.stringsSize = strings.strings().size();
+    header.binaryOffset = alignUp(header.stringsOffset + header.stringsSize);
+    header.binarySize = binary.binary().size();
+
+    std::ofstream output{filename, std::ofstream::binary};
+    if (!output.good())
+    {
+        throw error("could not open " + filename.string());
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    writeTable(output, objects);
+    writeTable(output, sections);
+    writeTable(output, references);
+    writeTable(output, layouts);
+    output.write(strings.strings().data(), strings.strings().size());
+    pad(output, header.stringsOffset + header.stringsSize);
+    output.write(reinterpret_cast<const char*>(binary.binary().data()), header.binarySize);
+    if (!output.good())
+    {
+        throw error("could not write " + filename.string());
+    }
+}
+
+AnnotatedBinaryFile::AnnotatedBinaryFile(const std::filesystem::path& filename)
+    : m_file{filename}
+{
+    if (m_file.size() < sizeof(Header))
+    {
+        throw error(filename.string() + " is not an annotated binary");
+    }
+    m_header = reinterpret_cast<const Header*>(m_file.data());
+    if (std::memcmp(m_header->magic, Magic, sizeof(Magic)) != 0)
+    {
+        throw error(filename.string() + " is not an annotated binary");
+    }
+    if (m_header->version != Version || m_header->byteOrder != ByteOrder)
+    {
+        throw error(filename.string() + " was saved by an incompatible version or machine");
+    }
+
+    m_objects = table<ObjectEntry>(m_header->objectsOffset, m_header->objectCount);
+    m_sections = table<SectionEntry>(m_header->sectionsOffset, m_header->sectionCount);
+    m_references = table<ReferenceEntry>(m_header->referencesOffset, m_header->referenceCount);
+    m_layouts = table<LayoutEntry>(m_header->layoutsOffset, m_header->layoutCount);
+    table<char>(m_header->stringsOffset, m_header->stringsSize);
+    table<uint8_t>(m_header->binaryOffset, m_header->binarySize);
+    validate();
+}
+
+template <class T>
+auto AnnotatedBinaryFile::table(uint64_t offset, size_t count) const -> std::span<const T>
+{
+    if (offset % alignof(T) != 0 || offset > m_file.size() ||
+        count > (m_file.size() - offset) / sizeof(T))
+    {
+        throw error("table exceeds file");
+    }
+    return {reinterpret_cast<const T*>(m_file.data() + offset), count};
+}
+
+void AnnotatedBinaryFile::validate() const
+{
+    // checks every index and range once so that the accessors can trust the tables
+    auto const checkString = [this](uint32_t offset, uint32_t length) {
+        if (uint64_t{offset} + length > m_header->stringsSize)
+        {
+            throw error("path exceeds string table");
+        }
+    };
+    for (auto const& object : m_objects)
+    {
+        checkString(object.pathOffset, object.pathLength);
+        if (object.offset > m_header->binarySize ||
+            object.size > m_header->binarySize - object.offset || object.alignment == 0 ||
+            uint64_t{object.firstSection} + object.sectionCount > m_sections.size() ||
+            uint64_t{object.firstReference} + object.referenceCount > m_references.size())
+        {
+            throw error("invalid object");
+        }
+    }
+    for (auto const& reference : m_references)
+    {
+        checkString(reference.pathOffset, reference.pathLength);
+        if (reference.layout >= m_layouts.size())
+        {
+            throw error("invalid reference");
+        }
+    }
+    for (auto const& layout : m_layouts)
+    {
+        if (layout.kind != LayoutEntry::Relative && layout.kind != LayoutEntry::Mips)
+        {
+            throw error("invalid address layout");
+        }
+    }
+}
+
+auto AnnotatedBinaryFile::objectCount() const -> size_t
+{
+    return m_objects.size();
+}
+
+auto AnnotatedBinaryFile::object(size_t index) const -> const ObjectEntry&
+{
+    Expects(index < objectCount());
+    return m_objects[index];
+}
+
+auto AnnotatedBinaryFile::string(uint32_t offset, uint32_t length) const -> std::string_view
+{
+    return {reinterpret_cast<const char*>(m_file.data() + m_header->stringsOffset) + offset,
+            length};
+}
+
+auto AnnotatedBinaryFile::path(const ObjectEntry& object) const -> std::string_view
+{
+    return string(object.pathOffset, object.pathLength);
+}
+
+auto AnnotatedBinaryFile::binary(const ObjectEntry& object) const -> BinaryView
+{
+    return BinaryView{m_file.data() + m_header->binaryOffset + object.offset, object.size};
+}
+
+auto AnnotatedBinaryFile::sections(const ObjectEntry& object) const
+    -> std::span<const SectionEntry>
+{
+    return m_sections.subspan(object.firstSection, object.sectionCount);
+}
+
+auto AnnotatedBinaryFile::references(const ObjectEntry& object) const
+    -> std::span<const ReferenceEntry>
+{
+    return m_references.subspan(object.firstReference, object.referenceCount);
+}
+
+auto AnnotatedBinaryFile::path(const ReferenceEntry& reference) const -> std::string_view
+{
+    return string(reference.pathOffset, reference.pathLength);
+}
+
+auto AnnotatedBinaryFile::layoutCount() const -> size_t
+{
+    return m_layouts.size();
+}
+
+auto AnnotatedBinaryFile::makeLayout(size_t index) const -> std::unique_ptr<AddressLayout>
+{
+    Expects(index < layoutCount());
+    auto const& entry = m_layouts[index];
+    switch (entry.kind)
+    {
+    case LayoutEntry::Relative:
+    {
+        auto layout = std::make_unique<RelativeOffsetLayout>();
+        if (entry.hasBase)
+        {
+            layout->setBaseAddress(fromFileOffset(entry.base));
+        }
+        layout->setOffsetFormat(
+            IntegerLayout{entry.sizeInBytes,
+                          entry.isSigned ? Signedness::Signed : Signedness::Unsigned,
+                          entry.isBigEndian ? Endianness::Big : Endianness::Little});
+        if (entry.hasNullPointer)
+        {
+            layout->setNullPointer(fromFileOffset(entry.nullAddress), entry.nullOffset);
+        }
+        return layout;
+    }
+    case LayoutEntry::Mips:
+    {
+        auto layout = std::make_unique<MipsLayout>();
+        if (entry.hasBase)
+        {
+            layout->setBaseAddress(fromFileOffset(entry.base));
+        }
+        layout->setOffsets(entry.offsetHi16, entry.offsetLo16);
+        return layout;
+    }
+    default: InvalidCase(entry.kind);
+    }
+}
+
+auto AnnotatedBinaryFile::load() const -> std::unique_ptr<AnnotatedBinary>
+{
+    auto const parsePath = [](std::string_view string) {
+        if (auto maybePath = DataPath::fromString(std::string{string}))
+        {
+            return *maybePath;
+        }
+        throw error("'" + std::string{string} + "' is not a valid path");
+    };
+
+    auto annotated = std::make_unique<AnnotatedBinary>();
+    annotated->m_binary =
+        Binary::fromArray(m_file.data() + m_header->binaryOffset, m_header->binarySize);
+
+    std::vector<std::shared_ptr<AddressLayout>> layouts;
+    for (auto i = 0U; i < layoutCount(); ++i)
+    {
+        layouts.push_back(makeLayout(i));
+    }
+
+    for (auto const& entry : m_objects)
+    {
+        auto const objectPath = parsePath(path(entry));
+        auto object = std::make_unique<PackedObject>(objectPath, annotated.get(), entry.offset);
+        for (auto const& section : sections(entry))
+        {
+            object->addSection(section.realOffset, section.size);
+        }
+        object->setAlignment(entry.alignment);
+        if (entry.hasFixedOffset)
+        {
+            object->setFixedOffset(entry.fixedOffset);
+        }
+        for (auto const& referenceEntry : references(entry))
+        {
+            UnresolvedReference reference{objectPath, referenceEntry.offset};
+            reference.setDestination(parsePath(path(referenceEntry)));
+            reference.setFormat(layouts[referenceEntry.layout]);
+            object->addUnresolvedReference(reference);
+        }
+        annotated->m_objects.push_back(std::move(object));
+    }
+    return annotated;
+}
+
+} // namespace kaizo::data
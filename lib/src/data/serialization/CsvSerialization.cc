@@ -1,4 +1,4 @@
-#include <fstream>
+#include <charconv>
 #include <kaizo/data/DataPath.h>
 #include <kaizo/data/data/ArrayData.h>
 #include <kaizo/data/data/IntegerData.h>
@@ -7,6 +7,7 @@
 #include <kaizo/data/data/StringData.h>
 #include <kaizo/data/serialization/CsvSerialization.h>
 #include <kaizo/utilities/CsvReader.h>
+#include <kaizo/utilities/CsvWriter.h>
 
 using namespace kaizo::data;
 
@@ -14,17 +15,11 @@ namespace kaizo::data {
 
 void CsvSerialization::serialize(const Data& data, const std::filesystem::path& sourcePath)
 {
-    m_currentPath.clear();
-    std::ofstream output{sourcePath};
-    if (output.good())
-    {
-        m_output = &output;
-        serializeData(data);
-    }
-    else
-    {
-        throw std::runtime_error{"CsvSerialization: could not open file for writing"};
-    }
+    m_outputPath.clear();
+    CsvWriter output{sourcePath};
+    m_output = &output;
+    serializeData(data);
+    output.flush();
 }
 
 void CsvSerialization::serializeData(const Data& data)
@@ -46,9 +41,14 @@ void CsvSerialization::serializeRecord(const Data& data)
     for (auto const& name : elements)
     {
         auto const& element = recordData.element(name);
-        m_currentPath /= DataPathElement::makeName(name);
+        auto const length = m_outputPath.size();
+        if (length > 0)
+        {
+            m_outputPath += '.';
+        }
+        m_outputPath += name;
         serializeData(element);
-        m_currentPath.goUp();
+        m_outputPath.resize(length);
     }
 }
 
@@ -58,9 +58,12 @@ void CsvSerialization::serializeArray(const Data& data)
     for (auto i = 0U; i < arrayData.elementCount(); ++i)
     {
         auto const& element = arrayData.element(i);
-        m_currentPath /= DataPathElement::makeIndex(i + 1);
+        auto const length = m_outputPath.size();
+        m_outputPath += '[';
+        m_outputPath += std::to_string(i + 1);
+        m_outputPath += ']';
         serializeData(element);
-        m_currentPath.goUp();
+        m_outputPath.resize(length);
     }
 }
 
@@ -83,17 +86,12 @@ void CsvSerialization::serializeString(const Data& data)
     outputRow(DataType::String, stringData.value());
 }
 
-void CsvSerialization::outputRow(DataType type, const std::string& value)
+void CsvSerialization::outputRow(DataType type, std::string_view value)
 {
-    (*m_output) << m_currentPath.toString() << "," << toString(type);
-    if (type == DataType::String)
-    {
-        (*m_output) << ",\"" << value << "\"\n";
-    }
-    else
-    {
-        (*m_output) << "," << value << "\n";
-    }
+    m_output->column(m_outputPath);
+    m_output->column(toString(type));
+    m_output->column(value, type == DataType::String);
+    m_output->endRow();
 }
 
 auto CsvSerialization::deserialize(const std::filesystem::path& filename)
@@ -110,7 +108,7 @@ auto CsvSerialization::deserialize(const std::filesystem::path& filename)
 
         decodePath((*maybeRow)[0]);
         decodeType((*maybeRow)[1]);
-        decodeValue(std::move((*maybeRow)[2]));
+        decodeValue((*maybeRow)[2]);
 
         if (!m_root)
         {
@@ -126,7 +124,7 @@ auto CsvSerialization::deserialize(const std::filesystem::path& filename)
 
 void CsvSerialization::processRoot()
 {
-    auto const& element = m_currentPath.element(0);
+    auto const& element = m_currentPath[0];
     switch (element.kind())
     {
     case DataPathElement::Kind::Index:
@@ -141,38 +139,41 @@ void CsvSerialization::processRoot()
     }
 }
 
-void CsvSerialization::decodePath(const std::string& path)
+void CsvSerialization::decodePath(std::string_view path)
 {
-    if (auto maybePath = DataPath::fromString(path))
+    // the paths are only walked once, so they are not interned as DataPaths
+    if (auto maybePath = DataPath::elementsFromString(path); maybePath && !maybePath->empty())
     {
-        m_currentPath = *maybePath;
+        m_currentPath = std::move(*maybePath);
     }
     else
     {
-        throw std::runtime_error{"CsvSerialization: '" + path + "' is not a valid path"};
+        throw std::runtime_error{"CsvSerialization: '" + std::string{path} +
+                                 "' is not a valid path"};
     }
 }
 
-void CsvSerialization::decodeType(const std::string& type)
+void CsvSerialization::decodeType(std::string_view type)
 {
-    if (auto maybeType = toDataType(type))
+    if (auto maybeType = toDataType(std::string{type}))
     {
         m_currentType = *maybeType;
     }
     else
     {
-        throw std::runtime_error{"CsvSerialization: '" + type + "' is not a valid data type"};
+        throw std::runtime_error{"CsvSerialization: '" + std::string{type} +
+                                 "' is not a valid data type"};
     }
 }
 
-void CsvSerialization::decodeValue(std::string&& value)
+void CsvSerialization::decodeValue(std::string_view value)
 {
-    m_currentValue = std::move(value);
+    m_currentValue = value;
 }
 
 void CsvSerialization::process(Data* data, size_t pathIndex)
 {
-    auto const& element = m_currentPath.element(pathIndex);
+    auto const& element = m_currentPath[pathIndex];
     switch (element.kind())
     {
     case DataPathElement::Kind::Index: processArray(data, pathIndex); return;
@@ -183,7 +184,11 @@ void CsvSerialization::process(Data* data, size_t pathIndex)
 
 void CsvSerialization::processExisting(Data* data, size_t pathIndex)
 {
-    auto const& element = m_currentPath.element(pathIndex);
+    if (pathIndex == m_currentPath.size())
+    {
+        throw std::runtime_error{"CsvSerialization: duplicate path"};
+    }
+    auto const& element = m_currentPath[pathIndex];
     switch (element.kind())
     {
     case DataPathElement::Kind::Index:
@@ -210,7 +215,7 @@ void CsvSerialization::processArray(Data* data, size_t pathIndex)
 {
     auto* arrayData = static_cast<ArrayData*>(data);
     // DataPaths use 1-based indices in arrays
-    auto const index = m_currentPath.element(pathIndex).index() - 1;
+    auto const index = m_currentPath[pathIndex].index() - 1;
 
     if (arrayData->hasElement(index))
     {
@@ -238,40 +243,52 @@ auto CsvSerialization::makeLeaf() -> std::unique_ptr<Data>
 
 auto CsvSerialization::makeReferenceLeaf() -> std::unique_ptr<Data>
 {
-    if (auto maybePath = DataPath::fromString(m_currentValue))
+    if (auto maybePath = DataPath::fromString(std::string{m_currentValue}))
     {
         return std::make_unique<ReferenceData>(*maybePath);
     }
     else
     {
-        throw std::runtime_error{"CsvSerialization: '" + m_currentValue +
+        throw std::runtime_error{"CsvSerialization: '" + std::string{m_currentValue} +
                                  "' is not a supported reference"};
     }
 }
 
 auto CsvSerialization::makeIntegerLeaf() -> std::unique_ptr<Data>
 {
-    if (m_currentValue[0] == '-')
+    auto const* begin = m_currentValue.data();
+    auto const* end = begin + m_currentValue.size();
+    if (!m_currentValue.empty() && m_currentValue[0] == '-')
     {
-        auto const value = std::stoll(m_currentValue);
-        return std::make_unique<IntegerData>(value);
+        int64_t value;
+        if (auto const result = std::from_chars(begin, end, value);
+            result.ec == std::errc{} && result.ptr == end)
+        {
+            return std::make_unique<IntegerData>(value);
+        }
     }
     else
     {
-        auto const value = std::stoull(m_currentValue);
-        return std::make_unique<IntegerData>(value);
+        uint64_t value;
+        if (auto const result = std::from_chars(begin, end, value);
+            result.ec == std::errc{} && result.ptr == end)
+        {
+            return std::make_unique<IntegerData>(value);
+        }
     }
+    throw std::runtime_error{"CsvSerialization: '" + std::string{m_currentValue} +
+                             "' is not a valid integer"};
 }
 
 auto CsvSerialization::makeStringLeaf() -> std::unique_ptr<Data>
 {
-    return std::make_unique<StringData>(m_currentValue);
+    return std::make_unique<StringData>(std::string{m_currentValue});
 }
 
 void CsvSerialization::processRecord(Data* data, size_t pathIndex)
 {
     auto* recordData = static_cast<RecordData*>(data);
-    auto const name = m_currentPath.element(pathIndex).name();
+    auto const name = m_currentPath[pathIndex].name();
 
     if (recordData->has(name))
     {
@@ -286,17 +303,17 @@ void CsvSerialization::processRecord(Data* data, size_t pathIndex)
 
 auto CsvSerialization::makeNext(size_t pathIndex) -> std::unique_ptr<Data>
 {
-    if (pathIndex + 1 == m_currentPath.length())
+    if (pathIndex + 1 == m_currentPath.size())
     {
         return makeLeaf();
     }
-    else if (m_currentPath.element(pathIndex + 1).isName())
+    else if (m_currentPath[pathIndex + 1].isName())
     {
         auto element = std::make_unique<RecordData>();
         process(element.get(), pathIndex + 1);
         return std::move(element);
     }
-    else if (m_currentPath.element(pathIndex + 1).isIndex())
+    else if (m_currentPath[pathIndex + 1].isIndex())
     {
         auto element = std::make_unique<ArrayData>();
         process(element.get(), pathIndex + 1);
@@ -70,6 +70,18 @@ auto Tile::dataSize() const -> size_t
     return m_data.size();
 }
 
+auto Tile::row(const size_t y) const -> const pixel_t*
+{
+    Expects(y < height());
+    return m_data.data() + y * width();
+}
+
+auto Tile::row(const size_t y) -> pixel_t*
+{
+    Expects(y < height());
+    return m_data.data() + y * width();
+}
+
 auto Tile::offset(const size_t x, const size_t y) const -> size_t
 {
     Expects(x < width());
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <contracts/Contracts.h>
+#include <fstream>
+#include <kaizo/graphics/font/BdfFontImporter.h>
+#include <kaizo/graphics/font/Font.h>
+#include <kaizo/utilities/Parallel.h>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+namespace kaizo {
+
+namespace {
+
+struct BdfGlyph
+{
+    std::string name;
+    long encoding{-1};
+    long advance{0};
+    long width{0};
+    long height{0};
+    long xOffset{0};
+    long yOffset{0};
+    std::vector<std::string> rows;
+};
+
+struct BdfFont
+{
+    unsigned bitsPerPixel{1};
+    std::optional<long> ascent;
+    std::optional<long> descent;
+    long boundingBoxHeight{0};
+    long boundingBoxYOffset{0};
+    std::vector<BdfGlyph> glyphs;
+};
+
+auto parseError(const std::string& message, size_t line) -> std::runtime_error
+{
+    return std::runtime_error{"BdfFontImporter: " + message + " in line " + std::to_string(line)};
+}
+
+auto parseBdf(const std::string& source) -> BdfFont
+{
+    BdfFont font;
+    std::istringstream input{source};
+    std::string line;
+    size_t lineNumber{0};
+    BdfGlyph* glyph{nullptr};
+    bool inBitmap{false};
+
+    while (std::getline(input, line))
+    {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        std::istringstream tokens{line};
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword.empty())
+        {
+            continue;
+        }
+
+        if (inBitmap)
+        {
+            if (keyword == "ENDCHAR")
+            {
+                inBitmap = false;
+                glyph = nullptr;
+            }
+            else
+            {
+                glyph->rows.push_back(keyword);
+            }
+            continue;
+        }
+
+        if (keyword == "SIZE")
+        {
+            long pointSize, xResolution, yResolution;
+            unsigned bitsPerPixel{1};
+            if (!(tokens >> pointSize >> xResolution >> yResolution))
+            {
+                throw parseError("malformed SIZE", lineNumber);
+            }
+            tokens >> bitsPerPixel;
+            if (bitsPerPixel != 1 && bitsPerPixel != 2 && bitsPerPixel != 4 && bitsPerPixel != 8)
+            {
+                throw parseError("unsupported bits per pixel", lineNumber);
+            }
+            font.bitsPerPixel = bitsPerPixel;
+        }
+        else if (keyword == "FONTBOUNDINGBOX")
+        {
+            long width, xOffset;
+            if (!(tokens >> width >> font.boundingBoxHeight >> xOffset >> font.boundingBoxYOffset))
+            {
+                throw parseError("malformed FONTBOUNDINGBOX", lineNumber);
+            }
+        }
+        else if (keyword == "FONT_ASCENT" || keyword == "FONT_DESCENT")
+        {
+            long value;
+            if (!(tokens >> value))
+            {
+                throw parseError("malformed " + keyword, lineNumber);
+            }
+            (keyword == "FONT_ASCENT" ? font.ascent : font.descent) = value;
+        }
+        else if (keyword == "STARTCHAR")
+        {
+            glyph = &font.glyphs.emplace_back();
+            std::getline(tokens >> std::ws, glyph->name);
+        }
+        else if (glyph && keyword == "ENCODING")
+        {
+            if (!(tokens >> glyph->encoding))
+            {
+                throw parseError("malformed ENCODING", lineNumber);
+            }
+        }
+        else if (glyph && keyword == "DWIDTH")
+        {
+            if (!(tokens >> glyph->advance))
+            {
+                throw parseError("malformed DWIDTH", lineNumber);
+            }
+        }
+        else if (glyph && keyword == "BBX")
+        {
+            if (!(tokens >> glyph->width >> glyph->height >> glyph->xOffset >> glyph->yOffset) ||
+                glyph->width < 0 || glyph->height < 0)
+            {
+                throw parseError("malformed BBX", lineNumber);
+            }
+        }
+        else if (glyph && keyword == "BITMAP")
+        {
+            inBitmap = true;
+        }
+    }
+
+    if (inBitmap)
+    {
+        throw parseError("unterminated BITMAP", lineNumber);
+    }
+    return font;
+}
+
+auto hexValue(char c) -> unsigned
+{
+    if (c >= '0' && c <= '9')
+    {
+        return static_cast<unsigned>(c - '0');
+    }
+    else if (c >= 'A' && c <= 'F')
+    {
+        return static_cast<unsigned>(c - 'A' + 10);
+    }
+    else if (c >= 'a' && c <= 'f')
+    {
+        return static_cast<unsigned>(c - 'a' + 10);
+    }
+    throw std::runtime_error{"BdfFontImporter: invalid hex digit in BITMAP"};
+}
+
+auto readBits(const std::string& hex, size_t offset, unsigned count) -> unsigned
+{
+    unsigned value{0};
+    for (auto bit = offset; bit < offset + count; ++bit)
+    {
+        value <<= 1;
+        if (bit / 4 < hex.size())
+        {
+            value |= (hexValue(hex[bit / 4]) >> (3 - bit % 4)) & 1;
+        }
+    }
+    return value;
+}
+
+auto toUtf8(long codePoint) -> std::string
+{
+    auto const unicode = static_cast<uint32_t>(codePoint);
+    std::string result;
+    if (unicode < 0x80)
+    {
+        result += static_cast<char>(unicode);
+    }
+    else if (unicode < 0x800)
+    {
+        result += static_cast<char>(0xC0 | (unicode >> 6));
+        result += static_cast<char>(0x80 | (unicode & 0x3F));
+    }
+    else if (unicode < 0x10000)
+    {
+        result += static_cast<char>(0xE0 | (unicode >> 12));
+        result += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
+        result += static_cast<char>(0x80 | (unicode & 0x3F));
+    }
+    else
+    {
+        result += static_cast<char>(0xF0 | (unicode >> 18));
+        result += static_cast<char>(0x80 | ((unicode >> 12) & 0x3F));
+        result += static_cast<char>(0x80 | ((unicode >> 6) & 0x3F));
+        result += static_cast<char>(0x80 | (unicode & 0x3F));
+    }
+    return result;
+}
+
+} // namespace
+
+void BdfFontImporter::setBitsPerPixel(unsigned bitsPerPixel)
+{
+    Expects(bitsPerPixel >= 1 && bitsPerPixel <= 16);
+    m_bitsPerPixel = bitsPerPixel;
+}
+
+void BdfFontImporter::setRamp(const std::vector<Tile::pixel_t>& ramp)
+{
+    Expects(ramp.empty() || ramp.size() >= 2);
+    m_ramp = ramp;
+}
+
+void BdfFontImporter::setThreadCount(size_t threads)
+{
+    m_threadCount = threads;
+}
+
+auto BdfFontImporter::background() const -> Tile::pixel_t
+{
+    return m_ramp.empty() ? 0 : m_ramp.front();
+}
+
+auto BdfFontImporter::quantize(unsigned intensity, unsigned sourceBitsPerPixel) const
+    -> Tile::pixel_t
+{
+    auto const sourceMax = (1U << sourceBitsPerPixel) - 1;
+    auto const levels = m_ramp.empty() ? (1U << m_bitsPerPixel) : m_ramp.size();
+    auto const level = (intensity * (levels - 1) + sourceMax / 2) / sourceMax;
+    return m_ramp.empty() ? static_cast<Tile::pixel_t>(level) : m_ramp[level];
+}
+
+auto BdfFontImporter::load(const std::filesystem::path& filename) const -> Font
+{
+    std::ifstream input{filename, std::ifstream::binary};
+    if (!input.good())
+    {
+        throw std::runtime_error{"BdfFontImporter: could not open " + filename.string()};
+    }
+    std::ostringstream source;
+    source << input.rdbuf();
+    return parse(source.str());
+}
+
+auto BdfFontImporter::parse(const std::string& source) const -> Font
+{
+    auto bdf = parseBdf(source);
+    std::erase_if(bdf.glyphs, [](auto const& glyph) { return glyph.encoding < 0; });
+
+    auto const ascent = bdf.ascent.value_or(bdf.boundingBoxHeight + bdf.boundingBoxYOffset);
+    auto const descent = bdf.descent.value_or(-bdf.boundingBoxYOffset);
+    if (ascent <= 0)
+    {
+        throw std::runtime_error{"BdfFontImporter: font has no ascent"};
+    }
+    auto const lineHeight = static_cast<size_t>(std::max(ascent + descent, ascent + 1));
+    auto const format = PixelFormat::makeIndexed(static_cast<uint8_t>(m_bitsPerPixel));
+
+    // Every glyph spans the whole line height so that all of them share the font's baseline.
+    std::vector<Glyph> glyphs(bdf.glyphs.size());
+    parallelFor(
+        bdf.glyphs.size(),
+        [&](size_t i) {
+            auto const& source = bdf.glyphs[i];
+            Tile tile{static_cast<size_t>(std::max(source.width, 1L)), lineHeight, format};
+            tile.fill(background());
+
+            auto const top = ascent - (source.yOffset + source.height);
+            auto const rows = std::min(static_cast<long>(source.rows.size()), source.height);
+            for (long row = 0; row < rows; ++row)
+            {
+                auto const y = top + row;
+                if (y < 0 || y >= static_cast<long>(lineHeight))
+                {
+                    continue;
+                }
+                auto const& hex = source.rows[row];
+                for (long x = 0; x < source.width; ++x)
+                {
+                    auto const intensity =
+                        readBits(hex, static_cast<size_t>(x) * bdf.bitsPerPixel, bdf.bitsPerPixel);
+                    if (intensity != 0)
+                    {
+                        tile.setPixel(static_cast<size_t>(x), static_cast<size_t>(y),
+                                      quantize(intensity, bdf.bitsPerPixel));
+                    }
+                }
+            }
+
+            glyphs[i] = GlyphBuilder{}
+                            .characters(toUtf8(source.encoding))
+                            .data(tile)
+                            .baseline(static_cast<size_t>(ascent))
+                            .background(background())
+                            .xOffset(source.xOffset)
+                            .advanceWidth(static_cast<size_t>(std::max(source.advance, 0L)))
+                            .build();
+        },
+        m_threadCount);
+
+    Font font;
+    font.setMetrics(Font::Metrics{lineHeight, static_cast<size_t>(ascent)});
+    font.setPixelFormat(format);
+    font.setBackgroundColor(background());
+    for (auto const& glyph : glyphs)
+    {
+        font.addGlyph(glyph);
+    }
+    return font;
+}
+
+} // namespace kaizo
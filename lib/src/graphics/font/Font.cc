@@ -1,10 +1,15 @@
-#include <constracts/Contracts.h>
+#include <algorithm>
+#include <contracts/Contracts.h>
 #include <kaizo/graphics/font/Font.h>
+#include <stdexcept>
 
-namespace fuse::graphics {
+namespace kaizo {
 
 void Font::addGlyph(const Glyph& glyph)
 {
+    // keep the first glyph for duplicate characters, like the linear search did
+    m_characterIndex.insert(std::make_pair(glyph.characters(), m_characters.size()));
+    m_longestCharacters = std::max(m_longestCharacters, glyph.characters().size());
     m_characters.push_back(glyph);
 }
 
@@ -21,12 +26,10 @@ auto Font::glyph(size_t index) const -> const Glyph&
 
 auto Font::find(const std::string& characters) const -> std::optional<size_t>
 {
-    for (auto i = 0U; i < glyphCount(); ++i)
+    auto const iter = m_characterIndex.find(characters);
+    if (iter != m_characterIndex.cend())
     {
-        if (glyph(i).characters() == characters)
-        {
-            return i;
-        }
+        return iter->second;
     }
     return {};
 }
@@ -46,26 +49,16 @@ auto Font::findStartingWith(const std::string& characters) const -> std::vector<
 
 auto Font::findLongestMatch(const std::string& string, size_t index) const -> std::optional<size_t>
 {
-    std::optional<size_t> longestMatch;
-    size_t matchSize{0};
-    for (auto glyphIndex = 0U; glyphIndex < glyphCount(); ++glyphIndex)
+    Expects(index <= string.size());
+    auto length = std::min(m_longestCharacters, string.size() - index);
+    for (; length > 0; --length)
     {
-        auto const characters = glyph(glyphIndex).characters();
-        auto i = 0U;
-        for (; i < characters.size(); ++i)
+        if (auto maybeGlyph = find(string.substr(index, length)))
         {
-            if (characters[i] != string[index + i])
-            {
-                break;
-            }
-        }
-        if (i == characters.size() && i > matchSize)
-        {
-            longestMatch = glyphIndex;
-            matchSize = i;
+            return maybeGlyph;
         }
     }
-    return longestMatch;
+    return {};
 }
 
 auto Font::toGlyphs(const std::string& string) const -> std::vector<std::optional<size_t>>
@@ -88,6 +81,26 @@ auto Font::toGlyphs(const std::string& string) const -> std::vector<std::optiona
     return glyphs;
 }
 
+auto Font::subset(const std::vector<std::string>& characters) const -> Font
+{
+    Font font;
+    font.m_metrics = m_metrics;
+    font.m_pixelFormat = m_pixelFormat;
+    font.m_backgroundColor = m_backgroundColor;
+    for (auto const& glyphCharacters : characters)
+    {
+        if (auto const maybeGlyph = find(glyphCharacters))
+        {
+            font.addGlyph(glyph(*maybeGlyph));
+        }
+        else
+        {
+            throw std::runtime_error{"Font: no glyph for '" + glyphCharacters + "'"};
+        }
+    }
+    return font;
+}
+
 void Font::setMetrics(const Metrics& metrics)
 {
     Expects(metrics.baseLine < metrics.lineHeight);
@@ -104,6 +117,16 @@ auto Font::baseLine() const -> size_t
     return m_metrics.baseLine;
 }
 
+auto Font::pixelFormat() const -> PixelFormat
+{
+    return m_pixelFormat;
+}
+
+void Font::setPixelFormat(const PixelFormat format)
+{
+    m_pixelFormat = format;
+}
+
 auto Font::backgroundColor() const -> Glyph::pixel_t
 {
     return m_backgroundColor;
@@ -114,4 +137,4 @@ void Font::setBackgroundColor(Glyph::pixel_t color)
     m_backgroundColor = color;
 }
 
-} // namespace fuse::graphics
\ No newline at end of file
+} // namespace kaizo
\ No newline at end of file
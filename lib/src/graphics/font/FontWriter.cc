@@ -1,11 +1,12 @@
 #include <algorithm>
-#include <diagnostics/Contracts.h>
-#include <fuse/graphics/font/Font.h>
-#include <fuse/graphics/font/FontWriter.h>
-#include <fuse/graphics/font/Glyph.h>
-#include <fuse/graphics/image/Image.h>
+#include <contracts/Contracts.h>
+#include <kaizo/graphics/font/Font.h>
+#include <kaizo/graphics/font/FontWriter.h>
+#include <kaizo/graphics/font/Glyph.h>
+#include <kaizo/utilities/Parallel.h>
+#include <stdexcept>
 
-namespace fuse::graphics {
+namespace kaizo {
 
 void FontWriter::setFont(const Font* font)
 {
@@ -18,18 +19,129 @@ void FontWriter::setAlignment(Alignment alignment)
     m_alignment = alignment;
 }
 
-void FontWriter::write(const std::string& text, Image& image, size_t x, size_t y, Anchor anchor) const
+void FontWriter::setThreadCount(size_t threads)
+{
+    m_threadCount = threads;
+}
+
+void FontWriter::setCharacterSpacing(CharacterSpacing spacing)
+{
+    m_characterSpacing = spacing;
+}
+
+void FontWriter::setMonospace(size_t characterWidth)
+{
+    Expects(characterWidth > 0);
+    m_characterSpacing = CharacterSpacing::Monospace;
+    m_monospaceWidth = characterWidth;
+}
+
+void FontWriter::setProportional()
+{
+    m_characterSpacing = CharacterSpacing::Proportional;
+}
+
+auto FontWriter::toGlyphs(const std::string& text) const -> std::vector<size_t>
+{
+    Expects(m_font);
+    std::vector<size_t> glyphs;
+    glyphs.reserve(text.size());
+    size_t index{0};
+    while (index < text.size())
+    {
+        if (auto maybeGlyph = m_font->findLongestMatch(text, index))
+        {
+            glyphs.push_back(*maybeGlyph);
+            index += m_font->glyph(*maybeGlyph).characters().size();
+        }
+        else
+        {
+            throw std::runtime_error{"FontWriter: no glyph matches '" + text.substr(index) +
+                                     "'"};
+        }
+    }
+    return glyphs;
+}
+
+auto FontWriter::advance(size_t glyph) const -> size_t
+{
+    if (m_characterSpacing == CharacterSpacing::Monospace)
+    {
+        return m_monospaceWidth;
+    }
+    return m_font->glyph(glyph).advanceWidth();
+}
+
+auto FontWriter::width(const std::vector<size_t>& glyphs) const -> size_t
+{
+    size_t width{0};
+    for (auto const glyph : glyphs)
+    {
+        width += advance(glyph);
+    }
+    return width;
+}
+
+void FontWriter::draw(const std::vector<size_t>& glyphs, Tile& tile, long long x,
+                      long long baseline) const
+{
+    auto const tileWidth = static_cast<long long>(tile.width());
+    auto const tileHeight = static_cast<long long>(tile.height());
+    auto const mask = static_cast<Tile::pixel_t>(-1) >> (32 - tile.bitsPerPixel());
+
+    for (auto const glyphIndex : glyphs)
+    {
+        auto const& glyph = m_font->glyph(glyphIndex);
+        auto const& source = glyph.tile();
+        auto const needsMask = source.bitsPerPixel() > tile.bitsPerPixel();
+        auto const left = x + glyph.xOffset();
+        auto const top = baseline - static_cast<long long>(glyph.ascent());
+
+        // Spans only cover non-background pixels, so copying them keys out the background.
+        for (auto const& span : glyph.spans())
+        {
+            auto const y = top + span.y;
+            if (y < 0 || y >= tileHeight)
+            {
+                continue;
+            }
+            auto const spanLeft = left + span.x;
+            auto const begin = std::max(spanLeft, 0LL);
+            auto const end = std::min(spanLeft + static_cast<long long>(span.length), tileWidth);
+            if (end <= begin)
+            {
+                continue;
+            }
+
+            auto const* from = source.row(span.y) + span.x + (begin - spanLeft);
+            auto* to = tile.row(static_cast<size_t>(y)) + begin;
+            if (needsMask)
+            {
+                std::transform(from, from + (end - begin), to,
+                               [mask](auto const pixel) { return pixel & mask; });
+            }
+            else
+            {
+                std::copy(from, from + (end - begin), to);
+            }
+        }
+        x += static_cast<long long>(advance(glyphIndex));
+    }
+}
+
+void FontWriter::write(const std::string& text, Tile& tile, long long x, long long y,
+                       Anchor anchor) const
 {
     Expects(m_font);
-    auto const glyphs = m_font->toGlyphs(text);
+    auto const glyphs = toGlyphs(text);
 
     // vertical anchoring
     switch (anchor)
     {
     case Anchor::BottomLeft:
-    case Anchor::BottomRight: y -= m_font->lineHeight();
+    case Anchor::BottomRight: y -= static_cast<long long>(m_font->lineHeight()); [[fallthrough]];
     case Anchor::TopLeft:
-    case Anchor::TopRight: y += m_font->baseLine(); break;
+    case Anchor::TopRight: y += static_cast<long long>(m_font->baseLine()); break;
     default: break;
     }
 
@@ -38,57 +150,91 @@ void FontWriter::write(const std::string& text, Image& image, size_t x, size_t y
     {
     case Anchor::BaselineRight:
     case Anchor::TopRight:
-    case Anchor::BottomRight: break;
+    case Anchor::BottomRight: x -= static_cast<long long>(width(glyphs)); break;
     default: break;
     }
 
-    for (auto const& glyphIndex : glyphs)
+    draw(glyphs, tile, x, y);
+}
+
+auto FontWriter::makeCanvas(size_t width, size_t height) const -> Tile
+{
+    Tile canvas{std::max<size_t>(width, 1), std::max<size_t>(height, 1), m_font->pixelFormat()};
+    canvas.fill(m_font->backgroundColor());
+    return canvas;
+}
+
+auto FontWriter::render(const std::string& text) const -> Tile
+{
+    Expects(m_font);
+    auto const glyphs = toGlyphs(text);
+    auto canvas = makeCanvas(width(glyphs), m_font->lineHeight());
+    draw(glyphs, canvas, 0, static_cast<long long>(m_font->baseLine()));
+    return canvas;
+}
+
+auto FontWriter::render(const std::string& text, size_t width, size_t height) const -> Tile
+{
+    Expects(m_font);
+    auto const glyphs = toGlyphs(text);
+    auto canvas = makeCanvas(width, height);
+
+    auto const textWidth = static_cast<long long>(this->width(glyphs));
+    long long x{0};
+    switch (m_alignment)
     {
-        if (glyphIndex)
-        {
-            auto const& glyph = m_font->glyph(*glyphIndex);
-            for (auto gy = 0U; gy < glyph.height(); ++gy)
-            {
-                for (auto gx = 0U; gx < glyph.width(); ++gx)
-                {
-                    auto const pixel = glyph.pixel(gx, gy);
-                    if (pixel != m_font->backgroundColor())
-                    {
-                        image.setPixel(x + gx, y - glyph.ascent() + gy, glyph(gx, gy));
-                    }
-                }
-            }
-            x += glyph.advanceWidth();
-        }
+    case Alignment::Center: x = (static_cast<long long>(width) - textWidth) / 2; break;
+    case Alignment::Right: x = static_cast<long long>(width) - textWidth; break;
+    default: break;
     }
+
+    draw(glyphs, canvas, x, static_cast<long long>(m_font->baseLine()));
+    return canvas;
 }
 
-auto FontWriter::boundingBox(const std::string& text) -> BitmapRegion
+auto FontWriter::renderAll(const std::vector<std::string>& texts) const -> std::vector<Tile>
+{
+    Expects(m_font);
+    std::vector<Tile> tiles(texts.size());
+    parallelFor(
+        texts.size(), [&](size_t i) { tiles[i] = render(texts[i]); }, m_threadCount);
+    return tiles;
+}
+
+auto FontWriter::renderAll(const std::vector<std::string>& texts, size_t width,
+                           size_t height) const -> std::vector<Tile>
+{
+    Expects(m_font);
+    std::vector<Tile> tiles(texts.size());
+    parallelFor(
+        texts.size(), [&](size_t i) { tiles[i] = render(texts[i], width, height); },
+        m_threadCount);
+    return tiles;
+}
+
+auto FontWriter::boundingBox(const std::string& text) const -> BitmapRegion
 {
     Expects(m_font);
     BitmapRegion boundingBox;
-    auto const glyphs = m_font->toGlyphs(text);
-    for (auto const& glyph : glyphs)
+    auto const glyphs = toGlyphs(text);
+    for (auto const glyph : glyphs)
     {
-        if (glyph)
-        {
-            boundingBox.setRight(boundingBox.right() + m_font->glyph(*glyph).advanceWidth());
-            boundingBox.setBottom(std::max(boundingBox.bottom(), m_font->glyph(*glyph).height()));
-        }
+        boundingBox.setRight(boundingBox.right() + advance(glyph));
+        boundingBox.setBottom(std::max(boundingBox.bottom(), m_font->glyph(glyph).height()));
     }
     return boundingBox;
 }
 
-auto FontWriter::width(const std::string& text) -> size_t
+auto FontWriter::width(const std::string& text) const -> size_t
 {
     Expects(m_font);
-    return boundingBox(text).width();
+    return width(toGlyphs(text));
 }
 
-auto FontWriter::height(const std::string& text) -> size_t
+auto FontWriter::height(const std::string& text) const -> size_t
 {
     Expects(m_font);
     return boundingBox(text).height();
 }
 
-} // namespace fuse::graphics
\ No newline at end of file
+} // namespace kaizo
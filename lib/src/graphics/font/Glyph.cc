@@ -1,4 +1,5 @@
 #include <kaizo/graphics/font/Glyph.h>
+#include <stdexcept>
 
 namespace kaizo {
 
@@ -29,7 +30,12 @@ auto Glyph::descent() const -> size_t
 
 auto Glyph::advanceWidth() const -> size_t
 {
-    return width() + 1;
+    return m_advanceWidth;
+}
+
+auto Glyph::xOffset() const -> long long
+{
+    return m_xOffset;
 }
 
 auto Glyph::characters() const -> const std::string&
@@ -57,6 +63,16 @@ auto Glyph::operator()(size_t x, size_t y) const -> pixel_t
     return pixel(x, y);
 }
 
+auto Glyph::tile() const -> const Tile&
+{
+    return m_tile;
+}
+
+auto Glyph::spans() const -> const std::vector<Span>&
+{
+    return m_spans;
+}
+
 auto GlyphBuilder::baseline(size_t y) -> GlyphBuilder&
 {
     m_baseline = y;
@@ -87,22 +103,70 @@ auto GlyphBuilder::shrinkToFit(bool shrink) -> GlyphBuilder&
     return *this;
 }
 
+auto GlyphBuilder::advanceWidth(size_t width) -> GlyphBuilder&
+{
+    m_advanceWidth = width;
+    return *this;
+}
+
+auto GlyphBuilder::xOffset(long long offset) -> GlyphBuilder&
+{
+    m_xOffset = offset;
+    return *this;
+}
+
 auto GlyphBuilder::build() -> Glyph
 {
     validate();
 
     Glyph glyph;
+    glyph.m_xOffset = m_xOffset;
     if (m_shrinkToFit)
     {
         shrink();
+        if (m_advanceWidth)
+        {
+            // keep the shrunk pixels where they were relative to the pen position
+            glyph.m_xOffset += static_cast<long long>(m_shrunkLeft);
+        }
     }
     glyph.m_tile = m_data;
     glyph.m_characters = m_characters;
     glyph.m_baseline = m_baseline;
     glyph.m_background = m_backgroundColor;
+    glyph.m_advanceWidth = m_advanceWidth.value_or(m_data.width() + 1);
+    glyph.m_spans = computeSpans();
     return glyph;
 }
 
+auto GlyphBuilder::computeSpans() const -> std::vector<Glyph::Span>
+{
+    std::vector<Glyph::Span> spans;
+    for (size_t y = 0; y < m_data.height(); ++y)
+    {
+        auto const* row = m_data.row(y);
+        size_t x{0};
+        while (x < m_data.width())
+        {
+            while (x < m_data.width() && row[x] == m_backgroundColor)
+            {
+                ++x;
+            }
+            auto const start = x;
+            while (x < m_data.width() && row[x] != m_backgroundColor)
+            {
+                ++x;
+            }
+            if (x > start)
+            {
+                spans.push_back(Glyph::Span{static_cast<uint32_t>(start), static_cast<uint32_t>(y),
+                                            static_cast<uint32_t>(x - start)});
+            }
+        }
+    }
+    return spans;
+}
+
 void GlyphBuilder::validate()
 {
     if (m_baseline >= m_data.height())
@@ -125,7 +189,8 @@ void GlyphBuilder::shrink()
             throw std::runtime_error{"GlyphBuilder: baseline is not within bounding box"};
         }
         m_baseline -= boundingBox.top();
-        m_data = m_data.clip(boundingBox);
+        m_shrunkLeft = boundingBox.left();
+        m_data = m_data.crop(boundingBox);
     }
     else
     {
@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <contracts/Contracts.h>
+#include <kaizo/binary/BinaryView.h>
+#include <kaizo/graphics/TileFormat.h>
+#include <kaizo/graphics/font/Font.h>
+#include <kaizo/graphics/font/GlyphPacker.h>
+#include <kaizo/utilities/Parallel.h>
+
+namespace kaizo {
+
+auto packGlyphs(const Font& font, TileFormat& format, size_t cellWidth, size_t cellHeight)
+    -> Binary
+{
+    Expects(cellWidth > 0 && cellHeight > 0);
+
+    std::vector<Tile> cells(font.glyphCount());
+    parallelFor(font.glyphCount(), [&](size_t i) {
+        auto const& glyph = font.glyph(i);
+        Tile cell{cellWidth, cellHeight, font.pixelFormat()};
+        cell.fill(font.backgroundColor());
+
+        auto const x = std::max(glyph.xOffset(), 0LL);
+        auto const y = static_cast<long long>(font.baseLine()) -
+                       static_cast<long long>(glyph.ascent());
+        auto const skipped = static_cast<size_t>(
+            std::clamp(-y, 0LL, static_cast<long long>(glyph.height())));
+        TileRegion region{0, skipped, glyph.width(), glyph.height() - skipped};
+        if (region.hasArea())
+        {
+            cell.blit(static_cast<size_t>(x), static_cast<size_t>(std::max(y, 0LL)), glyph.tile(),
+                      region, glyph.backgroundColor());
+        }
+        cells[i] = std::move(cell);
+    });
+
+    // Tiles of a format need not end on byte boundaries, so they are encoded sequentially.
+    Binary binary{format.requiredSize(cells.size())};
+    MutableBinaryView view{binary};
+    TileFormat::offset_t offset{0};
+    for (auto const& cell : cells)
+    {
+        offset = format.write(view, offset, cell);
+    }
+    return binary;
+}
+
+} // namespace kaizo
@@ -67,4 +67,25 @@ auto Table::entry(size_t index) const -> EntryReference
     return EntryReference{&iter->first, &iter->second};
 }
 
+auto Table::find(const BinarySequence& binary) const -> std::optional<EntryReference>
+{
+    auto const iter = m_mapping.find(binary);
+    if (iter != m_mapping.cend())
+    {
+        return EntryReference{&iter->first, &iter->second};
+    }
+    return {};
+}
+
+auto Table::entries() const -> std::vector<EntryReference>
+{
+    std::vector<EntryReference> entries;
+    entries.reserve(m_mapping.size());
+    for (auto const& [binary, text] : m_mapping)
+    {
+        entries.push_back(EntryReference{&binary, &text});
+    }
+    return entries;
+}
+
 } // namespace kaizo
@@ -74,49 +74,51 @@ void TableDecoder::addHook(const std::string& name, HookHandler* hook)
     m_hooks[name] = hook;
 }
 
-auto TableDecoder::decode(const BinaryView& binary, size_t offset) -> std::pair<size_t, std::string>
+auto TableDecoder::decode(const BinaryView& binary, size_t offset) const
+    -> std::pair<size_t, std::string>
 {
-    m_binary = &binary;
-    m_offset = offset;
+    Cursor cursor{binary, offset, m_activeTable};
 
     std::string text;
     bool finished{false};
     while (!finished)
     {
-        if (auto maybeMatch = activeTable().findLongestBinaryMatch(data(), binary.end()))
+        auto const& table = m_tables[cursor.activeTable];
+        if (auto maybeMatch = table.findLongestBinaryMatch(cursor.data(), binary.end()))
         {
             switch (maybeMatch->text().kind())
             {
             case TableEntry::Kind::Text:
-                advance(maybeMatch->binary().size());
+                cursor.advance(maybeMatch->binary().size());
                 text += decodeText(maybeMatch->text());
                 break;
             case TableEntry::Kind::End:
-                advance(maybeMatch->binary().size());
+                cursor.advance(maybeMatch->binary().size());
                 text += decodeEnd(maybeMatch->text());
                 finished = true;
                 break;
             case TableEntry::Kind::TableSwitch:
-                advance(maybeMatch->binary().size());
-                text += decodeTableSwitch(maybeMatch->text());
+                cursor.advance(maybeMatch->binary().size());
+                text += decodeTableSwitch(cursor, maybeMatch->text());
                 break;
             case TableEntry::Kind::Control:
-                advance(maybeMatch->binary().size());
-                text += decodeControl(maybeMatch->text());
+                cursor.advance(maybeMatch->binary().size());
+                text += decodeControl(cursor, maybeMatch->text());
                 break;
-            case TableEntry::Kind::Hook: text += decodeHook(maybeMatch->text()); break;
+            case TableEntry::Kind::Hook: text += decodeHook(cursor, maybeMatch->text()); break;
             default: throw std::runtime_error{"invalid case"};
             }
         }
         else
         {
-            throw std::runtime_error{"offset " + toString(m_offset, 16, 8) + ": no match for 0x" +
-                                     toString(binary[m_offset], 16, 2) + " in table"};
+            throw std::runtime_error{"offset " + toString(cursor.offset, 16, 8) +
+                                     ": no match for 0x" +
+                                     toString(binary[cursor.offset], 16, 2) + " in table"};
         }
 
         if (m_fixedLength)
         {
-            auto const length = m_offset - offset;
+            auto const length = cursor.offset - offset;
             if (length == *m_fixedLength)
             {
                 finished = true;
@@ -129,16 +131,16 @@ auto TableDecoder::decode(const BinaryView& binary, size_t offset) -> std::pair<
     }
     if (m_fixedLength)
     {
-        auto const length = m_offset - offset;
+        auto const length = cursor.offset - offset;
         if (length < *m_fixedLength)
         {
-            m_offset = offset + length;
+            cursor.offset = offset + length;
         }
     }
-    return std::make_pair(m_offset, text);
+    return std::make_pair(cursor.offset, text);
 }
 
-auto TableDecoder::decodeControl(const TableEntry& control) -> std::string
+auto TableDecoder::decodeControl(Cursor& cursor, const TableEntry& control) const -> std::string
 {
     std::string text = "{" + control.labelName();
     if (control.parameterCount() > 0)
@@ -150,7 +152,7 @@ auto TableDecoder::decodeControl(const TableEntry& control) -> std::string
             {
                 text += ",";
             }
-            text += decodeArgument(control.parameter(i));
+            text += decodeArgument(cursor, control.parameter(i));
         }
     }
     text += "}";
@@ -158,10 +160,11 @@ auto TableDecoder::decodeControl(const TableEntry& control) -> std::string
     return text;
 }
 
-auto TableDecoder::decodeArgument(const TableEntry::ParameterFormat& format) -> std::string
+auto TableDecoder::decodeArgument(Cursor& cursor, const TableEntry::ParameterFormat& format) const
+    -> std::string
 {
-    auto const argument = static_cast<uint64_t>(format.decode(data()));
-    advance(format.size);
+    auto const argument = static_cast<uint64_t>(format.decode(cursor.data()));
+    cursor.advance(format.size);
 
     switch (format.preferedDisplay)
     {
@@ -172,36 +175,40 @@ auto TableDecoder::decodeArgument(const TableEntry::ParameterFormat& format) ->
     }
 }
 
-auto TableDecoder::decodeText(const TableEntry& text) -> std::string
+auto TableDecoder::decodeText(const TableEntry& text) const -> std::string
 {
     return text.text();
 }
 
-auto TableDecoder::decodeEnd(const TableEntry& end) -> std::string
+auto TableDecoder::decodeEnd(const TableEntry& end) const -> std::string
 {
     std::string text = "{" + end.labelName() + "}";
     return text;
 }
 
-auto TableDecoder::decodeTableSwitch(const TableEntry& tableSwitch) -> std::string
+auto TableDecoder::decodeTableSwitch(Cursor& cursor, const TableEntry& tableSwitch) const
+    -> std::string
 {
-    if (!hasTable(tableSwitch.targetTable()))
+    auto const table = std::find_if(m_tables.cbegin(), m_tables.cend(), [&](auto const& table) {
+        return table.name() == tableSwitch.targetTable();
+    });
+    if (table == m_tables.cend())
     {
         throw std::runtime_error{"no such table: " + tableSwitch.targetTable()};
     }
-    setActiveTable(tableSwitch.targetTable());
+    cursor.activeTable = static_cast<size_t>(table - m_tables.cbegin());
     return {};
 }
 
-auto TableDecoder::decodeHook(const TableEntry& hook) -> std::string
+auto TableDecoder::decodeHook(Cursor& cursor, const TableEntry& hook) const -> std::string
 {
     auto const iter = m_hooks.find(hook.hook());
     if (iter != m_hooks.cend())
     {
-        if (auto const maybeResult = iter->second->decode(*m_binary, m_offset))
+        if (auto const maybeResult = iter->second->decode(cursor.binary, cursor.offset))
         {
             auto const [offset, args] = *maybeResult;
-            m_offset = offset;
+            cursor.offset = offset;
             std::string text = "{" + hook.hook();
             text += ":";
             text += args;
@@ -210,25 +217,25 @@ auto TableDecoder::decodeHook(const TableEntry& hook) -> std::string
         }
         else
         {
-            throw std::runtime_error{"offset " + toString(m_offset, 16, 8) + ": hook '" +
+            throw std::runtime_error{"offset " + toString(cursor.offset, 16, 8) + ": hook '" +
                                      hook.hook() + "' failed"};
         }
     }
     else
     {
-        throw std::runtime_error{"offset " + toString(m_offset, 16, 8) + ": no handler for hook '" +
-                                 hook.hook() + "' installed"};
+        throw std::runtime_error{"offset " + toString(cursor.offset, 16, 8) +
+                                 ": no handler for hook '" + hook.hook() + "' installed"};
     }
 }
 
-auto TableDecoder::data() const -> const uint8_t*
+auto TableDecoder::Cursor::data() const -> const uint8_t*
 {
-    return m_binary->data() + m_offset;
+    return binary.data() + offset;
 }
 
-void TableDecoder::advance(size_t size)
+void TableDecoder::Cursor::advance(size_t size)
 {
-    m_offset += size;
+    offset += size;
 }
 
 } // namespace kaizo
\ No newline at end of file
@@ -56,6 +56,7 @@ auto TableEncoding::copy() const -> std::unique_ptr<TextEncoding>
     auto encoding = std::make_unique<TableEncoding>();
     encoding->m_decoder = m_decoder;
     encoding->m_encoder = m_encoder;
+    encoding->m_hooks = m_hooks;
     return std::move(encoding);
 }
 
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <contracts/Contracts.h>
+#include <kaizo/text/TableMapper.h>
+#include <kaizo/text/TableUsage.h>
+#include <kaizo/utilities/Parallel.h>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace kaizo {
+
+TableUsage::TableUsage(const Table& table)
+    : m_table{table}
+{
+}
+
+void TableUsage::setThreadCount(size_t threads)
+{
+    m_threadCount = threads;
+}
+
+void TableUsage::analyze(const std::vector<std::string>& corpus)
+{
+    // Mappers are stateful, so every thread maps a contiguous block of the corpus with its own.
+    auto const blockCount =
+        std::min(corpus.size(), m_threadCount == 0 ? defaultThreadCount() : m_threadCount);
+    std::vector<std::unordered_map<BinarySequence, size_t>> blockCounts(blockCount);
+    parallelFor(
+        blockCount,
+        [&](size_t block) {
+            auto& counts = blockCounts[block];
+            TableMapper mapper{m_table};
+            mapper.setMapper([&counts](const std::string&, const TableMapper::Mapping& mapping) {
+                ++counts[mapping.entry.binary()];
+                return true;
+            });
+
+            auto const begin = corpus.size() * block / blockCount;
+            auto const end = corpus.size() * (block + 1) / blockCount;
+            for (auto i = begin; i < end; ++i)
+            {
+                mapper.map(corpus[i]);
+            }
+        },
+        blockCount);
+
+    for (auto const& counts : blockCounts)
+    {
+        for (auto const& [binary, count] : counts)
+        {
+            m_counts[binary] += count;
+        }
+    }
+}
+
+auto TableUsage::count(const Table::EntryReference& entry) const -> size_t
+{
+    auto const iter = m_counts.find(entry.binary());
+    return iter != m_counts.cend() ? iter->second : 0;
+}
+
+auto TableUsage::histogram() const -> std::vector<std::pair<Table::EntryReference, size_t>>
+{
+    std::vector<std::pair<Table::EntryReference, size_t>> histogram;
+    histogram.reserve(m_counts.size());
+    for (auto const& [binary, count] : m_counts)
+    {
+        auto const entry = m_table.find(binary);
+        Expects(entry);
+        histogram.push_back(std::make_pair(*entry, count));
+    }
+    std::stable_sort(histogram.begin(), histogram.end(),
+                     [](auto const& lhs, auto const& rhs) { return lhs.second > rhs.second; });
+    return histogram;
+}
+
+auto TableUsage::usedTextEntries() const -> std::vector<Table::EntryReference>
+{
+    std::vector<Table::EntryReference> entries;
+    for (auto const& [entry, count] : histogram())
+    {
+        if (entry.text().isText())
+        {
+            entries.push_back(entry);
+        }
+    }
+    return entries;
+}
+
+auto TableUsage::remapping() const -> std::map<BinarySequence, BinarySequence>
+{
+    std::vector<BinarySequence> codes;
+    for (auto const& entry : m_table.entries())
+    {
+        if (entry.text().isText())
+        {
+            codes.push_back(entry.binary());
+        }
+    }
+    std::sort(codes.begin(), codes.end(), [](auto const& lhs, auto const& rhs) {
+        return lhs.size() != rhs.size() ? lhs.size() < rhs.size() : lhs < rhs;
+    });
+
+    std::map<BinarySequence, BinarySequence> remapping;
+    size_t index{0};
+    for (auto const& entry : usedTextEntries())
+    {
+        remapping[entry.binary()] = codes[index++];
+    }
+    return remapping;
+}
+
+auto TableUsage::makeSubsetTable() const -> Table
+{
+    Table subset;
+    subset.setName(m_table.name());
+    for (auto const& [from, to] : remapping())
+    {
+        subset.insert(to, m_table.find(from)->text());
+    }
+    for (auto const& entry : m_table.entries())
+    {
+        if (!entry.text().isText())
+        {
+            subset.insert(entry.binary(), entry.text());
+        }
+    }
+    return subset;
+}
+
+auto TableUsage::usedTexts() const -> std::vector<std::string>
+{
+    std::vector<std::string> texts;
+    for (auto const& entry : usedTextEntries())
+    {
+        texts.push_back(entry.text().text());
+    }
+    return texts;
+}
+
+auto TableUsage::remap(const BinaryView& binary, size_t offset, size_t size) const -> Binary
+{
+    Expects(offset + size <= binary.size());
+    auto const mapping = remapping();
+
+    Binary remapped;
+    auto const* position = binary.data() + offset;
+    auto const* end = position + size;
+    while (position < end)
+    {
+        auto const maybeEntry = m_table.findLongestBinaryMatch(position, end);
+        if (!maybeEntry)
+        {
+            remapped.append(*position++);
+            continue;
+        }
+
+        // unused texts have no code in the subset, and their old one may belong to another text
+        auto const& entry = *maybeEntry;
+        auto const newCode = mapping.find(entry.binary());
+        if (newCode != mapping.cend())
+        {
+            remapped.append(newCode->second);
+        }
+        else if (entry.text().isText())
+        {
+            throw std::runtime_error{"TableUsage: text is not part of the subset"};
+        }
+        else
+        {
+            remapped.append(entry.binary());
+        }
+        position += entry.binary().size();
+
+        for (size_t i = 0; i < entry.text().parameterCount(); ++i)
+        {
+            auto const parameterSize =
+                std::min<size_t>(entry.text().parameter(i).size, end - position);
+            remapped.append(position, position + parameterSize);
+            position += parameterSize;
+        }
+    }
+    return remapped;
+}
+
+} // namespace kaizo
@@ -1,70 +1,77 @@
-#include <cctype>
 #include <contracts/Contracts.h>
-#include <fstream>
 #include <kaizo/utilities/CsvReader.h>
+#include <stdexcept>
 
 namespace kaizo::data {
 
 CsvReader::CsvReader(const std::filesystem::path& filename)
 {
-    std::ifstream input{filename, std::ifstream::binary};
-    if (input.good())
+    try
     {
-        m_size = std::filesystem::file_size(filename);
-        m_buffer = std::make_unique<unsigned char[]>(m_size);
-        input.read(reinterpret_cast<char*>(m_buffer.get()), m_size);
-
-        m_position = 0;
-        if (m_size >= 3 && m_buffer[0] == 0xEF && m_buffer[1] == 0xBB && m_buffer[2] == 0xBF)
-        {
-            m_position += 3;
-        }
+        m_file = MappedFile{filename};
     }
-    else
+    catch (std::exception&)
     {
         throw std::runtime_error{"CsvReader: could not open " + filename.string()};
     }
+    setText(std::string_view{reinterpret_cast<const char*>(m_file.data()), m_file.size()});
 }
 
-auto CsvReader::nextRow() -> std::optional<std::vector<std::string>>
+CsvReader::CsvReader(std::string_view text)
+{
+    setText(text);
+}
+
+void CsvReader::setText(std::string_view text)
+{
+    m_text = text;
+    m_position = 0;
+    if (m_text.starts_with("\xEF\xBB\xBF"))
+    {
+        m_position += 3;
+    }
+}
+
+auto CsvReader::nextRow() -> std::optional<std::span<const std::string_view>>
 {
     if (!hasNext())
     {
         return {};
     }
-    std::vector<std::string> row;
+    m_row.clear();
+    m_unescapedCount = 0;
     while (hasNext())
     {
-        row.push_back(nextColumn());
+        m_row.push_back(nextColumn());
         if (!hasNext())
         {
-            return row;
+            return m_row;
         }
         else if (fetch() == '\n')
         {
             consume();
-            return row;
+            return m_row;
         }
         else if (fetch() == '\r')
         {
             consume();
-            if (fetch() == '\n')
+            if (hasNext() && fetch() == '\n')
             {
                 consume();
             }
-            return row;
+            return m_row;
         }
         else if (fetch() != ',')
         {
-            throw std::runtime_error{"unexpected character: " + fetch()};
+            throw std::runtime_error{std::string{"CsvReader: unexpected character: "} + fetch()};
         }
         consume();
     }
-    row.push_back("");
-    return row;
+    m_row.push_back({});
+    return m_row;
 }
 
-auto CsvReader::nextColumn() -> std::string
+auto CsvReader::nextColumn() -> std::string_view
 {
     if (fetch() == '"')
     {
@@ -76,65 +83,74 @@ auto CsvReader::nextColumn() -> std::string
     }
 }
 
-auto CsvReader::parseQuoted() -> std::string
+auto CsvReader::parseQuoted() -> std::string_view
 {
-    std::string column;
     consume();
+    auto const begin = m_position;
+    bool hasEscapes{false};
     while (true)
     {
-        if (fetch() == '"')
+        auto const quote = m_text.find('"', m_position);
+        if (quote == std::string_view::npos)
         {
+            throw std::runtime_error{"CsvReader: unexpected end of CSV file"};
+        }
+        m_position = quote + 1;
+        if (hasNext() && fetch() == '"')
+        {
+            hasEscapes = true;
             consume();
-            if (hasNext() && fetch() == '"')
-            {
-                column += '"';
-                consume();
-                continue;
-            }
-            else
-            {
-                break;
-            }
         }
-
-        column += fetch();
-        consume();
-        if (!hasNext())
+        else
         {
-            throw std::runtime_error{ "unexpected end of CSV file" };
+            break;
         }
     }
+    auto const column = m_text.substr(begin, m_position - 1 - begin);
 
-    while (fetch() != ',' && fetch() != '\n' && fetch() != '\r' && hasNext())
+    while (hasNext() && fetch() != ',' && fetch() != '\n' && fetch() != '\r')
     {
         consume();
     }
-    return column;
+    return hasEscapes ? unescape(column) : column;
 }
 
-auto CsvReader::parseNotQuoted() -> std::string
+auto CsvReader::unescape(std::string_view quoted) -> std::string_view
 {
-    std::string column;
-    while (fetch() != ',' && fetch() != '\n' && fetch() != '\r' && hasNext())
+    // a deque never moves its elements, so views of earlier columns remain valid
+    if (m_unescapedCount == m_unescaped.size())
     {
-        column += fetch();
-        consume();
-        if (!hasNext())
+        m_unescaped.emplace_back();
+    }
+    auto& column = m_unescaped[m_unescapedCount++];
+    column.clear();
+    for (auto i = 0U; i < quoted.size(); ++i)
+    {
+        column += quoted[i];
+        if (quoted[i] == '"')
         {
-            throw std::runtime_error{"unexpected end of CSV file"};
+            ++i;
         }
     }
     return column;
 }
 
+auto CsvReader::parseNotQuoted() -> std::string_view
+{
+    auto const begin = m_position;
+    auto const end = m_text.find_first_of(",\r\n", m_position);
+    m_position = end == std::string_view::npos ? m_text.size() : end;
+    return m_text.substr(begin, m_position - begin);
+}
+
 bool CsvReader::hasNext() const
 {
-    return m_position < m_size;
+    return m_position < m_text.size();
 }
 
 auto CsvReader::fetch() const -> char
 {
-    return m_buffer[m_position];
+    return m_text[m_position];
 }
 
 void CsvReader::consume()
@@ -162,4 +178,4 @@ auto CsvReader::columnName(size_t index) const -> const std::string&
     return *m_columnNames[index];
 }
 
-} // namespace kaizo::data
\ No newline at end of file
+} // namespace kaizo::data
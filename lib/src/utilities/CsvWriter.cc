@@ -0,0 +1,89 @@
+#include <kaizo/utilities/CsvWriter.h>
+#include <stdexcept>
+
+namespace kaizo::data {
+
+static constexpr size_t BufferSize = 1 << 20;
+
+CsvWriter::CsvWriter(const std::filesystem::path& filename)
+{
+#ifdef _WIN32
+    m_file = _wfopen(filename.c_str(), L"wb");
+#else
+    m_file = std::fopen(filename.c_str(), "wb");
+#endif
+    if (!m_file)
+    {
+        throw std::runtime_error{"CsvWriter: could not open " + filename.string()};
+    }
+    m_buffer.reserve(BufferSize);
+}
+
+CsvWriter::~CsvWriter()
+{
+    if (m_file)
+    {
+        std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+        std::fclose(m_file);
+    }
+}
+
+void CsvWriter::column(std::string_view value, bool quoted)
+{
+    if (!m_isFirstColumn)
+    {
+        write(',');
+    }
+    m_isFirstColumn = false;
+
+    if (!quoted && value.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        write(value);
+        return;
+    }
+
+    write('"');
+    for (auto quote = value.find('"'); quote != std::string_view::npos; quote = value.find('"'))
+    {
+        write(value.substr(0, quote + 1));
+        write('"');
+        value.remove_prefix(quote + 1);
+    }
+    write(value);
+    write('"');
+}
+
+void CsvWriter::endRow()
+{
+    write('\n');
+    m_isFirstColumn = true;
+}
+
+void CsvWriter::flush()
+{
+    if (std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) != m_buffer.size())
+    {
+        throw std::runtime_error{"CsvWriter: could not write to file"};
+    }
+    m_buffer.clear();
+}
+
+void CsvWriter::write(std::string_view string)
+{
+    if (m_buffer.size() + string.size() > BufferSize)
+    {
+        flush();
+    }
+    m_buffer.append(string);
+}
+
+void CsvWriter::write(char c)
+{
+    if (m_buffer.size() == BufferSize)
+    {
+        flush();
+    }
+    m_buffer += c;
+}
+
+} // namespace kaizo::data
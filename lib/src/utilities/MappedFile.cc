@@ -0,0 +1,109 @@
+#include <kaizo/utilities/MappedFile.h>
+#include <stdexcept>
+#include <utility>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace kaizo {
+
+MappedFile::MappedFile(const std::filesystem::path& filename)
+{
+    auto const error = [&filename]() {
+        return std::runtime_error{"MappedFile: could not map " + filename.string()};
+    };
+
+    m_size = std::filesystem::file_size(filename);
+    if (m_size == 0)
+    {
+        // empty files cannot be mapped
+        return;
+    }
+
+#ifdef _WIN32
+    auto file = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw error();
+    }
+    auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+    {
+        throw error();
+    }
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle(mapping);
+    if (!m_data)
+    {
+        throw error();
+    }
+#else
+    auto const file = ::open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        throw error();
+    }
+    auto* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (mapping == MAP_FAILED)
+    {
+        throw error();
+    }
+    ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const uint8_t*>(mapping);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}
+    , m_size{std::exchange(other.m_size, 0)}
+{
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+    if (this != &other)
+    {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+void MappedFile::unmap()
+{
+    if (m_data)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(m_data);
+#else
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+    }
+}
+
+auto MappedFile::data() const -> const uint8_t*
+{
+    return m_data;
+}
+
+auto MappedFile::size() const -> size_t
+{
+    return m_size;
+}
+
+} // namespace kaizo
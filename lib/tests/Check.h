@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+/// Aborts the test with the failed condition and its location unless the condition holds.
+#define CHECK(condition) kaizo::tests::check((condition), #condition, __FILE__, __LINE__)
+
+namespace kaizo::tests {
+
+inline void check(bool condition, const char* expression, const char* file, int line)
+{
+    if (!condition)
+    {
+        std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+} // namespace kaizo::tests
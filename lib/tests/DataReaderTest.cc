@@ -0,0 +1,57 @@
+#include "Check.h"
+#include <kaizo/data/DataPath.h>
+#include <kaizo/data/DataReader.h>
+#include <kaizo/data/data/IntegerData.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+using namespace kaizo;
+using namespace kaizo::data;
+
+static void testJoinedForks()
+{
+    auto const binary = Binary::fromArray(std::vector<uint8_t>(16).data(), 16);
+    DataReader reader{BinaryView{binary}};
+    reader.enter(DataPathElement::makeName("items"));
+
+    // enough joins that the reader has to grow its storage for the joined structures
+    constexpr size_t ForkCount = 5;
+    std::deque<IntegerData> values;
+    for (size_t i = 0; i < ForkCount; ++i)
+    {
+        values.emplace_back(static_cast<int64_t>(i));
+    }
+    for (size_t i = 0; i < ForkCount; ++i)
+    {
+        auto fork = reader.fork();
+        fork->enter(DataPathElement::makeIndex(i + 1));
+        fork->enter(DataPathElement::makeName("value"));
+        fork->leave(&values[i]);
+        fork->leave(nullptr);
+        reader.join(*fork);
+    }
+    reader.leave(nullptr);
+
+    std::vector<std::string> paths;
+    std::vector<const Data*> data;
+    reader.visitStructure([&](const DataPath& path, const Data* node) {
+        paths.push_back(path.toString());
+        data.push_back(node);
+    });
+
+    CHECK(paths.size() == 1 + 2 * ForkCount);
+    CHECK(paths[0] == "items");
+    for (size_t i = 0; i < ForkCount; ++i)
+    {
+        auto const index = "items[" + std::to_string(i + 1) + "]";
+        CHECK(paths[1 + 2 * i] == index);
+        CHECK(paths[2 + 2 * i] == index + ".value");
+        CHECK(data[2 + 2 * i] == &values[i]);
+    }
+}
+
+int main()
+{
+    testJoinedForks();
+}
@@ -0,0 +1,166 @@
+#include "Check.h"
+#include <algorithm>
+#include <kaizo/addresses/AbsoluteOffset.h>
+#include <kaizo/data/linking/FreeSpace.h>
+#include <optional>
+#include <random>
+#include <vector>
+
+using namespace kaizo;
+using namespace kaizo::data;
+
+/// A free range of the naive model; ranges are kept ordered just like the blocks of a FreeSpace.
+struct Range
+{
+    size_t target;
+    size_t start;
+    size_t end;
+
+    auto operator<=>(const Range&) const = default;
+};
+
+static auto address(size_t offset) -> Address
+{
+    return *fileOffsetFormat()->fromInteger(offset);
+}
+
+static void checkQueries(const FreeSpace& space, const std::vector<Range>& ranges,
+                         std::mt19937& random)
+{
+    CHECK(space.blockCount() == ranges.size());
+    size_t capacity{0};
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        auto const& block = space.block(i);
+        CHECK(block.target() == ranges[i].target);
+        CHECK(block.offset() == ranges[i].start);
+        CHECK(block.size() == ranges[i].end - ranges[i].start);
+        capacity += block.size();
+    }
+    CHECK(space.capacity() == capacity);
+
+    auto const size = random() % 80;
+    std::optional<size_t> first;
+    std::optional<size_t> best;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        auto const rangeSize = ranges[i].end - ranges[i].start;
+        if (rangeSize >= size)
+        {
+            first = first.value_or(i);
+            if (!best || rangeSize < ranges[*best].end - ranges[*best].start)
+            {
+                best = i;
+            }
+        }
+    }
+    CHECK(space.findFirstBlockThatFits(size) == first);
+    CHECK(space.hasBlockThatFits(size) == first.has_value());
+    auto const bestFit = space.findBestFit(size);
+    CHECK(bestFit.has_value() == best.has_value());
+    CHECK(!best || space.block(*bestFit).size() == ranges[*best].end - ranges[*best].start);
+
+    auto const target = random() % 3;
+    auto const lower = random() % 2000;
+    auto const upper = lower + random() % 500;
+    std::optional<size_t> containing;
+    size_t withinFirst{0};
+    size_t withinLast{0};
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        auto const& range = ranges[i];
+        if (range.target < target || (range.target == target && range.end <= lower))
+        {
+            withinFirst = i + 1;
+        }
+        if (range.target < target || (range.target == target && range.start < upper))
+        {
+            withinLast = i + 1;
+        }
+        if (range.target == target && range.start <= lower && lower < range.end)
+        {
+            containing = i;
+        }
+    }
+    CHECK(space.findBlockThatContains(target, address(lower)) == containing);
+    auto const within = space.findBlocksWithinRange(target, address(lower), address(upper));
+    CHECK(within.first == withinFirst);
+    CHECK(within.second == std::max(withinFirst, withinLast));
+}
+
+/// Adds, allocates and reverts blocks at random and compares the FreeSpace with a plain list of
+/// ranges after every step.
+static void testAgainstNaiveRanges(unsigned seed)
+{
+    std::mt19937 random{seed};
+    auto const between = [&random](size_t first, size_t last) {
+        return first + random() % (last - first);
+    };
+
+    FreeSpace space;
+    std::vector<Range> ranges;
+    std::vector<std::pair<Range, std::vector<Range>>> allocations;
+    size_t next{0};
+    auto const add = [&] {
+        next += between(1, 16);
+        auto const range = Range{between(0, 3), next, next + between(1, 64)};
+        space.addBlock(FreeBlock{range.start, address(range.start), range.end - range.start,
+                                 range.target});
+        ranges.insert(std::upper_bound(ranges.begin(), ranges.end(), range), range);
+        next = range.end;
+    };
+
+    for (auto i = 0; i < 20; ++i)
+    {
+        add();
+    }
+    for (auto step = 0; step < 2000; ++step)
+    {
+        auto const action = random() % 10;
+        if (action < 5 && !ranges.empty())
+        {
+            auto const range = ranges[between(0, ranges.size())];
+            auto const offset = between(range.start, range.end);
+            auto const length = between(1, range.end - offset + 1);
+            space.allocateRange(range.target, address(offset), length);
+
+            std::vector<Range> pieces;
+            if (range.start < offset)
+            {
+                pieces.push_back(Range{range.target, range.start, offset});
+            }
+            if (offset + length < range.end)
+            {
+                pieces.push_back(Range{range.target, offset + length, range.end});
+            }
+            auto const position = ranges.erase(std::find(ranges.begin(), ranges.end(), range));
+            ranges.insert(position, pieces.begin(), pieces.end());
+            allocations.emplace_back(range, pieces);
+        }
+        else if (action < 9 && !allocations.empty())
+        {
+            space.deallocateLast();
+            auto const& [range, pieces] = allocations.back();
+            for (auto const& piece : pieces)
+            {
+                ranges.erase(std::find(ranges.begin(), ranges.end(), piece));
+            }
+            ranges.insert(std::upper_bound(ranges.begin(), ranges.end(), range), range);
+            allocations.pop_back();
+        }
+        else
+        {
+            add();
+        }
+        CHECK(space.allocationCount() == allocations.size());
+        checkQueries(space, ranges, random);
+    }
+}
+
+int main()
+{
+    for (auto seed = 0U; seed < 20; ++seed)
+    {
+        testAgainstNaiveRanges(seed);
+    }
+}
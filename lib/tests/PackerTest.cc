@@ -0,0 +1,225 @@
+#include "Check.h"
+#include <functional>
+#include <kaizo/addresses/AbsoluteOffset.h>
+#include <kaizo/data/linking/Backtracker.h>
+#include <kaizo/data/linking/ExactPacker.h>
+#include <kaizo/data/linking/GreedyPacker.h>
+#include <kaizo/data/linking/PortfolioPacker.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace kaizo;
+using namespace kaizo::data;
+
+using PackerFactory = std::function<std::unique_ptr<Packer>()>;
+
+static auto address(size_t offset) -> Address
+{
+    return *fileOffsetFormat()->fromInteger(offset);
+}
+
+static auto backtracking(bool greedyFirst) -> PackerFactory
+{
+    return [greedyFirst] {
+        auto packer = std::make_unique<BacktrackingPacker>();
+        packer->setGreedyFirst(greedyFirst);
+        return std::unique_ptr<Packer>{std::move(packer)};
+    };
+}
+
+static auto exact() -> PackerFactory
+{
+    return [] { return std::unique_ptr<Packer>{std::make_unique<ExactPacker>()}; };
+}
+
+static auto greedy(GreedyPacker::Fit fit) -> PackerFactory
+{
+    return [fit] { return std::unique_ptr<Packer>{std::make_unique<GreedyPacker>(fit)}; };
+}
+
+/// Packs objects a and b of 8 bytes into a 64-byte block, where a lies 32 bytes after b. The
+/// objects are added to the packer in the given order and constrained by the given function.
+static auto packRelative(const PackerFactory& factory, bool aFirst,
+                         const std::function<void(LinkObject& a, LinkObject& b)>& constrain)
+    -> std::pair<std::unique_ptr<Packer>, bool>
+{
+    auto packer = factory();
+    packer->addFreeBlock(FreeBlock{0, address(0), 64, 0});
+    auto a = std::make_unique<LinkObject>("a", 8);
+    auto b = std::make_unique<LinkObject>("b", 8);
+    constrain(*a, *b);
+    if (aFirst)
+    {
+        packer->addObject(std::move(a));
+        packer->addObject(std::move(b));
+    }
+    else
+    {
+        packer->addObject(std::move(b));
+        packer->addObject(std::move(a));
+    }
+    auto const packed = packer->pack();
+    return {std::move(packer), packed};
+}
+
+static auto distance(const Packer& packer, bool aFirst) -> int64_t
+{
+    auto const& a = packer.object(aFirst ? 0 : 1)->allocation();
+    auto const& b = packer.object(aFirst ? 1 : 0)->allocation();
+    return static_cast<int64_t>(a.address.toInteger()) -
+           static_cast<int64_t>(b.address.toInteger());
+}
+
+/// A constraint on only one of the objects must not make a packer report allocations that
+/// violate it, whichever object is allocated first.
+static void testOneSidedRelativeRange(const PackerFactory& factory)
+{
+    for (auto const aFirst : {true, false})
+    {
+        auto const [packer, packed] = packRelative(factory, aFirst, [](auto& a, auto& b) {
+            a.constrain(std::make_unique<RelativeRangeConstraint>(&b, 32, 32));
+        });
+        CHECK(!packed || packer->isSolved());
+        CHECK(!packed || distance(*packer, aFirst) == 32);
+    }
+}
+
+/// Constraining both objects lets either restrict the other, so the problem is solved in both
+/// orders.
+static void testRelativeRange(const PackerFactory& factory)
+{
+    for (auto const aFirst : {true, false})
+    {
+        auto const [packer, packed] = packRelative(
+            factory, aFirst, [](auto& a, auto& b) { a.constrainRelative(b, 32, 32); });
+        CHECK(packed);
+        CHECK(packer->isSolved());
+        CHECK(distance(*packer, aFirst) == 32);
+    }
+}
+
+/// The 16 bytes before the segment boundary at 64 only fit one of the 12-byte objects, so a and b
+/// must both go after it.
+static void testSameSegment(const PackerFactory& factory, bool mirrored)
+{
+    for (auto const aFirst : {true, false})
+    {
+        auto packer = factory();
+        packer->addFreeBlock(FreeBlock{0, address(48), 48, 0});
+        auto a = std::make_unique<LinkObject>("a", 12);
+        auto b = std::make_unique<LinkObject>("b", 12);
+        if (mirrored)
+        {
+            a->constrainSameSegment(*b, 64);
+        }
+        else
+        {
+            a->constrain(std::make_unique<SameSegmentConstraint>(b.get(), 64));
+        }
+        packer->addObject(std::move(aFirst ? a : b));
+        packer->addObject(std::move(aFirst ? b : a));
+        auto const packed = packer->pack();
+        CHECK(!packed || packer->isSolved());
+        CHECK(!mirrored || packed);
+        if (packed)
+        {
+            auto const first = packer->object(0)->allocation().address.toInteger();
+            auto const second = packer->object(1)->allocation().address.toInteger();
+            CHECK(first / 64 == second / 64);
+        }
+    }
+}
+
+/// The greedy packer only succeeds with allocations that satisfy every constraint, even one on an
+/// object it allocated before the object the constraint refers to.
+static void testGreedySolvesWhatItPacks(GreedyPacker::Fit fit)
+{
+    for (auto const aFirst : {true, false})
+    {
+        auto const [packer, packed] = packRelative(greedy(fit), aFirst, [](auto& a, auto& b) {
+            a.constrain(std::make_unique<RelativeRangeConstraint>(&b, 32, 32));
+        });
+        CHECK(packed == packer->isSolved());
+    }
+}
+
+/// Puts every object into the first block it fits in, regardless of its constraints, and claims
+/// to have succeeded.
+class IgnoringConstraintsPacker : public Packer
+{
+protected:
+    bool doPack() override
+    {
+        for (auto const& object : m_linkObjects)
+        {
+            auto const index = m_freeSpace.findFirstBlockThatFits(object->size());
+            if (!index)
+            {
+                return false;
+            }
+            auto const& block = m_freeSpace.block(*index);
+            Allocation allocation;
+            allocation.block = *index;
+            allocation.offset = block.offset();
+            allocation.address = block.address();
+            allocation.size = block.size();
+            allocation.target = block.target();
+            object->setAllocation(allocation);
+            m_freeSpace.allocateRange(block.target(), allocation.address, object->size());
+        }
+        return true;
+    }
+};
+
+/// A strategy whose allocations violate constraints has not succeeded, so the portfolio uses
+/// another one or fails.
+static void testPortfolioIgnoresUnsolved()
+{
+    for (auto const withGreedy : {false, true})
+    {
+        PortfolioPacker packer;
+        packer.clearStrategies();
+        packer.setThreadCount(1);
+        packer.addStrategy("ignoring constraints",
+                           [] { return std::make_unique<IgnoringConstraintsPacker>(); });
+        if (withGreedy)
+        {
+            packer.addStrategy("greedy", greedy(GreedyPacker::Fit::Best));
+        }
+        packer.addFreeBlock(FreeBlock{0, address(0), 64, 0});
+        auto object = std::make_unique<LinkObject>("fixed", 8);
+        object->setFixedAddress(address(48));
+        packer.addObject(std::move(object));
+
+        auto const packed = packer.pack();
+        CHECK(packed == withGreedy);
+        CHECK(!packed || packer.isSolved());
+        CHECK(!packed || packer.winner() == "greedy");
+    }
+}
+
+int main()
+{
+    for (auto const& factory : {backtracking(true), backtracking(false), exact()})
+    {
+        testOneSidedRelativeRange(factory);
+        testRelativeRange(factory);
+    }
+    // the exact packer starts the block with one of the objects and does not leave the gap before
+    // the segment boundary this needs, see ExactPacker
+    for (auto const& factory : {backtracking(true), backtracking(false)})
+    {
+        testSameSegment(factory, false);
+        testSameSegment(factory, true);
+    }
+    for (auto const& factory : {greedy(GreedyPacker::Fit::First), greedy(GreedyPacker::Fit::Best)})
+    {
+        testOneSidedRelativeRange(factory);
+        testSameSegment(factory, false);
+    }
+    testGreedySolvesWhatItPacks(GreedyPacker::Fit::First);
+    testGreedySolvesWhatItPacks(GreedyPacker::Fit::Best);
+    testPortfolioIgnoresUnsolved();
+}
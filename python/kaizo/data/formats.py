@@ -1,7 +1,7 @@
 from kaizo.kaizopy import *
 from kaizo.kaizopy import _FileOffset, _DataFormat, _IntegerFormat,\
                           _StringFormat, _RecordFormat, _ArrayFormat,\
-                          _PointerFormat
+                          _PointerFormat, _CompiledFormat, _CompressedFormat
 from kaizo import TextEncoding
 
 class DataFormat:
@@ -20,9 +20,33 @@ class DataFormat:
     def decode(self, reader):
         return self._format.decode(reader._reader)
 
+    def query(self, reader, *patterns):
+        """Decodes the data and returns, for each pattern, a list of (path, value) pairs of the
+        elements it matches; patterns may contain wildcards, e.g. 'items[*].name' or '**.name'."""
+        return self._format.query(reader._reader, list(patterns))
+
     def encode(self, writer, data, path):
+        if isinstance(data, ColumnarData):
+            data = data._columns
         return self._format.encode(writer._writer, data, path)
 
+    def compile(self):
+        _compiled = _CompiledFormat.compile(self._format)
+        if _compiled is None:
+            return None
+        return CompiledFormat(_compiled)
+
+class CompiledFormat:
+    def __init__(self, compiled):
+        self._compiled = compiled
+
+    @property
+    def fixed_size(self):
+        return self._compiled.fixed_size
+
+    def decode(self, reader):
+        return self._compiled.decode(reader._reader)
+
 class IntegerFormat(DataFormat):
     def __init__(self, size, unsignedness=Signedness.UNSIGNED, endianness=Endianness.LITTLE, **kwargs):
         self._format = _IntegerFormat(size, unsignedness, endianness)
@@ -49,9 +73,13 @@ class RecordFormat(DataFormat):
             self._format.append(element[0], element[1]._format)
 
 class ArrayFormat(DataFormat):
-    def __init__(self, length, element, **kwargs):
+    def __init__(self, length, element, thread_count=None, **kwargs):
+        """thread_count decodes the pointees of an array of pointers in parallel; 0 uses one
+        thread per core."""
         self._format = _ArrayFormat()
         self._setup(**kwargs)
+        if thread_count is not None:
+            self._format.set_thread_count(int(thread_count))
         if isinstance(length, int):
             self._format.set_fixed_length(length)
         else:
@@ -60,6 +88,66 @@ class ArrayFormat(DataFormat):
             raise TypeError("expected a DataFormat")
         self._format.set_element_format(element._format)
 
+    def decode_columnar(self, reader):
+        """Decodes an array of records into one buffer per record element; returns None if the
+        elements are not records of integers and strings."""
+        _columns = self._format.decode_columnar(reader._reader)
+        if _columns is None:
+            return None
+        return ColumnarData(_columns)
+
+    def decode_lazy(self, reader):
+        """Returns a sequence whose elements are only decoded when accessed."""
+        return LazyArray(self._format.decode_lazy(reader._reader))
+
+class LazyArray:
+    def __init__(self, array):
+        self._array = array
+        self._cache = {}
+
+    def __len__(self):
+        return len(self._array)
+
+    def __getitem__(self, index):
+        if isinstance(index, slice):
+            return [self[i] for i in range(*index.indices(len(self)))]
+        if index < 0:
+            index += len(self)
+        if index < 0 or index >= len(self):
+            raise IndexError("array index out of range")
+        if index not in self._cache:
+            self._cache[index] = self._array[index]
+        return self._cache[index]
+
+    def __iter__(self):
+        for i in range(len(self)):
+            yield self[i]
+
+    def to_list(self):
+        return list(self)
+
+class ColumnarData:
+    def __init__(self, columns):
+        self._columns = columns
+
+    def __len__(self):
+        return self._columns.row_count
+
+    def __getitem__(self, name):
+        """Integer columns support the buffer protocol, e.g. numpy.asarray(data['x']); string
+        columns expose offsets into their arena the same way."""
+        return self._columns.column(name)
+
+    @property
+    def column_names(self):
+        return self._columns.column_names
+
+    def row(self, index):
+        return self._columns.row(index)
+
+    def to_list(self):
+        return self._columns.to_list()
+
 class PointerFormat(DataFormat):
     def __init__(self, pointee, layout, format, use_address_map=False, null_pointer=None, **kwargs):
         self._format = _PointerFormat()
@@ -70,3 +158,20 @@ class PointerFormat(DataFormat):
             self._format.set_null_pointer(null_pointer)
         self._format.use_address_map(use_address_map)
         self._setup(**kwargs)
+
+class CompressedFormat(DataFormat):
+    def __init__(self, inner, codec, level=None, thread_count=None, **kwargs):
+        """codec is a Codec or the name of one ('lz10', 'lzss' or 'yaz0'); thread_count
+        compresses the data in independent blocks in parallel, 0 uses one thread per core."""
+        if not isinstance(inner, DataFormat):
+            raise TypeError("expected a DataFormat")
+        if isinstance(codec, str):
+            codec = Codec(codec)
+        if level is not None:
+            codec.level = level
+        if thread_count is not None:
+            codec.thread_count = int(thread_count)
+        self._format = _CompressedFormat()
+        self._format.set_codec(codec)
+        self._format.set_inner_format(inner._format)
+        self._setup(**kwargs)
@@ -1,42 +1,207 @@
-from kaizo.data.objects import BinaryObject, FixedAddressConstraint, AddressRangeConstraint
+from kaizo.data.objects import (BinaryObject, FixedAddressConstraint, AddressRangeConstraint,
+                                SegmentConstraint, TargetConstraint, SameSegmentConstraint,
+                                RelativeRangeConstraint)
 from kaizo.addresses import FileOffset
 from kaizo.utilities import IntervalList
-from kaizo.kaizopy import _BacktrackingPacker
+from kaizo.kaizopy import _BacktrackingPacker, _ExactPacker, _PortfolioPacker, TraceLevel
 from pathlib import Path
 from sortedcontainers import SortedList
 import shutil
 
+# the native packer keeps sets of targets as 64-bit masks
+MAX_TARGET_COUNT = 64
+
 class PackingFailedError(Exception):
     pass
 
 class Packer:
-    def pack(self, objects, free_blocks):
+    def pack(self, objects, targets):
         pass
 
-class BacktrackingPacker(Packer):
+class NativePacker(Packer):
     """
-    Packs a list of objects into a set of free blocks, satisfying any constraints
-    provided by the individual objects.
+    Packs a list of objects into the free blocks of one or more targets at once,
+    satisfying any constraints provided by the individual objects, using a
+    native packer. Address constraints refer to the addresses the targets are
+    loaded to, so objects may be constrained relative to objects in other
+    targets.
     """
 
-    def __init__(self, *, log='packing_log.txt'):
-        self._packer = _BacktrackingPacker()
-        if log is not None:
-            self._packer.set_log_file(log)
+    def __init__(self, packer, *, time_limit=None):
+        self._packer = packer
+        if time_limit is not None:
+            self._packer.set_time_limit(time_limit)
 
-    def pack(self, objects, free_blocks):
+    def pack(self, objects, targets):
+        if len(targets) > MAX_TARGET_COUNT:
+            raise ValueError(f'can only pack into at most {MAX_TARGET_COUNT} targets')
         # order important: first add free blocks
-        for block in free_blocks:
-            self._packer.add_free_block(block.offset, block.address, block.size)
+        for target_index, target in enumerate(targets):
+            for block in target.free_blocks:
+                self._packer.add_free_block(block.offset, block.address, block.size,
+                                            target_index)
         for obj in objects:
-            if obj.constraints:
-                raise ValueError('constraints not yet supported')
-            self._packer.add_object(obj.actual_size)
+            self._packer.add_object(obj.actual_size, obj.alignment)
+        # objects can only be constrained relative to each other once all are added
+        indices = {id(obj): i for i, obj in enumerate(objects)}
+        for i, obj in enumerate(objects):
+            for constraint in obj.constraints:
+                self._constrain(i, obj, constraint, indices, len(targets))
         if not self._packer.pack():
             raise PackingFailedError('could not pack the given objects')
         for i, obj in enumerate(objects):
             obj.link_offset = self._packer.get_link_offset(i)
             obj.link_address = self._packer.get_link_address(i)
+            obj.link_target = self._packer.get_link_target(i)
+
+    def _constrain(self, index, obj, constraint, indices, target_count):
+        if isinstance(constraint, FixedAddressConstraint):
+            self._packer.constrain_fixed_address(index, constraint.address)
+        elif isinstance(constraint, AddressRangeConstraint):
+            self._packer.constrain_address_range(index, constraint.lower, constraint.upper)
+        elif isinstance(constraint, SegmentConstraint):
+            self._packer.constrain_segment(index, constraint.address, constraint.segment_size)
+        elif isinstance(constraint, TargetConstraint):
+            if constraint.targets[-1] >= target_count:
+                raise ValueError(f'object "{obj.path}" refers to target {constraint.targets[-1]}, '
+                                 f'but there are only {target_count} targets')
+            mask = 0
+            for target in constraint.targets:
+                mask |= 1 << target
+            self._packer.constrain_targets(index, mask)
+        elif isinstance(constraint, (SameSegmentConstraint, RelativeRangeConstraint)):
+            other = constraint.other
+            if id(other) in indices:
+                if isinstance(constraint, SameSegmentConstraint):
+                    self._packer.constrain_same_segment(
+                        index, indices[id(other)], constraint.segment_size)
+                else:
+                    self._packer.constrain_relative_range(
+                        index, indices[id(other)], constraint.minimum, constraint.maximum)
+            elif other.link_address is not None:
+                # the other object is already placed, e.g. at a fixed offset
+                if isinstance(constraint, SameSegmentConstraint):
+                    self._packer.constrain_segment(
+                        index, other.link_address, constraint.segment_size)
+                else:
+                    self._packer.constrain_address_range(
+                        index, other.link_address.offset(constraint.minimum),
+                        other.link_address.offset(constraint.maximum + obj.actual_size))
+            else:
+                raise ValueError(f'object "{other.path}" is neither packed nor placed')
+        else:
+            raise ValueError(f'unsupported constraint {type(constraint).__name__}')
+
+class BacktrackingPacker(NativePacker):
+    """
+    Packs objects by depth-first search over their candidate allocations.
+
+    If a trace file is given, the search is recorded to it up to the given
+    level; see kaizo.data.packingtrace for reading it. With stats=True, the
+    packer also measures where the time goes and prints a report of the
+    statistics after packing, whether it succeeds or not.
+    """
+
+    def __init__(self, *, trace=None, trace_level=TraceLevel.SEARCH, stats=False,
+                 time_limit=None):
+        super().__init__(_BacktrackingPacker(), time_limit=time_limit)
+        if trace is not None:
+            self._packer.set_trace_file(str(trace), trace_level)
+        self.stats = stats
+        self._packer.set_profiling(stats)
+
+    def pack(self, objects, targets):
+        try:
+            super().pack(objects, targets)
+        finally:
+            if self.stats:
+                print(format_packing_statistics(self.statistics, objects))
+
+    @property
+    def statistics(self):
+        """
+        Returns the statistics of the last pack() as a dict; objects are
+        referred to by their index in the packed list.
+        """
+        return self._packer.statistics
+
+def _format_histogram(buckets):
+    ranges = []
+    for i, count in enumerate(buckets):
+        if count == 0:
+            continue
+        lower = 0 if i == 0 else 1 << (i - 1)
+        upper = 0 if i == 0 else (1 << i) - 1
+        bounds = f'{lower}' if lower == upper else f'{lower}-{upper}'
+        ranges.append(f'{bounds}: {count}')
+    return ', '.join(ranges) if ranges else 'none'
+
+def format_packing_statistics(statistics, objects, *, top=10, samples=16):
+    """
+    Formats the statistics of a BacktrackingPacker as a report listing the
+    objects that made the search backtrack most often and how fragmented the
+    free space was over time.
+    """
+    time = statistics['time']
+    lines = [f'{statistics["steps"]} steps, {statistics["rejections"]} rejected by forward '
+             f'checking, {statistics["backtracks"]} backtracks '
+             f'(maximum depth {statistics["maximum_depth"]})',
+             f'{statistics["greedy_allocations"]} objects allocated greedily, '
+             f'{statistics["restarts"]} restarts',
+             f'time: {time["total"]:.3f} s total, {time["find_allocations"]:.3f} s finding '
+             f'allocations, {time["can_be_satisfied"]:.3f} s forward checking, '
+             f'{time["greedy"]:.3f} s greedy',
+             f'candidate allocations per object: '
+             f'{_format_histogram(statistics["candidate_counts"])}',
+             f'backtracking depths: {_format_histogram(statistics["backtrack_depths"])}']
+
+    exhausted = statistics['exhausted_objects'][:top]
+    if exhausted:
+        lines.append('objects that ran out of allocations most often:')
+        for index, count in exhausted:
+            obj = objects[index]
+            lines.append(f'  {count:10}  {getattr(obj, "path", index)} ({obj.actual_size} bytes)')
+
+    fragmentation = statistics['fragmentation']
+    if fragmentation:
+        lines.append('fragmentation (1 - largest block / free bytes):')
+        lines.append(f'  {"step":>10} {"blocks":>8} {"free":>10} {"largest":>10} fragmentation')
+        stride = max(1, len(fragmentation) // samples)
+        for sample in fragmentation[stride - 1::stride]:
+            capacity = sample['capacity']
+            ratio = 1 - sample['largest_block'] / capacity if capacity else 0
+            lines.append(f'  {sample["step"]:10} {sample["block_count"]:8} {capacity:10} '
+                         f'{sample["largest_block"]:10} {ratio:13.3f}')
+    return '\n'.join(lines)
+
+class PortfolioPacker(NativePacker):
+    """
+    Races greedy, backtracking and randomly restarting packers on several threads
+    and uses the first solution found.
+    """
+
+    def __init__(self, *, thread_count=0, time_limit=None):
+        super().__init__(_PortfolioPacker(), time_limit=time_limit)
+        self._packer.set_thread_count(thread_count)
+
+    @property
+    def winner(self):
+        return self._packer.winner
+
+class ExactPacker(NativePacker):
+    """
+    Packs objects by branch and bound, proving that they cannot be packed if
+    the search completes without a solution. This proof is not available when
+    objects have constraints relative to each other, since the search may miss
+    solutions then.
+    """
+
+    def __init__(self, *, time_limit=None):
+        super().__init__(_ExactPacker(), time_limit=time_limit)
+
+    @property
+    def proved_infeasible(self):
+        return self._packer.proved_infeasible
 
 class FreeBlock:
     @staticmethod
@@ -188,10 +353,28 @@ class FileLinkTarget(LinkTarget):
         self._f.seek(offset, 0)
         self._f.write(data)
 
-def _pack_with_fixed_offset(objects, target):
+def _fixed_target(obj, targets):
+    """
+    Returns the index of the target an object with a fixed offset lies in: the
+    one it was given, the only one its constraints allow or the only one there
+    is.
+    """
+    if obj.link_target is not None:
+        return obj.link_target
+    allowed = set(range(len(targets)))
+    for constraint in obj.constraints:
+        if isinstance(constraint, TargetConstraint):
+            allowed &= set(constraint.targets)
+    if len(allowed) != 1:
+        raise ValueError(f'object "{obj.path}" has a fixed offset, but its target is ambiguous')
+    return allowed.pop()
+
+def _pack_with_fixed_offset(objects, targets):
     remaining = []
     for obj in objects:
         if obj.link_offset is not None:
+            obj.link_target = _fixed_target(obj, targets)
+            target = targets[obj.link_target]
             target.allocate(obj)
             obj.link_address = target.address_map.map_to_target(
                 FileOffset(obj.link_offset))
@@ -201,23 +384,25 @@ def _pack_with_fixed_offset(objects, target):
 
 def pack_objects(objects, targets, *, packer=None):
     """
-    Pack the given objects into the free blocks of the given targets.
-    The objects may provide constraints.
+    Pack the given objects into the free blocks of the given targets, all at
+    once. The objects may provide constraints, including the targets they may
+    be linked into; each object's link_target is set to the index of the target
+    it was packed into.
     """
     if packer is None:
         packer = BacktrackingPacker()
     if not isinstance(targets, list):
         targets = [targets]
-    assert len(targets) == 1, "only one simultaneous target supported at the moment"
 
-    objects = _pack_with_fixed_offset(objects, targets[0])
-    packer.pack(objects, targets[0].free_blocks)
+    objects = _pack_with_fixed_offset(objects, targets)
+    packer.pack(objects, targets)
 
 def resolve_references(objects):
     """
     Resolve any unresolved references within the given objects.
     All referenced data paths need to have a corresponding object that has a
-    link_address specified.
+    link_address specified. References resolve to that address whichever
+    target the object was linked into.
     """
     link_addresses = {}
     for obj in objects:
@@ -229,10 +414,18 @@ def resolve_references(objects):
 
 def update_targets(objects, targets):
     """
-    Write the contents of the given objects into the allocated blocks of the given
-    targets.
+    Write the contents of the given objects into the allocated blocks of the
+    targets they were linked into.
     """
     if not isinstance(targets, list):
         targets = [targets]
-    assert len(targets) == 1, "only one simultaneous target supported at the moment"
-    targets[0].apply(objects)
\ No newline at end of file
+    grouped = [[] for _ in targets]
+    for obj in objects:
+        index = obj.link_target
+        if index is None:
+            if len(targets) != 1:
+                raise ValueError(f'object "{obj.path}" has no link target')
+            index = 0
+        grouped[index].append(obj)
+    for target, target_objects in zip(targets, grouped):
+        target.apply(target_objects)
\ No newline at end of file
@@ -85,6 +85,75 @@ class AddressRangeConstraint(Constraint):
             'upper': str(self.upper),
         }
 
+class SegmentConstraint(Constraint):
+    """
+    The object lies within the segment containing the given address, segments
+    being aligned ranges of the given size.
+    """
+
+    def __init__(self, address, segment_size):
+        self.address = address
+        self.segment_size = segment_size
+
+    def to_dict(self):
+        return {
+            'kind': 'segment',
+            'address': str(self.address),
+            'segment_size': self.segment_size,
+        }
+
+class TargetConstraint(Constraint):
+    """
+    The object is linked into one of the given targets, given by their indices
+    in the list of targets that the objects are packed into.
+    """
+
+    def __init__(self, targets):
+        self.targets = sorted(set(targets))
+        if not self.targets:
+            raise ValueError('an object must be allowed in at least one target')
+
+    def to_dict(self):
+        return {
+            'kind': 'targets',
+            'targets': self.targets,
+        }
+
+class SameSegmentConstraint(Constraint):
+    """
+    The object lies within the same segment as another object.
+    """
+
+    def __init__(self, other, segment_size):
+        self.other = other
+        self.segment_size = segment_size
+
+    def to_dict(self):
+        return {
+            'kind': 'same_segment',
+            'other': str(self.other.path),
+            'segment_size': self.segment_size,
+        }
+
+class RelativeRangeConstraint(Constraint):
+    """
+    The object's address minus the other object's address lies within
+    [minimum, maximum].
+    """
+
+    def __init__(self, other, minimum, maximum):
+        self.other = other
+        self.minimum = minimum
+        self.maximum = maximum
+
+    def to_dict(self):
+        return {
+            'kind': 'relative_range',
+            'other': str(self.other.path),
+            'minimum': self.minimum,
+            'maximum': self.maximum,
+        }
+
 class BinaryObject:
     @staticmethod
     def from_buffer(path, buffer):
@@ -101,6 +170,8 @@ class BinaryObject:
         self.alignment = alignment
         self.link_offset = None
         self.link_address = None
+        # the index of the target the object is linked into
+        self.link_target = None
         self.constraints = []
 
         if fixed_offset is not None and fixed_address is not None:
@@ -193,6 +264,8 @@ class BinaryObject:
             as_dict['link_offset'] = self.link_offset
         if self.link_address is not None:
             as_dict['link_address'] = str(self.link_address)
+        if self.link_target is not None:
+            as_dict['link_target'] = self.link_target
         if constraints:
             as_dict['constraints'] = constraints
         if len(sections) > 1:
@@ -0,0 +1,142 @@
+"""
+Reads the traces that BacktrackingPacker records with trace=..., and prints
+them or a summary of them:
+
+    python -m kaizo.data.packingtrace packing.trace [--events]
+"""
+
+from collections import Counter
+from enum import IntEnum
+import struct
+import sys
+
+MAGIC = b'KZPTRACE'
+VERSION = 1
+NO_OBJECT = 0xFFFFFFFF
+# time and value, object index, kind followed by three zero bytes
+EVENT = struct.Struct('<QQII')
+
+class EventKind(IntEnum):
+    START = 0
+    ALLOCATED = 1
+    REJECTED = 2
+    DEALLOCATED = 3
+    BACKTRACKED = 4
+    SOLVED = 5
+    EXHAUSTED = 6
+    STOPPED = 7
+    NO_SPACE = 8
+    DROPPED = 9
+
+OUTCOMES = (EventKind.SOLVED, EventKind.EXHAUSTED, EventKind.STOPPED, EventKind.NO_SPACE)
+
+class TraceObject:
+    def __init__(self, id, size):
+        self.id = id
+        self.size = size
+
+class TraceEvent:
+    def __init__(self, time, kind, object, value):
+        """
+        Stores an event, which happened the given number of nanoseconds after
+        packing started; object is None for events without an object.
+        """
+        self.time = time
+        self.kind = kind
+        self.object = object
+        self.value = value
+
+    def __str__(self):
+        text = f'{self.time / 1e6:12.3f} ms  {self.kind.name.lower()}'
+        if self.object is not None:
+            text += f' {self.object.id} ({self.object.size} bytes)'
+        if self.kind in (EventKind.ALLOCATED, EventKind.REJECTED):
+            text += f' at offset {self.value:#x}'
+        elif self.kind != EventKind.DEALLOCATED and self.value:
+            text += f' {self.value}'
+        return text
+
+class PackingTrace:
+    def __init__(self, path):
+        """
+        Reads the free blocks and the objects of the trace; the events are only
+        read by events(), since there can be billions of them.
+        """
+        self.path = path
+        with open(path, 'rb') as file:
+            if file.read(8) != MAGIC:
+                raise ValueError(f'{path} is not a packing trace')
+            version, level, block_count = struct.unpack('<III', file.read(12))
+            if version != VERSION:
+                raise ValueError(f'{path} has unsupported version {version}')
+            self.level = level
+            self.free_blocks = [struct.unpack('<QQ', file.read(16)) for _ in range(block_count)]
+            object_count, = struct.unpack('<I', file.read(4))
+            self.objects = []
+            for _ in range(object_count):
+                size, length = struct.unpack('<QI', file.read(12))
+                id = file.read(length).decode('utf-8', errors='replace')
+                self.objects.append(TraceObject(id, size))
+            self._events_offset = file.tell()
+
+    def events(self):
+        event_size = EVENT.size
+        with open(self.path, 'rb') as file:
+            file.seek(self._events_offset)
+            while chunk := file.read(event_size * 65536):
+                chunk = chunk[:len(chunk) - len(chunk) % event_size]
+                for time, value, index, kind in EVENT.iter_unpack(chunk):
+                    object = None if index == NO_OBJECT else self.objects[index]
+                    yield TraceEvent(time, EventKind(kind), object, value)
+
+    def summary(self, top=10):
+        """
+        Returns a text with the number of events of every kind, the outcome and
+        the objects that were deallocated most often.
+        """
+        kinds = Counter()
+        deallocated = Counter()
+        depth = 0
+        duration = 0
+        outcome = None
+        dropped = 0
+        for event in self.events():
+            kinds[event.kind] += 1
+            duration = event.time
+            if event.kind == EventKind.DEALLOCATED:
+                deallocated[event.object] += 1
+            elif event.kind == EventKind.BACKTRACKED:
+                depth = max(depth, event.value)
+            elif event.kind in OUTCOMES:
+                outcome = event.kind
+            elif event.kind == EventKind.DROPPED:
+                dropped += event.value
+
+        lines = [f'{len(self.objects)} objects, {sum(o.size for o in self.objects)} bytes',
+                 f'{len(self.free_blocks)} free blocks, '
+                 f'{sum(size for _, size in self.free_blocks)} bytes',
+                 f'{sum(kinds.values())} events in {duration / 1e6:.3f} ms']
+        for kind in EventKind:
+            if kinds[kind] > 0:
+                lines.append(f'  {kind.name.lower():12} {kinds[kind]}')
+        if depth > 0:
+            lines.append(f'deepest backtracking to depth {depth}')
+        if outcome is not None:
+            lines.append(f'outcome: {outcome.name.lower()}')
+        if dropped > 0:
+            lines.append(f'{dropped} events were dropped because the writer fell behind')
+        if deallocated:
+            lines.append('most deallocated objects:')
+            for object, count in deallocated.most_common(top):
+                lines.append(f'  {count:8}  {object.id} ({object.size} bytes)')
+        return '\n'.join(lines)
+
+if __name__ == '__main__':
+    if len(sys.argv) < 2:
+        sys.exit(f'usage: {sys.argv[0]} TRACE [--events]')
+    trace = PackingTrace(sys.argv[1])
+    if '--events' in sys.argv[2:]:
+        for event in trace.events():
+            print(event)
+    else:
+        print(trace.summary())
@@ -1,4 +1,4 @@
-from kaizo.kaizopy import _DataReader, _DataWriter
+from kaizo.kaizopy import _DataReader, _DataWriter, _load_objects
 from kaizo.data.objects import BinaryObject, UnresolvedReference, ObjectSection
 from kaizo.addresses import AddressLayout
 
@@ -51,3 +51,12 @@ class DataWriter:
     def assemble(self):
         object_dicts = self._writer.assemble()
         return _make_objects(object_dicts)
+
+    def save(self, filename):
+        """Saves the assembled objects in kaizo's native object file format, which load_objects
+        reads without parsing."""
+        self._writer.save(str(filename))
+
+def load_objects(filename):
+    """Loads the objects saved by DataWriter.save."""
+    return _make_objects(_load_objects(str(filename)))
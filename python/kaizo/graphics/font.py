@@ -1,8 +1,8 @@
+from kaizo.kaizopy import _Font, _FontWriter, _FontAnchor
 from kaizo.graphics.tile import Tile, Image
 from pathlib import PurePath, Path
 import json
 from enum import Enum
-from bdflib import reader as bdfreader
 
 def _build_font(description, directory):
     metrics = description['metrics']
@@ -46,12 +46,8 @@ def _load_json_font(path):
         description = json.load(f)
         return _build_font(description, directory)
 
-def _load_bdf_font(path):
-    with open(path, 'rb') as f:
-        font = bdfreader.read_bdf(f)
-        #ascent, descent = font[b'FONT_ASCENT'], font[b'FONT_DESCENT']
-        for glyph in font.glyphs():
-            bitmap = glyph.bitmap
+def _load_bdf_font(path, bits_per_pixel=4, ramp=None):
+    return BitmapFont._from_native(_Font.load_bdf(str(path), bits_per_pixel, ramp or []))
 
 class BitmapGlyph:
     def __init__(self, characters, tile, baseline, xoffset=0, bgcolor=0, advance_width=None):
@@ -98,15 +94,27 @@ class BitmapGlyph:
 
 class BitmapFont:
     @staticmethod
-    def load(filename):
+    def load(filename, **kwargs):
         path = PurePath(filename)
         if path.suffix == '.json':
             return _load_json_font(path)
         elif path.suffix == '.bdf':
-            return _load_bdf_font(path)
+            return _load_bdf_font(path, **kwargs)
         else:
             raise ValueError('unsupported bitmap font description file')
 
+    @classmethod
+    def _from_native(cls, _font):
+        font = cls(lineheight=_font.line_height, baseline=_font.baseline,
+                   bpp=_font.pixel_format.bits_per_pixel, bgcolor=_font.background_color)
+        for index in range(_font.glyph_count):
+            _glyph = _font.glyph(index)
+            font.append_glyph(BitmapGlyph(_glyph.characters, Tile._make(_glyph.tile),
+                                          _glyph.baseline, xoffset=_glyph.xoffset,
+                                          advance_width=_glyph.advance_width))
+        font._font = _font
+        return font
+
     def __init__(self, lineheight, baseline, bpp=32, bgcolor=0):
         if lineheight <= 0:
             raise ValueError('the lineheight of a BitmapFont must be positive')
@@ -117,10 +125,27 @@ class BitmapFont:
         self.bpp = bpp
         self.bgcolor = bgcolor
         self.glyphs = []
+        self._font = None
 
     def append_glyph(self, glyph):
         glyph.bgcolor = self.bgcolor
         self.glyphs.append(glyph)
+        self._font = None
+
+    def _native(self):
+        if self._font is None:
+            self._font = _Font()
+            self._font.set_metrics(self.lineheight, self.baseline)
+            self._font.background_color = self.bgcolor
+            if self.glyphs:
+                self._font.pixel_format = self.glyphs[0].tile._tile.format
+            for glyph in self.glyphs:
+                self._font.add_glyph(glyph.characters, glyph.tile._tile, glyph.baseline,
+                                     glyph.xoffset, glyph.advance_width)
+        return self._font
+
+    def pack(self, format, width, height):
+        return self._native().pack(format._format, width, height)
 
     def glyph_count(self):
         return len(self.glyphs)
@@ -161,8 +186,16 @@ class VerticalAnchor(Enum):
     BOTTOM = 2
 
 class BitmapFontWriter:
+    _ANCHORS = {
+        VerticalAnchor.TOP: _FontAnchor.TOP_LEFT,
+        VerticalAnchor.BASELINE: _FontAnchor.BASELINE_LEFT,
+        # a bottom anchor puts the baseline one line height above y, unlike the native one
+        VerticalAnchor.BOTTOM: _FontAnchor.BASELINE_LEFT,
+    }
+
     def __init__(self):
         self.vertical_anchor = VerticalAnchor.BASELINE
+        self._writer = _FontWriter()
 
     def set_font(self, font):
         self.font = font
@@ -170,21 +203,23 @@ class BitmapFontWriter:
     def set_anchor(self, anchor):
         self.vertical_anchor = anchor
 
+    def _native(self):
+        self._writer.set_font(self.font._native())
+        return self._writer
+
     def write(self, text, canvas, x, y):
-        if self.vertical_anchor == VerticalAnchor.TOP:
-            y += self.font.baseline
-        elif self.vertical_anchor == VerticalAnchor.BOTTOM:
+        if self.vertical_anchor == VerticalAnchor.BOTTOM:
             y -= self.font.lineheight
+        try:
+            self._native().write(text, canvas._tile, x, y, self._ANCHORS[self.vertical_anchor])
+        except RuntimeError as error:
+            raise ValueError(str(error)) from None
+
+    def width(self, text):
+        return self._native().width(text)
+
+    def render(self, text):
+        return Tile._make(self._native().render(text))
 
-        glyphs = self.font.to_glyphs(text)
-        for glyph in glyphs:
-            #self._write_glyph(glyph, canvas, x, y - glyph.ascent)
-            canvas.blit(glyph.tile, x, y - glyph.ascent, glyph.bgcolor)
-            x += glyph.advance_width
-
-    def _write_glyph(self, glyph, canvas, x, y):
-            for gy in range(glyph.height):
-                for gx in range(glyph.width):
-                    if glyph.tile.get_pixel(gx, gy) != glyph.bgcolor:
-                        print(x + gx, y + gy, glyph.tile.get_pixel(gx, gy))
-                        canvas.set_pixel(x + gx, y + gy, glyph.tile.get_pixel(gx, gy))
+    def render_all(self, texts):
+        return [Tile._make(_tile) for _tile in self._native().render_all(list(texts))]
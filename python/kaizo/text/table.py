@@ -1,4 +1,4 @@
-from kaizo.kaizopy import _Table, _TableEncoding
+from kaizo.kaizopy import _Table, _TableEncoding, _TableUsage
 from kaizo.text.encoding import ExtensionTextEncoding
 from enum import Enum
 
@@ -216,4 +216,28 @@ class TableEncoding(ExtensionTextEncoding):
             decoder, encoder = hook
             self._encoding.add_hook(name, decoder, encoder)
         else:
-            raise ValueError('invalid hook handler')
\ No newline at end of file
+            raise ValueError('invalid hook handler')
+
+class TableUsage:
+    def __init__(self, table):
+        self._usage = _TableUsage(table._table)
+
+    def analyze(self, corpus, threads=0):
+        self._usage.set_thread_count(threads)
+        self._usage.analyze(list(corpus))
+
+    def histogram(self):
+        return self._usage.histogram()
+
+    def remapping(self):
+        return self._usage.remapping()
+
+    def remap(self, binary):
+        return self._usage.remap(binary)
+
+    def subset_table(self):
+        return Table(self._usage.make_subset_table())
+
+    def subset_font(self, font):
+        from kaizo.graphics.font import BitmapFont
+        return BitmapFont._from_native(font._native().subset(self._usage.used_texts()))
@@ -3,6 +3,7 @@
 #include <kaizo/data/DataReader.h>
 #include <kaizo/data/DataWriter.h>
 #include <kaizo/data/objects/AnnotatedBinary.h>
+#include <kaizo/data/objects/AnnotatedBinaryFile.h>
 #include <kaizo/data/objects/Object.h>
 #include <kaizo/data/objects/UnresolvedReference.h>
 
@@ -81,6 +82,72 @@ static auto DataWriter_assemble(DataWriter& writer) -> py::list
     return convert(binary);
 }
 
+static void DataWriter_save(DataWriter& writer, const std::string& filename)
+{
+    auto const binary = writer.assemble();
+    AnnotatedBinaryFile::save(binary, filename);
+}
+
+// builds the same dictionaries as DataWriter_assemble, directly from the file's mapping
+static auto load_objects(const std::string& filename) -> py::list
+{
+    AnnotatedBinaryFile file{filename};
+    std::vector<py::object> layouts;
+    for (size_t i = 0; i < file.layoutCount(); ++i)
+    {
+        layouts.push_back(py::cast(file.makeLayout(i)));
+    }
+
+    py::list list(file.objectCount());
+    for (size_t i = 0; i < file.objectCount(); ++i)
+    {
+        auto const& object = file.object(i);
+        py::dict dict;
+        dict["path"] = py::str(file.path(object).data(), file.path(object).size());
+        if (object.hasFixedOffset)
+        {
+            dict["fixed_offset"] = object.fixedOffset;
+        }
+        if (object.alignment != 1)
+        {
+            dict["alignment"] = object.alignment;
+        }
+        dict["actual_size"] = object.realSize;
+
+        auto const references = file.references(object);
+        py::list unresolved(references.size());
+        for (size_t j = 0; j < references.size(); ++j)
+        {
+            py::dict reference;
+            reference["offset"] = references[j].offset;
+            reference["path"] =
+                py::str(file.path(references[j]).data(), file.path(references[j]).size());
+            reference["layout"] = layouts[references[j].layout];
+            unresolved[j] = reference;
+        }
+        dict["unresolved"] = unresolved;
+
+        auto const sections = file.sections(object);
+        py::list pySections(sections.size());
+        for (size_t j = 0; j < sections.size(); ++j)
+        {
+            py::dict section;
+            section["offset"] = sections[j].offset;
+            section["actual_offset"] = sections[j].realOffset;
+            section["size"] = sections[j].size;
+            pySections[j] = section;
+        }
+        dict["sections"] = pySections;
+
+        auto const binary = file.binary(object);
+        PyObject* pyBinary = PyByteArray_FromStringAndSize(
+            reinterpret_cast<const char*>(binary.data()), binary.size());
+        dict["binary"] = py::reinterpret_steal<py::object>(pyBinary);
+        list[i] = dict;
+    }
+    return list;
+}
+
 auto DataReader_init(py::buffer b) -> DataReader*
 {
     auto const view = requestReadOnly(b);
@@ -95,7 +162,11 @@ void registerKaizoData(pybind11::module_& m)
         .def("set_address_map",
              [](DataReader& reader, const AddressMap& map) { reader.setAddressMap(map.copy()); });
 
-    py::class_<DataWriter>(m, "_DataWriter").def(py::init()).def("assemble", &DataWriter_assemble);
+    py::class_<DataWriter>(m, "_DataWriter")
+        .def(py::init())
+        .def("assemble", &DataWriter_assemble)
+        .def("save", &DataWriter_save);
+    m.def("_load_objects", &load_objects);
 
     registerKaizoDataFormats(m);
     registerKaizoDataLinking(m);
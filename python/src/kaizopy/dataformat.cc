@@ -1,8 +1,10 @@
 #include <kaizo/addresses/AddressFormat.h>
 #include <kaizo/addresses/AddressLayout.h>
+#include <kaizo/data/DataQuery.h>
 #include <kaizo/data/DataReader.h>
 #include <kaizo/data/DataWriter.h>
 #include <kaizo/data/data/ArrayData.h>
+#include <kaizo/data/data/ColumnarData.h>
 #include <kaizo/data/data/Data.h>
 #include <kaizo/data/data/IntegerData.h>
 #include <kaizo/data/data/NullData.h>
@@ -10,8 +12,11 @@
 #include <kaizo/data/data/ReferenceData.h>
 #include <kaizo/data/data/StringData.h>
 #include <kaizo/data/formats/ArrayFormat.h>
+#include <kaizo/data/formats/CompiledFormat.h>
+#include <kaizo/data/formats/CompressedFormat.h>
 #include <kaizo/data/formats/DataFormat.h>
 #include <kaizo/data/formats/IntegerFormat.h>
+#include <kaizo/data/formats/LazyArray.h>
 #include <kaizo/data/formats/PointerFormat.h>
 #include <kaizo/data/formats/RecordFormat.h>
 #include <kaizo/data/formats/StringFormat.h>
@@ -72,6 +77,7 @@ static auto convert(const Data& data) -> py::object
     case DataType::String: return convert(static_cast<const StringData&>(data));
     case DataType::Array: return convert(static_cast<const ArrayData&>(data));
     case DataType::Record: return convert(static_cast<const RecordData&>(data));
+    case DataType::Columnar: return convert(*static_cast<const ColumnarData&>(data).toArray());
     case DataType::Null: return py::none();
     default: throw std::runtime_error{"unsupported data type: " + toString(data.type())};
     }
@@ -150,6 +156,10 @@ static auto convert(py::object object) -> std::unique_ptr<Data>
     {
         return py::cast<ReferenceData*>(object)->copy();
     }
+    else if (py::isinstance<ColumnarData>(object))
+    {
+        return py::cast<ColumnarData*>(object)->copy();
+    }
     else if (py::isinstance<py::sequence>(object))
     {
         return convertList(py::reinterpret_borrow<py::sequence>(object));
@@ -168,6 +178,58 @@ static auto convert(py::object object) -> std::unique_ptr<Data>
     }
 }
 
+static auto DataFormat_decode(DataFormat& format, DataReader& reader) -> py::object
+{
+    std::unique_ptr<Data> data;
+    {
+        // decoding may run on several threads, which must be able to call back into Python
+        py::gil_scoped_release release;
+        data = format.decode(reader);
+    }
+    // Python gets its own objects, so the decoded data and its arena are released right away
+    return convert(*data);
+}
+
+static auto DataFormat_query(DataFormat& format, DataReader& reader, py::list patterns) -> py::list
+{
+    DataQuery query;
+    for (auto const& pattern : patterns)
+    {
+        auto const maybePath = DataPath::fromString(pattern.cast<std::string>());
+        if (!maybePath)
+        {
+            throw py::value_error("invalid data path");
+        }
+        try
+        {
+            query.add(*maybePath);
+        }
+        catch (std::exception& e)
+        {
+            throw py::value_error{e.what()};
+        }
+    }
+
+    std::unique_ptr<Data> data;
+    {
+        py::gil_scoped_release release;
+        data = format.decode(reader);
+    }
+
+    // only the matched elements are converted to Python objects
+    py::list results;
+    for (auto const& matches : query.run(*data))
+    {
+        py::list list;
+        for (auto const& match : matches)
+        {
+            list.append(py::make_tuple(match.path.toString(), convert(*match.data)));
+        }
+        results.append(list);
+    }
+    return results;
+}
+
 static auto DataFormat_encode(DataFormat& format, DataWriter& writer, py::object data,
                               const std::string& path)
 {
@@ -189,6 +251,150 @@ static auto DataFormat_encode(DataFormat& format, DataWriter& writer, py::object
     }
 }
 
+class PythonObjectBuilder
+{
+public:
+    void signedInteger(int64_t value)
+    {
+        emit(py::int_(value));
+    }
+
+    void unsignedInteger(uint64_t value)
+    {
+        emit(py::int_(value));
+    }
+
+    void beginRecord()
+    {
+        m_stack.push_back(Frame{py::dict(), nullptr});
+    }
+
+    void field(const std::string& name)
+    {
+        m_stack.back().field = &name;
+    }
+
+    void endRecord()
+    {
+        close();
+    }
+
+    void beginArray(size_t)
+    {
+        m_stack.push_back(Frame{py::list(), nullptr});
+    }
+
+    void endArray()
+    {
+        close();
+    }
+
+    auto result() -> py::object
+    {
+        return std::move(m_result);
+    }
+
+private:
+    void close()
+    {
+        auto object = std::move(m_stack.back().object);
+        m_stack.pop_back();
+        emit(std::move(object));
+    }
+
+    void emit(py::object&& object)
+    {
+        if (m_stack.empty())
+        {
+            m_result = std::move(object);
+        }
+        else if (auto& top = m_stack.back(); top.field)
+        {
+            top.object[py::str(*top.field)] = std::move(object);
+        }
+        else
+        {
+            top.object.cast<py::list>().append(std::move(object));
+        }
+    }
+
+    struct Frame
+    {
+        py::object object;
+        const std::string* field;
+    };
+
+    std::vector<Frame> m_stack;
+    py::object m_result;
+};
+
+static auto CompiledFormat_decode(const CompiledFormat& format, DataReader& reader) -> py::object
+{
+    PythonObjectBuilder builder;
+    reader.setOffset(format.run(reader.binary(), reader.offset(), builder));
+    return builder.result();
+}
+
+static auto ColumnarData_Column_buffer(const ColumnarData::Column& column) -> py::buffer_info
+{
+    std::string format;
+    switch (column.type())
+    {
+    case ColumnarData::ColumnType::Int32: format = py::format_descriptor<int32_t>::format(); break;
+    case ColumnarData::ColumnType::Int64: format = py::format_descriptor<int64_t>::format(); break;
+    case ColumnarData::ColumnType::UInt64: format = py::format_descriptor<uint64_t>::format(); break;
+    default: format = py::format_descriptor<uint32_t>::format(); break;
+    }
+    // string columns expose their offsets into the arena, including the final end offset
+    auto const size = column.isString() ? column.size() + 1 : column.size();
+    auto const elementSize = static_cast<py::ssize_t>(column.elementSize());
+    // the columns belong to the decoded data, so Python only gets a read-only view
+    return py::buffer_info(const_cast<void*>(column.data()), elementSize, format, 1, {size},
+                           {elementSize}, true);
+}
+
+static auto ColumnarData_Column_strings(const ColumnarData::Column& column) -> py::list
+{
+    if (!column.isString())
+    {
+        throw py::type_error{"not a string column"};
+    }
+    py::list strings(column.size());
+    for (auto i = 0U; i < column.size(); ++i)
+    {
+        strings[i] = py::str(column.string(i).data(), column.string(i).size());
+    }
+    return strings;
+}
+
+static auto ColumnarData_columnNames(const ColumnarData& data) -> std::vector<std::string>
+{
+    std::vector<std::string> names;
+    for (auto i = 0U; i < data.columnCount(); ++i)
+    {
+        names.push_back(data.column(i).name());
+    }
+    return names;
+}
+
+static auto ColumnarData_row(const ColumnarData& data, size_t index) -> py::object
+{
+    if (index >= data.rowCount())
+    {
+        throw py::index_error{"row index out of range"};
+    }
+    return convert(*data.row(index));
+}
+
+static auto LazyArray_getitem(LazyArray& array, size_t index) -> py::object
+{
+    if (index >= array.elementCount())
+    {
+        throw py::index_error{"array index out of range"};
+    }
+    return convert(array.element(index));
+}
+
 static auto ReferenceData_init(const std::string& path) -> std::unique_ptr<ReferenceData>
 {
     auto const maybePath = DataPath::fromString(path);
@@ -208,8 +414,8 @@ void registerKaizoDataFormats(py::module_& m)
         .def("set_fixed_offset", &DataFormat::setFixedOffset)
         .def("set_alignment", &DataFormat::setAlignment)
         .def("set_tag", &DataFormat::setTag)
-        .def("decode",
-             [](DataFormat& format, DataReader& reader) { return convert(*format.decode(reader)); })
+        .def("decode", &DataFormat_decode)
+        .def("query", &DataFormat_query)
         .def("encode", &DataFormat_encode);
 
     py::class_<IntegerFormat, DataFormat>(m, "_IntegerFormat")
@@ -225,9 +431,13 @@ void registerKaizoDataFormats(py::module_& m)
              [](ArrayFormat& format, const DataFormat& elementFormat) {
                  format.setElementFormat(elementFormat.copy());
              })
-        .def("set_fixed_length", [](ArrayFormat& format, const size_t length) {
-            format.setSizeProvider(std::make_unique<FixedSizeProvider>(length));
-        });
+        .def("set_fixed_length",
+             [](ArrayFormat& format, const size_t length) {
+                 format.setSizeProvider(std::make_unique<FixedSizeProvider>(length));
+             })
+        .def("set_thread_count", &ArrayFormat::setThreadCount)
+        .def("decode_columnar", &ArrayFormat::decodeColumnar)
+        .def("decode_lazy", &ArrayFormat::decodeLazy, py::keep_alive<0, 2>());
 
     py::class_<RecordFormat, DataFormat>(m, "_RecordFormat")
         .def(py::init())
@@ -249,5 +459,44 @@ void registerKaizoDataFormats(py::module_& m)
             format.setLayout(layout.copy());
         });
 
+    py::class_<CompressedFormat, DataFormat>(m, "_CompressedFormat")
+        .def(py::init())
+        .def("set_codec",
+             [](CompressedFormat& format, const Codec& codec) { format.setCodec(codec.copy()); })
+        .def("set_inner_format", [](CompressedFormat& format, const DataFormat& innerFormat) {
+            format.setInnerFormat(innerFormat.copy());
+        });
+
+    py::class_<CompiledFormat>(m, "_CompiledFormat")
+        .def_static("compile", &CompiledFormat::compile)
+        .def("decode", &CompiledFormat_decode)
+        .def_property_readonly("fixed_size", &CompiledFormat::fixedSize);
+
+    py::class_<ColumnarData::Column>(m, "_Column", py::buffer_protocol())
+        .def_buffer(&ColumnarData_Column_buffer)
+        .def_property_readonly("name", &ColumnarData::Column::name)
+        .def_property_readonly("is_string", &ColumnarData::Column::isString)
+        .def_property_readonly("is_signed", &ColumnarData::Column::isSigned)
+        .def_property_readonly("arena",
+                               [](const ColumnarData::Column& column) {
+                                   return py::bytes(column.arena());
+                               })
+        .def("strings", &ColumnarData_Column_strings)
+        .def("__len__", &ColumnarData::Column::size);
+
+    py::class_<ColumnarData>(m, "_ColumnarData")
+        .def_property_readonly("row_count", &ColumnarData::rowCount)
+        .def_property_readonly("column_names", &ColumnarData_columnNames)
+        .def("column",
+             py::overload_cast<const std::string&>(&ColumnarData::column, py::const_),
+             py::return_value_policy::reference_internal)
+        .def("row", &ColumnarData_row)
+        .def("to_list", [](const ColumnarData& data) { return convert(*data.toArray()); });
+
+    py::class_<LazyArray>(m, "_LazyArray")
+        .def("__len__", &LazyArray::elementCount)
+        .def("__getitem__", &LazyArray_getitem)
+        .def("is_decoded", &LazyArray::isDecoded);
+
     py::class_<ReferenceData>(m, "Reference").def(py::init(&ReferenceData_init));
 }
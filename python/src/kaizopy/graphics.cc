@@ -2,6 +2,10 @@
 #include <filesystem>
 #include <kaizo/graphics/ImageFileFormat.h>
 #include <kaizo/graphics/TileFormat.h>
+#include <kaizo/graphics/font/BdfFontImporter.h>
+#include <kaizo/graphics/font/Font.h>
+#include <kaizo/graphics/font/FontWriter.h>
+#include <kaizo/graphics/font/GlyphPacker.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <string>
@@ -110,6 +114,34 @@ static auto Tile_bounding_box(const Tile& tile, const Tile::pixel_t bgColor)
     return std::make_tuple(bbox.left(), bbox.top(), bbox.right(), bbox.bottom());
 }
 
+static void Font_set_metrics(Font& font, const size_t lineHeight, const size_t baseLine)
+{
+    font.setMetrics(Font::Metrics{lineHeight, baseLine});
+}
+
+static void Font_add_glyph(Font& font, const std::string& characters, const Tile& tile,
+                           const size_t baseline, const long long xOffset,
+                           const size_t advanceWidth)
+{
+    font.addGlyph(GlyphBuilder{}
+                      .characters(characters)
+                      .data(tile)
+                      .baseline(baseline)
+                      .background(font.backgroundColor())
+                      .xOffset(xOffset)
+                      .advanceWidth(advanceWidth)
+                      .build());
+}
+
+static auto Font_load_bdf(const std::string& filename, const unsigned bitsPerPixel,
+                          const std::vector<Tile::pixel_t>& ramp) -> Font
+{
+    BdfFontImporter importer;
+    importer.setBitsPerPixel(bitsPerPixel);
+    importer.setRamp(ramp);
+    return importer.load(filename);
+}
+
 void registerKaizoGraphics(py::module_& m)
 {
     py::class_<PixelFormat>(m, "_PixelFormat")
@@ -152,6 +184,51 @@ void registerKaizoGraphics(py::module_& m)
         .def("encoded_size", [](const TileFormat& format, const size_t count) {
             return format.requiredSize(count);
         });
+
+    py::class_<Font>(m, "_Font")
+        .def(py::init<>())
+        .def_static("load_bdf", &Font_load_bdf, py::call_guard<py::gil_scoped_release>())
+        .def("set_metrics", &Font_set_metrics)
+        .def("add_glyph", &Font_add_glyph)
+        .def("glyph", &Font::glyph, py::return_value_policy::reference_internal)
+        .def("pack", &packGlyphs, py::call_guard<py::gil_scoped_release>())
+        .def("subset", &Font::subset)
+        .def_property("background_color", &Font::backgroundColor, &Font::setBackgroundColor)
+        .def_property("pixel_format", &Font::pixelFormat, &Font::setPixelFormat)
+        .def_property_readonly("line_height", &Font::lineHeight)
+        .def_property_readonly("baseline", &Font::baseLine)
+        .def_property_readonly("glyph_count", &Font::glyphCount);
+
+    py::class_<Glyph>(m, "_Glyph")
+        .def_property_readonly("characters", &Glyph::characters)
+        .def_property_readonly("tile", &Glyph::tile)
+        .def_property_readonly("baseline", &Glyph::baseline)
+        .def_property_readonly("xoffset", &Glyph::xOffset)
+        .def_property_readonly("advance_width", &Glyph::advanceWidth);
+
+    py::enum_<FontWriter::Anchor>(m, "_FontAnchor")
+        .value("TOP_LEFT", FontWriter::Anchor::TopLeft)
+        .value("BASELINE_LEFT", FontWriter::Anchor::BaselineLeft)
+        .value("BOTTOM_LEFT", FontWriter::Anchor::BottomLeft)
+        .value("TOP_RIGHT", FontWriter::Anchor::TopRight)
+        .value("BASELINE_RIGHT", FontWriter::Anchor::BaselineRight)
+        .value("BOTTOM_RIGHT", FontWriter::Anchor::BottomRight);
+
+    py::class_<FontWriter>(m, "_FontWriter")
+        .def(py::init<>())
+        .def("set_font", &FontWriter::setFont, py::keep_alive<1, 2>())
+        .def("set_monospace", &FontWriter::setMonospace)
+        .def("set_proportional", &FontWriter::setProportional)
+        .def("set_thread_count", &FontWriter::setThreadCount)
+        .def("write", &FontWriter::write)
+        .def("width", static_cast<size_t (FontWriter::*)(const std::string&) const>(
+                          &FontWriter::width))
+        .def("render",
+             static_cast<Tile (FontWriter::*)(const std::string&) const>(&FontWriter::render))
+        .def("render_all",
+             static_cast<std::vector<Tile> (FontWriter::*)(const std::vector<std::string>&)
+                             const>(&FontWriter::renderAll),
+             py::call_guard<py::gil_scoped_release>());
 }
 
 /*
@@ -2,6 +2,7 @@
 #include "pyutilities.h"
 #include <kaizo/binary/Binary.h>
 #include <kaizo/binary/BinaryPatch.h>
+#include <kaizo/compression/Codec.h>
 #include <optional>
 #include <pybind11/pybind11.h>
 
@@ -24,6 +25,45 @@ static void BinaryPatch_apply(BinaryPatch& patch, py::buffer b, const size_t off
     patch.apply(view, offset);
 }
 
+static auto Codec_compress(const Codec& codec, py::buffer b) -> Binary
+{
+    auto const view = requestReadOnly(b);
+    py::gil_scoped_release release;
+    return codec.compress(view);
+}
+
+static auto Codec_decompress(const Codec& codec, py::buffer b) -> Binary
+{
+    auto const view = requestReadOnly(b);
+    py::gil_scoped_release release;
+    return codec.decompress(view).first;
+}
+
+static auto Codec_compressAll(const Codec& codec, py::list buffers, const size_t threadCount)
+    -> py::list
+{
+    std::vector<py::buffer> keepAlive;
+    std::vector<BinaryView> views;
+    for (auto buffer : buffers)
+    {
+        auto& b = keepAlive.emplace_back(py::reinterpret_borrow<py::buffer>(buffer));
+        views.push_back(requestReadOnly(b));
+    }
+
+    std::vector<Binary> compressed;
+    {
+        py::gil_scoped_release release;
+        compressed = codec.compressAll(views, threadCount);
+    }
+
+    py::list result;
+    for (auto& binary : compressed)
+    {
+        result.append(py::cast(std::move(binary)));
+    }
+    return result;
+}
+
 PYBIND11_MODULE(kaizopy, m)
 {
     m.doc() = "ROM hacking tools";
@@ -61,6 +101,19 @@ PYBIND11_MODULE(kaizopy, m)
         .value("BIG", Endianness::Big)
         .export_values();
 
+    py::enum_<CompressionLevel>(m, "CompressionLevel")
+        .value("FAST", CompressionLevel::Fast)
+        .value("OPTIMAL", CompressionLevel::Optimal)
+        .export_values();
+
+    py::class_<Codec>(m, "Codec")
+        .def(py::init(&makeCodec))
+        .def_property("level", &Codec::level, &Codec::setLevel)
+        .def_property("thread_count", &Codec::threadCount, &Codec::setThreadCount)
+        .def("compress", &Codec_compress)
+        .def("decompress", &Codec_decompress)
+        .def("compress_all", &Codec_compressAll, py::arg("buffers"), py::arg("thread_count") = 0);
+
     registerKaizoAddresses(m);
     registerKaizoData(m);
     registerKaizoGraphics(m);
@@ -1,13 +1,18 @@
 #include <kaizo/addresses/Address.h>
 #include <kaizo/data/linking/Backtracker.h>
+#include <kaizo/data/linking/ExactPacker.h>
+#include <kaizo/data/linking/FreeSpace.h>
+#include <kaizo/data/linking/PortfolioPacker.h>
+#include <chrono>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <unordered_map>
 
 namespace py = pybind11;
 using namespace kaizo;
 using namespace kaizo::data;
 
-static auto BacktrackingPacker_get_link_offset(const BacktrackingPacker& packer, const size_t index)
-    -> size_t
+static auto Packer_get_link_offset(const Packer& packer, const size_t index) -> size_t
 {
     if (index >= packer.objectCount())
     {
@@ -21,8 +26,7 @@ static auto BacktrackingPacker_get_link_offset(const BacktrackingPacker& packer,
     return object.allocation().offset;
 }
 
-static auto BacktrackingPacker_get_link_address(const BacktrackingPacker& packer,
-                                                const size_t index) -> Address
+static auto Packer_get_link_address(const Packer& packer, const size_t index) -> Address
 {
     if (index >= packer.objectCount())
     {
@@ -36,24 +40,210 @@ static auto BacktrackingPacker_get_link_address(const BacktrackingPacker& packer
     return object.allocation().address;
 }
 
+static auto Packer_get_link_target(const Packer& packer, const size_t index) -> size_t
+{
+    if (index >= packer.objectCount())
+    {
+        throw py::index_error{"object index " + std::to_string(index) + " is out of range"};
+    }
+    auto const& object = *packer.object(index);
+    if (!object.hasAllocation())
+    {
+        throw py::value_error{"object has no allocated target"};
+    }
+    return object.allocation().target;
+}
+
+static auto Packer_get_object(Packer& packer, const size_t index) -> LinkObject&
+{
+    if (index >= packer.objectCount())
+    {
+        throw py::index_error{"object index " + std::to_string(index) + " is out of range"};
+    }
+    return *packer.object(index);
+}
+
+static auto FreeSpace_blocks(const FreeSpace& space) -> py::list
+{
+    py::list blocks;
+    for (size_t i = 0; i < space.blockCount(); ++i)
+    {
+        auto const& block = space.block(i);
+        blocks.append(py::make_tuple(block.target(), block.offset(), block.size()));
+    }
+    return blocks;
+}
+
+static auto seconds(std::chrono::nanoseconds duration) -> double
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+static auto BacktrackingPacker_statistics(const BacktrackingPacker& packer) -> py::dict
+{
+    auto const& statistics = packer.statistics();
+    std::unordered_map<const LinkObject*, size_t> indices;
+    for (size_t i = 0; i < packer.objectCount(); ++i)
+    {
+        indices[packer.object(i)] = i;
+    }
+
+    py::dict dict;
+    dict["steps"] = statistics.steps;
+    dict["rejections"] = statistics.rejections;
+    dict["backtracks"] = statistics.backtracks;
+    dict["maximum_depth"] = statistics.maximumDepth;
+    dict["greedy_allocations"] = statistics.greedyAllocations;
+    dict["restarts"] = statistics.restarts;
+    dict["candidate_counts"] = statistics.candidateCounts.buckets();
+    dict["backtrack_depths"] = statistics.backtrackDepths.buckets();
+
+    py::dict time;
+    time["total"] = seconds(statistics.totalTime);
+    time["find_allocations"] = seconds(statistics.findAllocationsTime);
+    time["can_be_satisfied"] = seconds(statistics.canBeSatisfiedTime);
+    time["greedy"] = seconds(statistics.greedyTime);
+    dict["time"] = time;
+
+    // (object index, count), most often first
+    py::list exhausted;
+    for (auto const& [object, count] :
+         statistics.mostExhaustedObjects(statistics.exhaustedObjects.size()))
+    {
+        exhausted.append(py::make_tuple(indices.at(object), count));
+    }
+    dict["exhausted_objects"] = exhausted;
+
+    py::list fragmentation;
+    for (auto const& sample : statistics.fragmentation)
+    {
+        py::dict entry;
+        entry["step"] = sample.step;
+        entry["block_count"] = sample.blockCount;
+        entry["capacity"] = sample.capacity;
+        entry["largest_block"] = sample.largestBlock;
+        fragmentation.append(entry);
+    }
+    dict["fragmentation"] = fragmentation;
+    return dict;
+}
+
 void registerKaizoDataLinking(pybind11::module_& m)
 {
-    py::class_<BacktrackingPacker>(m, "_BacktrackingPacker")
+    py::class_<FreeSpace>(m, "_FreeSpace")
         .def(py::init())
+        .def("add_block",
+             [](FreeSpace& space, const size_t offset, const Address& address, const size_t size,
+                const size_t target) {
+                 if (target >= MaximumTargetCount)
+                 {
+                     throw py::value_error{"there can be at most " +
+                                           std::to_string(MaximumTargetCount) + " targets"};
+                 }
+                 space.addBlock(FreeBlock{offset, address, size, target});
+             },
+             py::arg("offset"), py::arg("address"), py::arg("size"), py::arg("target") = 0)
+        .def("allocate_range", &FreeSpace::allocateRange)
+        .def("deallocate_last", &FreeSpace::deallocateLast)
+        .def_property_readonly("capacity", &FreeSpace::capacity)
+        .def_property_readonly("allocation_count", &FreeSpace::allocationCount)
+        .def_property_readonly("blocks", &FreeSpace_blocks);
+
+    py::class_<Packer>(m, "_Packer")
         .def("add_object",
-             [](BacktrackingPacker& packer, const size_t size) {
+             [](Packer& packer, const size_t size, const size_t alignment) {
                  auto const id = "obj_" + std::to_string(packer.objectCount());
-                 packer.addObject(std::make_unique<LinkObject>(id, static_cast<size_t>(size)));
-             })
+                 auto object = std::make_unique<LinkObject>(id, static_cast<size_t>(size));
+                 if (alignment > 1)
+                 {
+                     object->constrain(std::make_unique<AlignmentConstraint>(alignment));
+                 }
+                 packer.addObject(std::move(object));
+             },
+             py::arg("size"), py::arg("alignment") = 1)
         .def("add_free_block",
-             [](BacktrackingPacker& packer, const size_t offset, const Address& address,
-                const size_t size) {
-                 packer.addFreeBlock(FreeBlock{offset, address, size});
-             })
-        .def("pack", &BacktrackingPacker::pack)
-        .def("get_link_offset", &BacktrackingPacker_get_link_offset)
-        .def("get_link_address", &BacktrackingPacker_get_link_address)
-        .def("set_log_file", [](BacktrackingPacker& packer, const std::string& filename) {
-            packer.setLogFile(filename);
-        });
+             [](Packer& packer, const size_t offset, const Address& address, const size_t size,
+                const size_t target) {
+                 if (target >= MaximumTargetCount)
+                 {
+                     throw py::value_error{"there can be at most " +
+                                           std::to_string(MaximumTargetCount) + " targets"};
+                 }
+                 packer.addFreeBlock(FreeBlock{offset, address, size, target});
+             },
+             py::arg("offset"), py::arg("address"), py::arg("size"), py::arg("target") = 0)
+        .def("constrain_fixed_address",
+             [](Packer& packer, const size_t index, const Address& address) {
+                 Packer_get_object(packer, index).setFixedAddress(address);
+             })
+        .def("constrain_address_range",
+             [](Packer& packer, const size_t index, const Address& lower,
+                const Address& upper) {
+                 Packer_get_object(packer, index)
+                     .constrain(std::make_unique<AddressRangeConstraint>(lower, upper));
+             })
+        .def("constrain_segment",
+             [](Packer& packer, const size_t index, const Address& address,
+                const size_t segmentSize) {
+                 Packer_get_object(packer, index)
+                     .constrain(std::make_unique<SegmentConstraint>(address, segmentSize));
+             })
+        .def("constrain_targets",
+             [](Packer& packer, const size_t index, const uint64_t targets) {
+                 if (targets == 0)
+                 {
+                     throw py::value_error{"object must be allowed in at least one target"};
+                 }
+                 Packer_get_object(packer, index)
+                     .constrain(std::make_unique<TargetConstraint>(targets));
+             })
+        .def("constrain_same_segment",
+             [](Packer& packer, const size_t index, const size_t other,
+                const size_t segmentSize) {
+                 Packer_get_object(packer, index)
+                     .constrainSameSegment(Packer_get_object(packer, other), segmentSize);
+             })
+        .def("constrain_relative_range",
+             [](Packer& packer, const size_t index, const size_t other,
+                const int64_t minimum, const int64_t maximum) {
+                 Packer_get_object(packer, index)
+                     .constrainRelative(Packer_get_object(packer, other), minimum, maximum);
+             })
+        .def("set_time_limit",
+             [](Packer& packer, const double seconds) {
+                 auto const milliseconds = static_cast<long long>(seconds * 1000);
+                 packer.setTimeLimit(std::chrono::milliseconds{milliseconds});
+             })
+        .def("pack",
+             [](Packer& packer) {
+                 py::gil_scoped_release release;
+                 return packer.pack();
+             })
+        .def("get_link_offset", &Packer_get_link_offset)
+        .def("get_link_address", &Packer_get_link_address)
+        .def("get_link_target", &Packer_get_link_target);
+
+    py::enum_<TraceLevel>(m, "TraceLevel")
+        .value("OFF", TraceLevel::Off)
+        .value("OUTCOME", TraceLevel::Outcome)
+        .value("SEARCH", TraceLevel::Search);
+
+    py::class_<BacktrackingPacker, Packer>(m, "_BacktrackingPacker")
+        .def(py::init())
+        .def("set_trace_file",
+             [](BacktrackingPacker& packer, const std::string& filename, const TraceLevel level) {
+                 packer.setTraceFile(filename, level);
+             })
+        .def("set_profiling", &BacktrackingPacker::setProfiling)
+        .def_property_readonly("statistics", &BacktrackingPacker_statistics);
+
+    py::class_<PortfolioPacker, Packer>(m, "_PortfolioPacker")
+        .def(py::init())
+        .def("set_thread_count", &PortfolioPacker::setThreadCount)
+        .def_property_readonly("winner", &PortfolioPacker::winner);
+
+    py::class_<ExactPacker, Packer>(m, "_ExactPacker")
+        .def(py::init())
+        .def_property_readonly("proved_infeasible", &ExactPacker::provedInfeasible)
+        .def_property_readonly("node_count", &ExactPacker::nodeCount);
 }
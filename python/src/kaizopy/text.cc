@@ -1,6 +1,7 @@
 #include "pyutilities.h"
 #include <kaizo/text/AsciiEncoding.h>
 #include <kaizo/text/TableEncoding.h>
+#include <kaizo/text/TableUsage.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -256,6 +257,7 @@ public:
     auto decode(const kaizo::BinaryView& binary, size_t offset)
         -> std::optional<std::pair<size_t, std::string>>
     {
+        py::gil_scoped_acquire acquire;
         auto const view = py::memoryview::from_memory(binary.data(), binary.size());
         py::object result = m_decoder(view, offset);
         if (!result)
@@ -271,6 +273,7 @@ public:
 
     auto encode(const std::string& name, const std::string& arguments) -> std::optional<Binary>
     {
+        py::gil_scoped_acquire acquire;
         py::object result = m_encoder(name, arguments);
         if (!result)
         {
@@ -298,6 +301,35 @@ static void TableEncoding_add_hook(TableEncoding& encoding, const std::string& n
     encoding.addHook(name, handler);
 }
 
+static auto TableUsage_histogram(const TableUsage& usage) -> py::list
+{
+    auto const histogram = usage.histogram();
+    py::list list(histogram.size());
+    for (size_t i = 0; i < histogram.size(); ++i)
+    {
+        auto const& binary = histogram[i].first.binary();
+        list[i] = py::make_tuple(py::bytes(binary.data(), binary.size()), histogram[i].second);
+    }
+    return list;
+}
+
+static auto TableUsage_remapping(const TableUsage& usage) -> py::dict
+{
+    py::dict dict;
+    for (auto const& [from, to] : usage.remapping())
+    {
+        dict[py::bytes(from.data(), from.size())] = py::bytes(to.data(), to.size());
+    }
+    return dict;
+}
+
+static auto TableUsage_remap(const TableUsage& usage, py::buffer buffer) -> py::bytes
+{
+    auto const view = requestReadOnly(buffer);
+    auto const remapped = usage.remap(view, 0, view.size());
+    return py::bytes(reinterpret_cast<const char*>(remapped.data()), remapped.size());
+}
+
 void registerKaizoText(py::module_& m)
 {
     py::class_<Table>(m, "_Table")
@@ -325,4 +357,14 @@ void registerKaizoText(py::module_& m)
         .def(py::init(&TableEncoding_init))
         .def("chunks", &TableEncoding_chunks)
         .def("add_hook", &TableEncoding_add_hook);
+
+    py::class_<TableUsage>(m, "_TableUsage")
+        .def(py::init<const Table&>())
+        .def("set_thread_count", &TableUsage::setThreadCount)
+        .def("analyze", &TableUsage::analyze, py::call_guard<py::gil_scoped_release>())
+        .def("histogram", &TableUsage_histogram)
+        .def("remapping", &TableUsage_remapping)
+        .def("remap", &TableUsage_remap)
+        .def("make_subset_table", &TableUsage::makeSubsetTable)
+        .def("used_texts", &TableUsage::usedTexts);
 }
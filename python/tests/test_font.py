@@ -0,0 +1,36 @@
+import pytest
+from kaizo.graphics.font import BitmapFont, BitmapFontWriter, BitmapGlyph, VerticalAnchor
+from kaizo.graphics.palette import IndexedColorFormat
+from kaizo.graphics.tile import Tile
+
+def _make_writer():
+    format = IndexedColorFormat(8)
+    glyph_tile = Tile(2, 3, format)
+    glyph_tile.fill(1)
+    font = BitmapFont(lineheight=8, baseline=6, bpp=8)
+    font.append_glyph(BitmapGlyph('a', glyph_tile, baseline=3))
+    writer = BitmapFontWriter()
+    writer.set_font(font)
+    return writer
+
+def _rows_written(writer, y):
+    canvas = Tile(4, 32, IndexedColorFormat(8))
+    writer.write('a', canvas, 0, y)
+    return [row for row in range(canvas.height) if canvas.get_pixel(0, row) == 1]
+
+class TestBitmapFontWriter:
+    def test_baseline_anchor(self):
+        writer = _make_writer()
+        writer.set_anchor(VerticalAnchor.BASELINE)
+        assert _rows_written(writer, 20) == [17, 18, 19]
+
+    def test_top_anchor(self):
+        writer = _make_writer()
+        writer.set_anchor(VerticalAnchor.TOP)
+        assert _rows_written(writer, 10) == [13, 14, 15]
+
+    def test_bottom_anchor(self):
+        # the baseline ends up one line height above y
+        writer = _make_writer()
+        writer.set_anchor(VerticalAnchor.BOTTOM)
+        assert _rows_written(writer, 20) == [9, 10, 11]
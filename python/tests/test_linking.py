@@ -0,0 +1,89 @@
+import pytest
+import random
+from kaizo.addresses import FileOffset
+from kaizo.kaizopy import _FreeSpace
+
+class NaiveFreeSpace:
+    """
+    Keeps the free ranges of each target in a plain list, for comparison.
+    """
+    def __init__(self):
+        self.ranges = []
+        self.allocations = []
+
+    def add_block(self, offset, size, target=0):
+        self.ranges.append((target, offset, offset + size))
+
+    def find(self, target, offset):
+        for free in self.ranges:
+            if free[0] == target and free[1] <= offset < free[2]:
+                return free
+        return None
+
+    def allocate_range(self, target, offset, length):
+        free = self.find(target, offset)
+        if free is None:
+            return
+        self.ranges.remove(free)
+        pieces = [(target, free[1], offset), (target, offset + length, free[2])]
+        pieces = [piece for piece in pieces if piece[1] < piece[2]]
+        self.ranges += pieces
+        self.allocations.append((free, pieces))
+
+    def deallocate_last(self):
+        free, pieces = self.allocations.pop()
+        for piece in pieces:
+            self.ranges.remove(piece)
+        self.ranges.append(free)
+
+    @property
+    def blocks(self):
+        return sorted((target, start, end - start) for target, start, end in self.ranges)
+
+    @property
+    def capacity(self):
+        return sum(end - start for _, start, end in self.ranges)
+
+class TestFreeSpace:
+    def test_random_allocations(self):
+        rng = random.Random(42)
+        space = _FreeSpace()
+        naive = NaiveFreeSpace()
+
+        def add_block(offset, size, target):
+            space.add_block(offset, FileOffset.from_int(offset), size, target)
+            naive.add_block(offset, size, target)
+
+        # blocks are only ever added above this offset, so that they never overlap
+        next_offset = 0
+        for _ in range(20):
+            next_offset += rng.randrange(1, 16)
+            size = rng.randrange(1, 64)
+            add_block(next_offset, size, rng.randrange(3))
+            next_offset += size
+
+        for _ in range(2000):
+            action = rng.random()
+            if action < 0.5 and naive.ranges:
+                target, start, end = rng.choice(naive.ranges)
+                offset = rng.randrange(start, end)
+                length = rng.randrange(1, end - offset + 1)
+                space.allocate_range(target, FileOffset.from_int(offset), length)
+                naive.allocate_range(target, offset, length)
+            elif action < 0.9 and naive.allocations:
+                space.deallocate_last()
+                naive.deallocate_last()
+            else:
+                next_offset += rng.randrange(1, 16)
+                size = rng.randrange(1, 64)
+                add_block(next_offset, size, rng.randrange(3))
+                next_offset += size
+
+            assert sorted(space.blocks) == naive.blocks
+            assert space.capacity == naive.capacity
+            assert space.allocation_count == len(naive.allocations)
+
+        while naive.allocations:
+            space.deallocate_last()
+            naive.deallocate_last()
+        assert sorted(space.blocks) == naive.blocks
@@ -19,3 +19,25 @@ class TestTableEncoding:
         table = txt.Table(entries=entries)
         encoding = txt.TableEncoding(table)
         assert bytes(encoding.encode('abc{end}')) == bytes([1, 2, 3, 0])
+
+class TestTableUsage:
+    def test_subset(self):
+        entries = [(b'\x00', txt.TableEndEntry('end'))]
+        entries += [(bytes([n + 1]), txt.TableTextEntry(c)) for n, c in enumerate('abc')]
+        table = txt.Table(entries=entries)
+        usage = txt.TableUsage(table)
+        usage.analyze(['ccc{end}', 'b{end}'])
+        assert usage.remapping() == {b'\x03': b'\x01', b'\x02': b'\x02'}
+        assert usage.remap(b'\x03\x02\x00') == b'\x01\x02\x00'
+        assert len(usage.subset_table()) == 3
+
+    def test_remap_unused_text(self):
+        entries = [(b'\x00', txt.TableEndEntry('end'))]
+        entries += [(bytes([n + 1]), txt.TableTextEntry(c)) for n, c in enumerate('abc')]
+        table = txt.Table(entries=entries)
+        usage = txt.TableUsage(table)
+        usage.analyze(['ccc{end}'])
+        # 'a' is unused and its code now belongs to 'c'
+        assert usage.remapping() == {b'\x03': b'\x01'}
+        with pytest.raises(RuntimeError, match='not part of the subset'):
+            usage.remap(b'\x01\x00')